@@ -59,22 +59,12 @@
 #include "Symbols.h"
 #include "Names.h"
 #include "Array.h"
-#include <map> // ### replace me with LiteralTable
+#include "InternTable.h"
+#include <vector>
 #include <string>
 
 CPLUSPLUS_BEGIN_NAMESPACE
 
-template <typename _Iterator>
-static void delete_map_entries(_Iterator first, _Iterator last)
-{
-    for (; first != last; ++first)
-        delete first->second;
-}
-
-template <typename _Map>
-static void delete_map_entries(const _Map &m)
-{ delete_map_entries(m.begin(), m.end()); }
-
 template <typename _Iterator>
 static void delete_array_entries(_Iterator first, _Iterator last)
 {
@@ -86,33 +76,245 @@ template <typename _Array>
 static void delete_array_entries(const _Array &a)
 { delete_array_entries(a.begin(), a.end()); }
 
+namespace {
+
+// Keys of the intern tables of Control::Data. They compare directly against
+// the interned values, so nothing but the value is stored in the tables.
+
+template <typename _Name>
+struct IdentifierNameKey {
+    Identifier *id;
+
+    IdentifierNameKey(Identifier *id)
+        : id(id)
+    { }
+
+    unsigned hashCode() const
+    { return hashPointer(id); }
+
+    bool matches(const _Name *name) const
+    { return name->identifier() == id; }
+
+    _Name *create(void *place) const
+    { return new (place) _Name(id); }
+};
+
+struct OperatorNameIdKey {
+    int kind;
+
+    OperatorNameIdKey(int kind)
+        : kind(kind)
+    { }
+
+    unsigned hashCode() const
+    { return unsigned(kind); }
+
+    bool matches(const OperatorNameId *name) const
+    { return name->kind() == kind; }
+
+    OperatorNameId *create(void *place) const
+    { return new (place) OperatorNameId(kind); }
+};
+
+struct ConversionNameIdKey {
+    FullySpecifiedType type;
+
+    ConversionNameIdKey(const FullySpecifiedType &type)
+        : type(type)
+    { }
+
+    unsigned hashCode() const
+    { return type.hashCode(); }
+
+    bool matches(const ConversionNameId *name) const
+    { return name->type() == type; }
+
+    ConversionNameId *create(void *place) const
+    { return new (place) ConversionNameId(type); }
+};
+
+struct TemplateNameIdKey {
+    Identifier *id;
+    const FullySpecifiedType *templateArguments;
+    unsigned templateArgumentCount;
+
+    TemplateNameIdKey(Identifier *id, const FullySpecifiedType *templateArguments,
+                      unsigned templateArgumentCount)
+        : id(id), templateArguments(templateArguments),
+          templateArgumentCount(templateArgumentCount)
+    { }
+
+    unsigned hashCode() const
+    {
+        unsigned h = hashPointer(id);
+        for (unsigned i = 0; i < templateArgumentCount; ++i)
+            h = h * 31 + templateArguments[i].hashCode();
+        return h;
+    }
+
+    bool matches(const TemplateNameId *name) const
+    {
+        if (name->identifier() != id || name->templateArgumentCount() != templateArgumentCount)
+            return false;
+        for (unsigned i = 0; i < templateArgumentCount; ++i) {
+            if (name->templateArgumentAt(i) != templateArguments[i])
+                return false;
+        }
+        return true;
+    }
+
+    TemplateNameId *create(void *place) const
+    { return new (place) TemplateNameId(id, templateArguments, templateArgumentCount); }
+};
+
+struct QualifiedNameIdKey {
+    Name *const *names;
+    unsigned nameCount;
+    bool isGlobal;
+
+    QualifiedNameIdKey(Name *const *names, unsigned nameCount, bool isGlobal) :
+        names(names), nameCount(nameCount), isGlobal(isGlobal)
+    { }
+
+    unsigned hashCode() const
+    {
+        unsigned h = isGlobal;
+        for (unsigned i = 0; i < nameCount; ++i)
+            h = h * 31 + hashPointer(names[i]);
+        return h;
+    }
+
+    bool matches(const QualifiedNameId *name) const
+    {
+        if (name->isGlobal() != isGlobal || name->nameCount() != nameCount)
+            return false;
+        for (unsigned i = 0; i < nameCount; ++i) {
+            if (name->nameAt(i) != names[i])
+                return false;
+        }
+        return true;
+    }
+
+    QualifiedNameId *create(void *place) const
+    { return new (place) QualifiedNameId(names, nameCount, isGlobal); }
+};
+
+template <typename _Type>
+struct KindTypeKey {
+    int kind;
+
+    KindTypeKey(int kind)
+        : kind(kind)
+    { }
+
+    unsigned hashCode() const
+    { return unsigned(kind); }
+
+    bool matches(const _Type *ty) const
+    { return ty->kind() == kind; }
+
+    _Type *create(void *place) const
+    { return new (place) _Type(kind); }
+};
+
+template <typename _Type>
+struct ElementTypeKey {
+    FullySpecifiedType elementType;
+
+    ElementTypeKey(const FullySpecifiedType &elementType)
+        : elementType(elementType)
+    { }
+
+    unsigned hashCode() const
+    { return elementType.hashCode(); }
+
+    bool matches(const _Type *ty) const
+    { return ty->elementType() == elementType; }
+
+    _Type *create(void *place) const
+    { return new (place) _Type(elementType); }
+};
+
+struct PointerToMemberTypeKey {
+    Name *memberName;
+    FullySpecifiedType type;
+
+    PointerToMemberTypeKey(Name *memberName, const FullySpecifiedType &type)
+        : memberName(memberName), type(type)
+    { }
+
+    unsigned hashCode() const
+    { return hashPointer(memberName) * 31 + type.hashCode(); }
+
+    bool matches(const PointerToMemberType *ty) const
+    { return ty->memberName() == memberName && ty->elementType() == type; }
+
+    PointerToMemberType *create(void *place) const
+    { return new (place) PointerToMemberType(memberName, type); }
+};
+
+struct ArrayTypeKey {
+    FullySpecifiedType type;
+    size_t size;
+
+    ArrayTypeKey(const FullySpecifiedType &type, size_t size) :
+        type(type), size(size)
+    { }
+
+    unsigned hashCode() const
+    { return type.hashCode() * 31 + unsigned(size); }
+
+    bool matches(const ArrayType *ty) const
+    { return ty->elementType() == type && ty->size() == size; }
+
+    ArrayType *create(void *place) const
+    { return new (place) ArrayType(type, size); }
+};
+
+struct NamedTypeKey {
+    Name *name;
+
+    NamedTypeKey(Name *name)
+        : name(name)
+    { }
+
+    unsigned hashCode() const
+    { return hashPointer(name); }
+
+    bool matches(const NamedType *ty) const
+    { return ty->name() == name; }
+
+    NamedType *create(void *place) const
+    { return new (place) NamedType(name); }
+};
+
+} // end of anonymous namespace
+
 class Control::Data
 {
 public:
     Data(Control *control)
         : control(control),
           translationUnit(0),
-          diagnosticClient(0)
+          diagnosticClient(0),
+          nameIds(&pool),
+          destructorNameIds(&pool),
+          operatorNameIds(&pool),
+          conversionNameIds(&pool),
+          templateNameIds(&pool),
+          qualifiedNameIds(&pool),
+          integerTypes(&pool),
+          floatTypes(&pool),
+          pointerToMemberTypes(&pool),
+          pointerTypes(&pool),
+          referenceTypes(&pool),
+          arrayTypes(&pool),
+          namedTypes(&pool)
     { }
 
     ~Data()
     {
-        // names
-        delete_map_entries(nameIds);
-        delete_map_entries(destructorNameIds);
-        delete_map_entries(operatorNameIds);
-        delete_map_entries(conversionNameIds);
-        delete_map_entries(qualifiedNameIds);
-        delete_map_entries(templateNameIds);
-
-        // types
-        delete_map_entries(integerTypes);
-        delete_map_entries(floatTypes);
-        delete_map_entries(pointerToMemberTypes);
-        delete_map_entries(pointerTypes);
-        delete_map_entries(referenceTypes);
-        delete_map_entries(arrayTypes);
-        delete_map_entries(namedTypes);
+        // names and types are destroyed by their intern tables.
 
         // symbols
         delete_array_entries(declarations);
@@ -131,134 +333,55 @@ public:
     {
         if (! id)
             return 0;
-        std::map<Identifier *, NameId *>::iterator it = nameIds.lower_bound(id);
-        if (it == nameIds.end() || it->first != id)
-            it = nameIds.insert(it, std::make_pair(id, new NameId(id)));
-        return it->second;
+        return nameIds.findOrInsert(IdentifierNameKey<NameId>(id));
     }
 
     TemplateNameId *findOrInsertTemplateNameId(Identifier *id,
-        const std::vector<FullySpecifiedType> &templateArguments)
+        const FullySpecifiedType *templateArguments, unsigned templateArgumentCount)
     {
         if (! id)
             return 0;
-        const TemplateNameIdKey key(id, templateArguments);
-        std::map<TemplateNameIdKey, TemplateNameId *>::iterator it =
-                templateNameIds.lower_bound(key);
-        if (it == templateNameIds.end() || it->first != key) {
-            const FullySpecifiedType *args = 0;
-            if (templateArguments.size())
-                args = &templateArguments[0];
-            TemplateNameId *templ = new TemplateNameId(id, args,
-                                                       templateArguments.size());
-            it = templateNameIds.insert(it, std::make_pair(key, templ));
-        }
-        return it->second;
+        return templateNameIds.findOrInsert(TemplateNameIdKey(id, templateArguments,
+                                                              templateArgumentCount));
     }
 
     DestructorNameId *findOrInsertDestructorNameId(Identifier *id)
     {
         if (! id)
             return 0;
-        std::map<Identifier *, DestructorNameId *>::iterator it = destructorNameIds.lower_bound(id);
-        if (it == destructorNameIds.end() || it->first != id)
-            it = destructorNameIds.insert(it, std::make_pair(id, new DestructorNameId(id)));
-        return it->second;
+        return destructorNameIds.findOrInsert(IdentifierNameKey<DestructorNameId>(id));
     }
 
     OperatorNameId *findOrInsertOperatorNameId(int kind)
-    {
-        const int key(kind);
-        std::map<int, OperatorNameId *>::iterator it = operatorNameIds.lower_bound(key);
-        if (it == operatorNameIds.end() || it->first != key)
-            it = operatorNameIds.insert(it, std::make_pair(key, new OperatorNameId(kind)));
-        return it->second;
-    }
+    { return operatorNameIds.findOrInsert(OperatorNameIdKey(kind)); }
 
     ConversionNameId *findOrInsertConversionNameId(FullySpecifiedType type)
-    {
-        std::map<FullySpecifiedType, ConversionNameId *>::iterator it =
-                conversionNameIds.lower_bound(type);
-        if (it == conversionNameIds.end() || it->first != type)
-            it = conversionNameIds.insert(it, std::make_pair(type, new ConversionNameId(type)));
-        return it->second;
-    }
+    { return conversionNameIds.findOrInsert(ConversionNameIdKey(type)); }
 
-    QualifiedNameId *findOrInsertQualifiedNameId(const std::vector<Name *> &names, bool isGlobal)
-    {
-        const QualifiedNameIdKey key(names, isGlobal);
-        std::map<QualifiedNameIdKey, QualifiedNameId *>::iterator it =
-                qualifiedNameIds.lower_bound(key);
-        if (it == qualifiedNameIds.end() || it->first != key) {
-            QualifiedNameId *name = new QualifiedNameId(&names[0], names.size(), isGlobal);
-            it = qualifiedNameIds.insert(it, std::make_pair(key, name));
-        }
-        return it->second;
-    }
+    QualifiedNameId *findOrInsertQualifiedNameId(Name *const *names, unsigned nameCount,
+                                                 bool isGlobal)
+    { return qualifiedNameIds.findOrInsert(QualifiedNameIdKey(names, nameCount, isGlobal)); }
 
     IntegerType *findOrInsertIntegerType(int kind)
-    {
-        const int key = int(kind);
-        std::map<int, IntegerType *>::iterator it = integerTypes.lower_bound(key);
-        if (it == integerTypes.end() || it->first != key)
-            it = integerTypes.insert(it, std::make_pair(key, new IntegerType(kind)));
-        return it->second;
-    }
+    { return integerTypes.findOrInsert(KindTypeKey<IntegerType>(kind)); }
 
     FloatType *findOrInsertFloatType(int kind)
-    {
-        const int key = int(kind);
-        std::map<int, FloatType *>::iterator it = floatTypes.lower_bound(key);
-        if (it == floatTypes.end() || it->first != key)
-            it = floatTypes.insert(it, std::make_pair(key, new FloatType(kind)));
-        return it->second;
-    }
+    { return floatTypes.findOrInsert(KindTypeKey<FloatType>(kind)); }
 
     PointerToMemberType *findOrInsertPointerToMemberType(Name *memberName, FullySpecifiedType elementType)
-    {
-        const PointerToMemberTypeKey key(memberName, elementType);
-        std::map<PointerToMemberTypeKey, PointerToMemberType *>::iterator it =
-                pointerToMemberTypes.lower_bound(key);
-        if (it == pointerToMemberTypes.end() || it->first != key)
-            it = pointerToMemberTypes.insert(it, std::make_pair(key, new PointerToMemberType(memberName, elementType)));
-        return it->second;
-    }
+    { return pointerToMemberTypes.findOrInsert(PointerToMemberTypeKey(memberName, elementType)); }
 
     PointerType *findOrInsertPointerType(FullySpecifiedType elementType)
-    {
-        std::map<FullySpecifiedType, PointerType *>::iterator it =
-                pointerTypes.lower_bound(elementType);
-        if (it == pointerTypes.end() || it->first != elementType)
-            it = pointerTypes.insert(it, std::make_pair(elementType, new PointerType(elementType)));
-        return it->second;
-    }
+    { return pointerTypes.findOrInsert(ElementTypeKey<PointerType>(elementType)); }
 
     ReferenceType *findOrInsertReferenceType(FullySpecifiedType elementType)
-    {
-        std::map<FullySpecifiedType, ReferenceType *>::iterator it =
-                referenceTypes.lower_bound(elementType);
-        if (it == referenceTypes.end() || it->first != elementType)
-            it = referenceTypes.insert(it, std::make_pair(elementType, new ReferenceType(elementType)));
-        return it->second;
-    }
+    { return referenceTypes.findOrInsert(ElementTypeKey<ReferenceType>(elementType)); }
 
     ArrayType *findOrInsertArrayType(FullySpecifiedType elementType, size_t size)
-    {
-        const ArrayKey key(elementType, size);
-        std::map<ArrayKey, ArrayType *>::iterator it =
-                arrayTypes.lower_bound(key);
-        if (it == arrayTypes.end() || it->first != key)
-            it = arrayTypes.insert(it, std::make_pair(key, new ArrayType(elementType, size)));
-        return it->second;
-    }
+    { return arrayTypes.findOrInsert(ArrayTypeKey(elementType, size)); }
 
     NamedType *findOrInsertNamedType(Name *name)
-    {
-        std::map<Name *, NamedType *>::iterator it = namedTypes.lower_bound(name);
-        if (it == namedTypes.end() || it->first != name)
-            it = namedTypes.insert(it, std::make_pair(name, new NamedType(name)));
-        return it->second;
-    }
+    { return namedTypes.findOrInsert(NamedTypeKey(name)); }
 
     Declaration *newDeclaration(unsigned sourceLocation, Name *name)
     {
@@ -339,106 +462,6 @@ public:
         return u;
     }
 
-    struct TemplateNameIdKey {
-        Identifier *id;
-        std::vector<FullySpecifiedType> templateArguments;
-
-        TemplateNameIdKey(Identifier *id, const std::vector<FullySpecifiedType> &templateArguments)
-            : id(id), templateArguments(templateArguments)
-        { }
-
-        bool operator == (const TemplateNameIdKey &other) const
-        { return id == other.id && templateArguments == other.templateArguments; }
-
-        bool operator != (const TemplateNameIdKey &other) const
-        { return ! operator==(other); }
-
-        bool operator < (const TemplateNameIdKey &other) const
-        {
-            if (id == other.id)
-                return std::lexicographical_compare(templateArguments.begin(),
-                                                    templateArguments.end(),
-                                                    other.templateArguments.begin(),
-                                                    other.templateArguments.end());
-            return id < other.id;
-        }
-    };
-
-    struct QualifiedNameIdKey {
-        std::vector<Name *> names;
-        bool isGlobal;
-
-        QualifiedNameIdKey(const std::vector<Name *> &names, bool isGlobal) :
-            names(names), isGlobal(isGlobal)
-        { }
-
-        bool operator == (const QualifiedNameIdKey &other) const
-        { return isGlobal == other.isGlobal && names == other.names; }
-
-        bool operator != (const QualifiedNameIdKey &other) const
-        { return ! operator==(other); }
-
-        bool operator < (const QualifiedNameIdKey &other) const
-        {
-            if (isGlobal == other.isGlobal)
-                return std::lexicographical_compare(names.begin(), names.end(),
-                                                    other.names.begin(), other.names.end());
-            return isGlobal < other.isGlobal;
-        }
-    };
-
-    struct ArrayKey {
-        FullySpecifiedType type;
-        size_t size;
-
-        ArrayKey() :
-            size(0)
-        { }
-
-        ArrayKey(FullySpecifiedType type, size_t size) :
-            type(type), size(size)
-        { }
-
-        bool operator == (const ArrayKey &other) const
-        { return type == other.type && size == other.size; }
-
-        bool operator != (const ArrayKey &other) const
-        { return ! operator==(other); }
-
-        bool operator < (const ArrayKey &other) const
-        {
-            if (type == other.type)
-                return size < other.size;
-            return type < other.type;
-        }
-    };
-
-    struct PointerToMemberTypeKey {
-        Name *memberName;
-        FullySpecifiedType type;
-
-        PointerToMemberTypeKey()
-            : memberName(0)
-        { }
-
-        PointerToMemberTypeKey(Name *memberName, FullySpecifiedType type)
-            : memberName(memberName), type(type)
-        { }
-
-        bool operator == (const PointerToMemberTypeKey &other) const
-        { return memberName == other.memberName && type == other.type; }
-
-        bool operator != (const PointerToMemberTypeKey &other) const
-        { return ! operator==(other); }
-
-        bool operator < (const PointerToMemberTypeKey &other) const
-        {
-            if (memberName == other.memberName)
-                return type < other.type;
-            return memberName < other.memberName;
-        }
-    };
-
     Control *control;
     TranslationUnit *translationUnit;
     DiagnosticClient *diagnosticClient;
@@ -447,25 +470,27 @@ public:
     LiteralTable<NumericLiteral> numericLiterals;
     LiteralTable<StringLiteral> fileNames;
 
-    // ### replace std::map with lookup tables. ASAP!
+    // the interned names and types are allocated here; declared before
+    // the intern tables, the pool outlives them.
+    MemoryPool pool;
 
     // names
-    std::map<Identifier *, NameId *> nameIds;
-    std::map<Identifier *, DestructorNameId *> destructorNameIds;
-    std::map<int, OperatorNameId *> operatorNameIds;
-    std::map<FullySpecifiedType, ConversionNameId *> conversionNameIds;
-    std::map<TemplateNameIdKey, TemplateNameId *> templateNameIds;
-    std::map<QualifiedNameIdKey, QualifiedNameId *> qualifiedNameIds;
+    InternTable<NameId> nameIds;
+    InternTable<DestructorNameId> destructorNameIds;
+    InternTable<OperatorNameId> operatorNameIds;
+    InternTable<ConversionNameId> conversionNameIds;
+    InternTable<TemplateNameId> templateNameIds;
+    InternTable<QualifiedNameId> qualifiedNameIds;
 
     // types
     VoidType voidType;
-    std::map<int, IntegerType *> integerTypes;
-    std::map<int, FloatType *> floatTypes;
-    std::map<PointerToMemberTypeKey, PointerToMemberType *> pointerToMemberTypes;
-    std::map<FullySpecifiedType, PointerType *> pointerTypes;
-    std::map<FullySpecifiedType, ReferenceType *> referenceTypes;
-    std::map<ArrayKey, ArrayType *> arrayTypes;
-    std::map<Name *, NamedType *> namedTypes;
+    InternTable<IntegerType> integerTypes;
+    InternTable<FloatType> floatTypes;
+    InternTable<PointerToMemberType> pointerToMemberTypes;
+    InternTable<PointerType> pointerTypes;
+    InternTable<ReferenceType> referenceTypes;
+    InternTable<ArrayType> arrayTypes;
+    InternTable<NamedType> namedTypes;
 
     // symbols
     std::vector<Declaration *> declarations;
@@ -557,8 +582,7 @@ TemplateNameId *Control::templateNameId(Identifier *id,
        FullySpecifiedType *const args,
        unsigned argv)
 {
-    std::vector<FullySpecifiedType> templateArguments(args, args + argv);
-    return d->findOrInsertTemplateNameId(id, templateArguments);
+    return d->findOrInsertTemplateNameId(id, args, argv);
 }
 
 DestructorNameId *Control::destructorNameId(Identifier *id)
@@ -574,8 +598,7 @@ QualifiedNameId *Control::qualifiedNameId(Name *const *names,
                                              unsigned nameCount,
                                              bool isGlobal)
 {
-    std::vector<Name *> classOrNamespaceNames(names, names + nameCount);
-    return d->findOrInsertQualifiedNameId(classOrNamespaceNames, isGlobal);
+    return d->findOrInsertQualifiedNameId(names, nameCount, isGlobal);
 }
 
 VoidType *Control::voidType()
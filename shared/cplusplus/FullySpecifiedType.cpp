@@ -52,6 +52,8 @@
 
 #include "FullySpecifiedType.h"
 #include "Type.h"
+#include "InternTable.h"
+#include <cstddef>
 
 CPLUSPLUS_BEGIN_NAMESPACE
 
@@ -173,6 +175,11 @@ bool FullySpecifiedType::isEqualTo(const FullySpecifiedType &other) const
         return _type->isEqualTo(other._type);
 }
 
+unsigned FullySpecifiedType::hashCode() const
+{
+    return hashPointer(_type) ^ _flags;
+}
+
 Type &FullySpecifiedType::operator*()
 { return *_type; }
 
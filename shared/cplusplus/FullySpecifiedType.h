@@ -113,6 +113,8 @@ public:
 
     bool isEqualTo(const FullySpecifiedType &other) const;
 
+    unsigned hashCode() const;
+
     Type &operator*();
     const Type &operator*() const;
 
@@ -0,0 +1,178 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+// Copyright (c) 2008 Roberto Raggi <roberto.raggi@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef CPLUSPLUS_INTERNTABLE_H
+#define CPLUSPLUS_INTERNTABLE_H
+
+#include "CPlusPlusForwardDeclarations.h"
+#include "MemoryPool.h"
+#include <cstdlib>
+
+CPLUSPLUS_BEGIN_HEADER
+CPLUSPLUS_BEGIN_NAMESPACE
+
+// Hashes a pointer for the intern tables: the low bits are always zero
+// and the values are close to each other, so they are mixed first.
+inline unsigned hashPointer(const void *ptr)
+{
+    const unsigned h = unsigned(reinterpret_cast<size_t>(ptr) >> 3) * 2654435761U;
+    return h ^ (h >> 15);
+}
+
+// Hash table used by Control to intern names and types. The values are
+// allocated from the given pool, which must outlive the table; the table
+// runs their destructors. It is open addressed with linear probing: a slot
+// is just the hash code and the value, so a lookup touches one cache line
+// in the common case. The slots are malloc'ed like the buckets of
+// LiteralTable. Lookups take a key that provides hashCode(),
+// matches(const _Value *) and create(void *), which constructs the value
+// in the given memory.
+template <typename _Value>
+class InternTable
+{
+    InternTable(const InternTable &other);
+    void operator =(const InternTable &other);
+
+    struct Slot {
+        unsigned hashCode;
+        _Value *value;
+    };
+
+public:
+    InternTable(MemoryPool *pool)
+       : _pool(pool),
+         _slots(0),
+         _allocatedSlots(0),
+         _count(0)
+    { }
+
+    ~InternTable()
+    {
+       for (unsigned i = 0; i < _allocatedSlots; ++i) {
+           if (_slots[i].value)
+               _slots[i].value->~_Value();
+       }
+       if (_slots)
+           free(_slots);
+    }
+
+    unsigned size() const
+    { return _count; }
+
+    template <typename _Key>
+    _Value *findOrInsert(const _Key &key)
+    {
+       const unsigned h = key.hashCode();
+
+       if (_slots) {
+           for (Slot *slot = probe(h); slot->value; slot = next(slot)) {
+              if (slot->hashCode == h && key.matches(slot->value))
+                  return slot->value;
+           }
+       }
+
+       // keep at least half of the slots free, the probe sequences stay short
+       if (++_count * 2 > _allocatedSlots)
+           rehash();
+
+       Slot *slot = probe(h);
+       while (slot->value)
+           slot = next(slot);
+       slot->hashCode = h;
+       slot->value = key.create(_pool->allocate(sizeof(_Value)));
+       return slot->value;
+    }
+
+protected:
+    Slot *probe(unsigned hashCode) const
+    { return _slots + (hashCode & (_allocatedSlots - 1)); }
+
+    Slot *next(Slot *slot) const
+    { return ++slot == _slots + _allocatedSlots ? _slots : slot; }
+
+    void rehash()
+    {
+       Slot *oldSlots = _slots;
+       const unsigned oldAllocatedSlots = _allocatedSlots;
+
+       _allocatedSlots <<= 1;
+
+       if (! _allocatedSlots)
+           _allocatedSlots = 64;
+
+       _slots = (Slot *) calloc(_allocatedSlots, sizeof(Slot));
+
+       for (unsigned i = 0; i < oldAllocatedSlots; ++i) {
+           if (! oldSlots[i].value)
+               continue;
+           Slot *slot = probe(oldSlots[i].hashCode);
+           while (slot->value)
+               slot = next(slot);
+           *slot = oldSlots[i];
+       }
+
+       if (oldSlots)
+           free(oldSlots);
+    }
+
+protected:
+    MemoryPool *_pool;
+    Slot *_slots;
+    unsigned _allocatedSlots;
+    unsigned _count;
+};
+
+CPLUSPLUS_END_NAMESPACE
+CPLUSPLUS_END_HEADER
+
+#endif // CPLUSPLUS_INTERNTABLE_H
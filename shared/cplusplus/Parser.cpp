@@ -2380,7 +2380,11 @@ bool Parser::parseSimpleDeclaration(DeclarationAST *&node,
 
 bool Parser::parseFunctionBody(StatementAST *&node)
 {
-    if (_translationUnit->skipFunctionBody()) {
+    bool skip = _translationUnit->skipFunctionBody();
+    if (skip && LA() == T_LBRACE)
+        skip = ! _translationUnit->isActiveRange(cursor(), tok().close_brace);
+
+    if (skip) {
         unsigned token_lbrace = 0;
         match(T_LBRACE, &token_lbrace);
         if (! token_lbrace)
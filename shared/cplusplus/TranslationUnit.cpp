@@ -72,6 +72,8 @@ TranslationUnit::TranslationUnit(Control *control, StringLiteral *fileId)
       _lastSourceChar(0),
       _pool(0),
       _ast(0),
+      _firstActiveLine(0),
+      _lastActiveLine(0),
       _flags(0)
 {
     _tokens = new Array<Token, 8>();
@@ -218,6 +220,27 @@ bool TranslationUnit::skipFunctionBody() const
 void TranslationUnit::setSkipFunctionBody(bool skipFunctionBody)
 { _skipFunctionBody = skipFunctionBody; }
 
+void TranslationUnit::setActiveLines(unsigned firstLine, unsigned lastLine)
+{
+    _firstActiveLine = firstLine;
+    _lastActiveLine = lastLine;
+}
+
+bool TranslationUnit::isActiveRange(unsigned firstToken, unsigned lastToken) const
+{
+    if (! _lastActiveLine || ! lastToken)
+        return false;
+
+    StringLiteral *fileName = 0;
+    unsigned firstLine = 0, lastLine = 0;
+    getTokenPosition(firstToken, &firstLine, 0, &fileName);
+    if (fileName != _fileId)
+        return false;
+
+    getTokenPosition(lastToken, &lastLine);
+    return firstLine <= _lastActiveLine && lastLine >= _firstActiveLine;
+}
+
 bool TranslationUnit::parse(ParseMode mode)
 {
     if (isParsed())
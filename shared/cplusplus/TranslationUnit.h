@@ -112,6 +112,11 @@ public:
     bool skipFunctionBody() const;
     void setSkipFunctionBody(bool skipFunctionBody);
 
+    // The function bodies overlapping the active lines are parsed
+    // even if skipFunctionBody() is set.
+    void setActiveLines(unsigned firstLine, unsigned lastLine);
+    bool isActiveRange(unsigned firstToken, unsigned lastToken) const;
+
     bool isParsed() const;
 
     enum ParseMode {
@@ -179,6 +184,8 @@ private:
     MemoryPool *_pool;
     AST *_ast;
     TranslationUnit *_previousTranslationUnit;
+    unsigned _firstActiveLine;
+    unsigned _lastActiveLine;
     union {
         unsigned _flags;
         struct {
@@ -18,6 +18,7 @@ HEADERS += \
     $$PWD/CoreTypes.h \
     $$PWD/DiagnosticClient.h \
     $$PWD/FullySpecifiedType.h \
+    $$PWD/InternTable.h \
     $$PWD/Lexer.h \
     $$PWD/LiteralTable.h \
     $$PWD/Literals.h \
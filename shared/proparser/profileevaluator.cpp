@@ -189,6 +189,7 @@ public:
 
     QString currentFileName() const;
     QString currentDirectory() const;
+    QString absoluteFilePath(const QString &fileName) const;
     ProFile *currentProFile() const;
 
     bool evaluateConditionalFunction(const QString &function, const QString &arguments, bool *result);
@@ -207,7 +208,7 @@ public:
     QString m_lastVarName;
     ProVariable::VariableOperator m_variableOperator;
     QString m_origfile;
-    QString m_oldPath;                              // To restore the current path to the path
+    bool m_visitedInitialProFile;                   // The first profile gets the mkspec evaluated around it
     QStack<ProFile*> m_profileStack;                // To handle 'include(a.pri), so we can track back to 'a.pro' when finished with 'a.pri'
 
     QHash<QString, QStringList> m_valuemap;         // VariableName must be us-ascii, the content however can be non-us-ascii.
@@ -217,6 +218,7 @@ public:
 
     int m_prevLineNo;                               // Checking whether we're assigning the same TARGET
     ProFile *m_prevProFile;                         // See m_prevLineNo
+    int m_listCount;                                // Names the variables made by list()
 };
 
 ProFileEvaluator::Private::Private(ProFileEvaluator *q_)
@@ -224,6 +226,7 @@ ProFileEvaluator::Private::Private(ProFileEvaluator *q_)
 {
     m_prevLineNo = 0;
     m_prevProFile = 0;
+    m_listCount = 0;
     m_verbose = true;
     m_block = 0;
     m_commentItem = 0;
@@ -235,6 +238,7 @@ ProFileEvaluator::Private::Private(ProFileEvaluator *q_)
     m_condition = ConditionFalse;
     m_invertNext = false;
     m_skipLevel = 0;
+    m_visitedInitialProFile = false;
 }
 
 bool ProFileEvaluator::Private::read(ProFile *pro)
@@ -605,12 +609,14 @@ bool ProFileEvaluator::Private::visitBeginProFile(ProFile * pro)
 
     if (m_origfile.isEmpty())
         m_origfile = pro->fileName();
-    if (m_oldPath.isEmpty()) {
-        // change the working directory for the initial profile we visit, since
+    if (!m_visitedInitialProFile) {
+        // evaluate the mkspec around the initial profile we visit, since
         // that is *the* profile. All the other times we reach this function will be due to
-        // include(file) or load(file)
+        // include(file) or load(file).
+        // The working directory is not changed: profiles are evaluated concurrently,
+        // so relative paths are resolved against currentDirectory() instead.
 
-        m_oldPath = QDir::currentPath();
+        m_visitedInitialProFile = true;
 
         m_profileStack.push(pro);
 
@@ -624,8 +630,6 @@ bool ProFileEvaluator::Private::visitBeginProFile(ProFile * pro)
             evaluateFile(mkspecDirectory + QLatin1String("/features/default_pre.prf"), &ok);
             m_cumulative = cumulative;
         }
-
-        ok = QDir::setCurrent(pro->directoryName());
     }
 
     return ok;
@@ -636,7 +640,7 @@ bool ProFileEvaluator::Private::visitEndProFile(ProFile * pro)
     PRE(pro);
     bool ok = true;
     m_lineNo = pro->lineNumber();
-    if (m_profileStack.count() == 1 && !m_oldPath.isEmpty()) {
+    if (m_profileStack.count() == 1 && m_visitedInitialProFile) {
         const QString &mkspecDirectory = propertyValue(QLatin1String("QMAKE_MKSPECS"));
         if (!mkspecDirectory.isEmpty()) {
             bool cumulative = m_cumulative;
@@ -668,7 +672,6 @@ bool ProFileEvaluator::Private::visitEndProFile(ProFile * pro)
         }
 
         m_profileStack.pop();
-        ok = QDir::setCurrent(m_oldPath);
     }
     return ok;
 }
@@ -968,6 +971,11 @@ QString ProFileEvaluator::Private::currentDirectory() const
     return cur->directoryName();
 }
 
+QString ProFileEvaluator::Private::absoluteFilePath(const QString &fileName) const
+{
+    return QDir::cleanPath(QDir(currentDirectory()).absoluteFilePath(fileName));
+}
+
 QStringList ProFileEvaluator::Private::expandVariableReferences(const QString &str)
 {
     bool fOK;
@@ -1176,6 +1184,48 @@ bool ProFileEvaluator::Private::isActiveConfig(const QString &config, bool regex
     return false;
 }
 
+enum ExpandFunc { E_MEMBER=1, E_FIRST, E_LAST, E_CAT, E_FROMFILE, E_EVAL, E_LIST,
+                  E_SPRINTF, E_JOIN, E_SPLIT, E_BASENAME, E_DIRNAME, E_SECTION,
+                  E_FIND, E_SYSTEM, E_UNIQUE, E_QUOTE, E_ESCAPE_EXPAND,
+                  E_UPPER, E_LOWER, E_FILES, E_PROMPT, E_RE_ESCAPE,
+                  E_REPLACE };
+
+// The tables of the built-in functions are shared by the evaluators, which
+// may run in several threads at once.
+class ExpandFunctions : public QHash<QString, int>
+{
+public:
+    ExpandFunctions()
+    {
+        insert(QLatin1String("member"), E_MEMBER);
+        insert(QLatin1String("first"), E_FIRST);
+        insert(QLatin1String("last"), E_LAST);
+        insert(QLatin1String("cat"), E_CAT);
+        insert(QLatin1String("fromfile"), E_FROMFILE); // implementation disabled (see comment below)
+        insert(QLatin1String("eval"), E_EVAL);
+        insert(QLatin1String("list"), E_LIST);
+        insert(QLatin1String("sprintf"), E_SPRINTF);
+        insert(QLatin1String("join"), E_JOIN);
+        insert(QLatin1String("split"), E_SPLIT);
+        insert(QLatin1String("basename"), E_BASENAME);
+        insert(QLatin1String("dirname"), E_DIRNAME);
+        insert(QLatin1String("section"), E_SECTION);
+        insert(QLatin1String("find"), E_FIND);
+        insert(QLatin1String("system"), E_SYSTEM);
+        insert(QLatin1String("unique"), E_UNIQUE);
+        insert(QLatin1String("quote"), E_QUOTE);
+        insert(QLatin1String("escape_expand"), E_ESCAPE_EXPAND);
+        insert(QLatin1String("upper"), E_UPPER);
+        insert(QLatin1String("lower"), E_LOWER);
+        insert(QLatin1String("re_escape"), E_RE_ESCAPE);
+        insert(QLatin1String("files"), E_FILES);
+        insert(QLatin1String("prompt"), E_PROMPT); // interactive, so cannot be implemented
+        insert(QLatin1String("replace"), E_REPLACE);
+    }
+};
+
+Q_GLOBAL_STATIC(ExpandFunctions, expandFunctions)
+
 QStringList ProFileEvaluator::Private::evaluateExpandFunction(const QString &func, const QString &arguments)
 {
     QStringList argumentsList = split_arg_list(arguments);
@@ -1183,41 +1233,7 @@ QStringList ProFileEvaluator::Private::evaluateExpandFunction(const QString &fun
     for (int i = 0; i < argumentsList.count(); ++i)
         args += expandVariableReferences(argumentsList[i]);
 
-    enum ExpandFunc { E_MEMBER=1, E_FIRST, E_LAST, E_CAT, E_FROMFILE, E_EVAL, E_LIST,
-                      E_SPRINTF, E_JOIN, E_SPLIT, E_BASENAME, E_DIRNAME, E_SECTION,
-                      E_FIND, E_SYSTEM, E_UNIQUE, E_QUOTE, E_ESCAPE_EXPAND,
-                      E_UPPER, E_LOWER, E_FILES, E_PROMPT, E_RE_ESCAPE,
-                      E_REPLACE };
-
-    static QHash<QString, int> *expands = 0;
-    if (!expands) {
-        expands = new QHash<QString, int>;
-        expands->insert(QLatin1String("member"), E_MEMBER);
-        expands->insert(QLatin1String("first"), E_FIRST);
-        expands->insert(QLatin1String("last"), E_LAST);
-        expands->insert(QLatin1String("cat"), E_CAT);
-        expands->insert(QLatin1String("fromfile"), E_FROMFILE); // implementation disabled (see comment below)
-        expands->insert(QLatin1String("eval"), E_EVAL);
-        expands->insert(QLatin1String("list"), E_LIST);
-        expands->insert(QLatin1String("sprintf"), E_SPRINTF);
-        expands->insert(QLatin1String("join"), E_JOIN);
-        expands->insert(QLatin1String("split"), E_SPLIT);
-        expands->insert(QLatin1String("basename"), E_BASENAME);
-        expands->insert(QLatin1String("dirname"), E_DIRNAME);
-        expands->insert(QLatin1String("section"), E_SECTION);
-        expands->insert(QLatin1String("find"), E_FIND);
-        expands->insert(QLatin1String("system"), E_SYSTEM);
-        expands->insert(QLatin1String("unique"), E_UNIQUE);
-        expands->insert(QLatin1String("quote"), E_QUOTE);
-        expands->insert(QLatin1String("escape_expand"), E_ESCAPE_EXPAND);
-        expands->insert(QLatin1String("upper"), E_UPPER);
-        expands->insert(QLatin1String("lower"), E_LOWER);
-        expands->insert(QLatin1String("re_escape"), E_RE_ESCAPE);
-        expands->insert(QLatin1String("files"), E_FILES);
-        expands->insert(QLatin1String("prompt"), E_PROMPT); // interactive, so cannot be implemented
-        expands->insert(QLatin1String("replace"), E_REPLACE);
-    }
-    ExpandFunc func_t = ExpandFunc(expands->value(func.toLower()));
+    ExpandFunc func_t = ExpandFunc(expandFunctions()->value(func.toLower()));
 
     QStringList ret;
 
@@ -1376,7 +1392,7 @@ QStringList ProFileEvaluator::Private::evaluateExpandFunction(const QString &fun
                 if (args.count() > 1)
                     singleLine = (args[1].toLower() == QLatin1String("true"));
 
-                QFile qfile(file);
+                QFile qfile(absoluteFilePath(file));
                 if (qfile.open(QIODevice::ReadOnly)) {
                     QTextStream stream(&qfile);
                     while (!stream.atEnd()) {
@@ -1420,9 +1436,8 @@ QStringList ProFileEvaluator::Private::evaluateExpandFunction(const QString &fun
             }
             break; }
         case E_LIST: {
-            static int x = 0;
             QString tmp;
-            tmp.sprintf(".QMAKE_INTERNAL_TMP_variableName_%d", x++);
+            tmp.sprintf(".QMAKE_INTERNAL_TMP_variableName_%d", m_listCount++);
             ret = QStringList(tmp);
             QStringList lst;
             foreach (const QString &arg, args)
@@ -1549,12 +1564,12 @@ QStringList ProFileEvaluator::Private::evaluateExpandFunction(const QString &fun
                     if (!dir.isEmpty() && !dir.endsWith(Option::dir_sep))
                         dir += QLatin1Char('/');
 
-                    QDir qdir(dir);
+                    QDir qdir(absoluteFilePath(dir));
                     for (int i = 0; i < (int)qdir.count(); ++i) {
                         if (qdir[i] == QLatin1String(".") || qdir[i] == QLatin1String(".."))
                             continue;
                         QString fname = dir + qdir[i];
-                        if (QFileInfo(fname).isDir()) {
+                        if (QFileInfo(qdir, qdir[i]).isDir()) {
                             if (recursive)
                                 dirs.append(fname);
                         }
@@ -1585,6 +1600,49 @@ QStringList ProFileEvaluator::Private::evaluateExpandFunction(const QString &fun
     return ret;
 }
 
+enum TestFunc { T_REQUIRES=1, T_GREATERTHAN, T_LESSTHAN, T_EQUALS,
+                T_EXISTS, T_EXPORT, T_CLEAR, T_UNSET, T_EVAL, T_CONFIG, T_SYSTEM,
+                T_RETURN, T_BREAK, T_NEXT, T_DEFINED, T_CONTAINS, T_INFILE,
+                T_COUNT, T_ISEMPTY, T_INCLUDE, T_LOAD, T_DEBUG, T_MESSAGE, T_IF };
+
+class TestFunctions : public QHash<QString, int>
+{
+public:
+    TestFunctions()
+    {
+        insert(QLatin1String("requires"), T_REQUIRES);
+        insert(QLatin1String("greaterThan"), T_GREATERTHAN);
+        insert(QLatin1String("lessThan"), T_LESSTHAN);
+        insert(QLatin1String("equals"), T_EQUALS);
+        insert(QLatin1String("isEqual"), T_EQUALS);
+        insert(QLatin1String("exists"), T_EXISTS);
+        insert(QLatin1String("export"), T_EXPORT);
+        insert(QLatin1String("clear"), T_CLEAR);
+        insert(QLatin1String("unset"), T_UNSET);
+        insert(QLatin1String("eval"), T_EVAL);
+        insert(QLatin1String("CONFIG"), T_CONFIG);
+        insert(QLatin1String("if"), T_IF);
+        insert(QLatin1String("isActiveConfig"), T_CONFIG);
+        insert(QLatin1String("system"), T_SYSTEM);
+        insert(QLatin1String("return"), T_RETURN);
+        insert(QLatin1String("break"), T_BREAK);
+        insert(QLatin1String("next"), T_NEXT);
+        insert(QLatin1String("defined"), T_DEFINED);
+        insert(QLatin1String("contains"), T_CONTAINS);
+        insert(QLatin1String("infile"), T_INFILE);
+        insert(QLatin1String("count"), T_COUNT);
+        insert(QLatin1String("isEmpty"), T_ISEMPTY);
+        insert(QLatin1String("load"), T_LOAD);         //v
+        insert(QLatin1String("include"), T_INCLUDE);   //v
+        insert(QLatin1String("debug"), T_DEBUG);
+        insert(QLatin1String("message"), T_MESSAGE);   //v
+        insert(QLatin1String("warning"), T_MESSAGE);   //v
+        insert(QLatin1String("error"), T_MESSAGE);     //v
+    }
+};
+
+Q_GLOBAL_STATIC(TestFunctions, testFunctions)
+
 bool ProFileEvaluator::Private::evaluateConditionalFunction(const QString &function,
     const QString &arguments, bool *result)
 {
@@ -1596,48 +1654,10 @@ bool ProFileEvaluator::Private::evaluateConditionalFunction(const QString &funct
     for (int i = 0; i < argumentsList.count(); ++i)
         args += expandVariableReferences(argumentsList[i]).join(sep);
 
-    enum TestFunc { T_REQUIRES=1, T_GREATERTHAN, T_LESSTHAN, T_EQUALS,
-                    T_EXISTS, T_EXPORT, T_CLEAR, T_UNSET, T_EVAL, T_CONFIG, T_SYSTEM,
-                    T_RETURN, T_BREAK, T_NEXT, T_DEFINED, T_CONTAINS, T_INFILE,
-                    T_COUNT, T_ISEMPTY, T_INCLUDE, T_LOAD, T_DEBUG, T_MESSAGE, T_IF };
-
-    static QHash<QString, int> *functions = 0;
-    if (!functions) {
-        functions = new QHash<QString, int>;
-        functions->insert(QLatin1String("requires"), T_REQUIRES);
-        functions->insert(QLatin1String("greaterThan"), T_GREATERTHAN);
-        functions->insert(QLatin1String("lessThan"), T_LESSTHAN);
-        functions->insert(QLatin1String("equals"), T_EQUALS);
-        functions->insert(QLatin1String("isEqual"), T_EQUALS);
-        functions->insert(QLatin1String("exists"), T_EXISTS);
-        functions->insert(QLatin1String("export"), T_EXPORT);
-        functions->insert(QLatin1String("clear"), T_CLEAR);
-        functions->insert(QLatin1String("unset"), T_UNSET);
-        functions->insert(QLatin1String("eval"), T_EVAL);
-        functions->insert(QLatin1String("CONFIG"), T_CONFIG);
-        functions->insert(QLatin1String("if"), T_IF);
-        functions->insert(QLatin1String("isActiveConfig"), T_CONFIG);
-        functions->insert(QLatin1String("system"), T_SYSTEM);
-        functions->insert(QLatin1String("return"), T_RETURN);
-        functions->insert(QLatin1String("break"), T_BREAK);
-        functions->insert(QLatin1String("next"), T_NEXT);
-        functions->insert(QLatin1String("defined"), T_DEFINED);
-        functions->insert(QLatin1String("contains"), T_CONTAINS);
-        functions->insert(QLatin1String("infile"), T_INFILE);
-        functions->insert(QLatin1String("count"), T_COUNT);
-        functions->insert(QLatin1String("isEmpty"), T_ISEMPTY);
-        functions->insert(QLatin1String("load"), T_LOAD);         //v
-        functions->insert(QLatin1String("include"), T_INCLUDE);   //v
-        functions->insert(QLatin1String("debug"), T_DEBUG);
-        functions->insert(QLatin1String("message"), T_MESSAGE);   //v
-        functions->insert(QLatin1String("warning"), T_MESSAGE);   //v
-        functions->insert(QLatin1String("error"), T_MESSAGE);     //v
-    }
-
     bool cond = false;
     bool ok = true;
 
-    TestFunc func_t = (TestFunc)functions->value(function);
+    TestFunc func_t = (TestFunc)testFunctions()->value(function);
 
     switch (func_t) {
 #if 0
@@ -1832,7 +1852,7 @@ bool ProFileEvaluator::Private::evaluateConditionalFunction(const QString &funct
             QString file = args.first();
             file = Option::fixPathToLocalOS(file);
 
-            if (QFile::exists(file)) {
+            if (QFile::exists(absoluteFilePath(file))) {
                 cond = true;
                 break;
             }
@@ -1840,7 +1860,7 @@ bool ProFileEvaluator::Private::evaluateConditionalFunction(const QString &funct
             QString dirstr = currentDirectory();
             int slsh = file.lastIndexOf(Option::dir_sep);
             if (slsh != -1) {
-                dirstr = file.left(slsh+1);
+                dirstr = absoluteFilePath(file.left(slsh+1));
                 file = file.right(file.length() - slsh - 1);
             }
             cond = QDir(dirstr).entryList(QStringList(file)).count();
@@ -2073,7 +2093,7 @@ void ProFileEvaluator::Private::expandPatternHelper(const QString &relName, cons
     // Search in all vpaths
     if (!found) {
         foreach (const QString &vpath, vpaths) {
-            fi.setFile(vpath + QDir::separator() + relName);
+            fi.setFile(absoluteFilePath(vpath + QDir::separator() + relName));
             if (fi.exists()) {
                 found = true;
                 break;
@@ -2094,8 +2114,8 @@ void ProFileEvaluator::Private::expandPatternHelper(const QString &relName, cons
             wildcard = wildcard.right(wildcard.length() - dir.length());
         }
 
-        if (real_dir.isEmpty() || QFileInfo(real_dir).exists()) {
-            QStringList files = QDir(real_dir).entryList(QStringList(wildcard));
+        if (real_dir.isEmpty() || QFileInfo(absoluteFilePath(real_dir)).exists()) {
+            QStringList files = QDir(absoluteFilePath(real_dir)).entryList(QStringList(wildcard));
             if (files.isEmpty()) {
                 q->logMessage(format("Failure to find %1").arg(val));
             } else {
@@ -2130,7 +2150,7 @@ QStringList ProFileEvaluator::Private::expandPattern(const QString& pattern)
         return QStringList();
 
     QStringList sources_out;
-    const QString absName = QDir::cleanPath(QDir::current().absoluteFilePath(pattern));
+    const QString absName = absoluteFilePath(pattern);
 
     expandPatternHelper(pattern, absName, sources_out);
     return sources_out;
@@ -43,6 +43,7 @@
 #include <Scope.h>
 
 #include <QByteArray>
+#include <QtAlgorithms>
 #include <QFile>
 #include <QtDebug>
 
@@ -153,6 +154,31 @@ void Document::addMacroUse(const Macro &macro, unsigned offset, unsigned length)
     _macroUses.append(MacroUse(macro, offset, offset + length));
 }
 
+void Document::setMacroLookups(const QVector<unsigned> &lookups)
+{
+    _macroLookups = lookups;
+    qSort(_macroLookups);
+
+    // remove the duplicates
+    unsigned *first = _macroLookups.begin();
+    unsigned *last = _macroLookups.end();
+    if (first != last) {
+        unsigned *result = first;
+        while (++first != last) {
+            if (*result != *first)
+                *++result = *first;
+        }
+        _macroLookups.resize(result - _macroLookups.begin() + 1);
+    }
+    _macroLookups.squeeze();
+}
+
+bool Document::hasMacroLookup(unsigned hashCode) const
+{
+    return qBinaryFind(_macroLookups.constBegin(), _macroLookups.constEnd(), hashCode)
+            != _macroLookups.constEnd();
+}
+
 TranslationUnit *Document::translationUnit() const
 {
     return _translationUnit;
@@ -168,6 +194,11 @@ void Document::setSkipFunctionBody(bool skipFunctionBody)
     _translationUnit->setSkipFunctionBody(skipFunctionBody);
 }
 
+void Document::setActiveLines(unsigned firstLine, unsigned lastLine)
+{
+    _translationUnit->setActiveLines(firstLine, lastLine);
+}
+
 unsigned Document::globalSymbolCount() const
 {
     if (! _globalNamespace)
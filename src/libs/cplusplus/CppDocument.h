@@ -43,6 +43,7 @@
 #include <QSharedPointer>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 namespace CPlusPlus {
 
@@ -74,6 +75,7 @@ public:
 
     bool skipFunctionBody() const;
     void setSkipFunctionBody(bool skipFunctionBody);
+    void setActiveLines(unsigned firstLine, unsigned lastLine);
 
     unsigned globalSymbolCount() const;
     Symbol *globalSymbolAt(unsigned index) const;
@@ -220,6 +222,14 @@ public:
     QList<MacroUse> macroUses() const
     { return _macroUses; }
 
+    // The hash codes (see Environment::hashCode()) of the names the
+    // preprocessor looked up while expanding this document, sorted.
+    QVector<unsigned> macroLookups() const
+    { return _macroLookups; }
+
+    void setMacroLookups(const QVector<unsigned> &lookups);
+    bool hasMacroLookup(unsigned hashCode) const;
+
 private:
     Symbol *findSymbolAt(unsigned line, unsigned column, Scope *scope) const;
 
@@ -233,6 +243,7 @@ private:
     QList<Macro> _definedMacros;
     QList<Block> _skippedBlocks;
     QList<MacroUse> _macroUses;
+    QVector<unsigned> _macroLookups;
 };
 
 class CPLUSPLUS_EXPORT Snapshot: public QMap<QString, Document::Ptr>
@@ -42,10 +42,80 @@
 #include <Scope.h>
 #include <Control.h>
 
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSet>
 #include <QtDebug>
 
 using namespace CPlusPlus;
 
+/////////////////////////////////////////////////////////////////////
+// LookupCache
+/////////////////////////////////////////////////////////////////////
+
+// Building the visible scopes walks the whole include closure of a document
+// and expands it until nothing changes, which is far too expensive to repeat
+// for every expression. The result only depends on the documents of the
+// closure and on the scope of the current symbol, so it is kept together
+// with the documents it was computed from, and reused for as long as the
+// snapshot still contains exactly those documents. Class expansions and
+// name lookups in the visible scopes are memoized on top of it.
+namespace CPlusPlus {
+
+class LookupCache
+{
+public:
+    bool isUpToDate(const Snapshot &documents) const;
+
+    Document::Ptr thisDocument;
+    QList<Document::Ptr> documents; // the include closure of thisDocument
+    QStringList missingFiles;       // included, but not in the snapshot
+    QSet<QString> fileNames;
+    QList<Scope *> visibleScopes;
+
+    QMutex mutex;
+    QHash<Scope *, QList<Scope *> > expandedScopes;
+    QHash<QPair<QByteArray, int>, QList<Symbol *> > resolvedNames;
+};
+
+} // end of namespace CPlusPlus
+
+bool LookupCache::isUpToDate(const Snapshot &snapshot) const
+{
+    if (snapshot.value(thisDocument->fileName()) != thisDocument)
+        return false;
+
+    foreach (const Document::Ptr &doc, documents) {
+        if (snapshot.value(doc->fileName()) != doc)
+            return false;
+    }
+
+    foreach (const QString &fileName, missingFiles) {
+        if (snapshot.contains(fileName))
+            return false;
+    }
+
+    return true;
+}
+
+namespace {
+
+enum { MAX_LOOKUP_CACHE_COUNT = 32 };
+
+typedef QPair<Document *, Scope *> LookupCacheKey;
+
+class LookupCacheRegistry
+{
+public:
+    QMutex mutex;
+    QHash<LookupCacheKey, QSharedPointer<LookupCache> > caches;
+};
+
+} // end of anonymous namespace
+
+Q_GLOBAL_STATIC(LookupCacheRegistry, lookupCacheRegistry)
+
 bool LookupContext::isNameCompatibleWithIdentifier(Name *name, Identifier *id)
 {
     if (! name) {
@@ -82,7 +152,7 @@ LookupContext::LookupContext(Symbol *symbol,
       _documents(documents)
 {
     _control = _expressionDocument->control();
-    _visibleScopes = buildVisibleScopes();
+    initVisibleScopes();
 }
 
 LookupContext::LookupContext(Symbol *symbol,
@@ -94,7 +164,7 @@ LookupContext::LookupContext(Symbol *symbol,
 {
     const QString fn = QString::fromUtf8(symbol->fileName(), symbol->fileNameLength());
     _thisDocument = _documents.value(fn);
-    _visibleScopes = buildVisibleScopes();
+    initVisibleScopes();
 }
 
 LookupContext::LookupContext(Symbol *symbol,
@@ -106,7 +176,7 @@ LookupContext::LookupContext(Symbol *symbol,
       _thisDocument(thisDocument),
       _documents(context._documents)
 {
-    _visibleScopes = buildVisibleScopes();
+    initVisibleScopes();
 }
 
 bool LookupContext::isValid() const
@@ -171,8 +241,26 @@ QList<Symbol *> LookupContext::resolve(Name *name, const QList<Scope *> &visible
         return QList<Symbol *>();
     }
 
+    Identifier *id = identifier(name);
+
+    // Lookups of plain names in the visible scopes are remembered.
+    const bool memoize = id && _cache && isVisibleScopes(visibleScopes);
+    QPair<QByteArray, int> key;
+    if (memoize) {
+        int flags = mode;
+        if (name->isDestructorNameId())
+            flags |= 0x100;
+        key = qMakePair(QByteArray(id->chars(), id->size()), flags);
+
+        QMutexLocker locker(&_cache->mutex);
+        QHash<QPair<QByteArray, int>, QList<Symbol *> >::const_iterator it =
+                _cache->resolvedNames.constFind(key);
+        if (it != _cache->resolvedNames.constEnd())
+            return it.value();
+    }
+
     QList<Symbol *> candidates;
-    if (Identifier *id = identifier(name)) {
+    if (id) {
         for (int scopeIndex = 0; scopeIndex < visibleScopes.size(); ++scopeIndex) {
             Scope *scope = visibleScopes.at(scopeIndex);
             for (Symbol *symbol = scope->lookat(id); symbol; symbol = symbol->next()) {
@@ -203,10 +291,66 @@ QList<Symbol *> LookupContext::resolve(Name *name, const QList<Scope *> &visible
         }
     }
 
+    if (memoize) {
+        QMutexLocker locker(&_cache->mutex);
+        _cache->resolvedNames.insert(key, candidates);
+    }
+
     return candidates;
 }
 
-QList<Scope *> LookupContext::buildVisibleScopes()
+void LookupContext::initVisibleScopes()
+{
+    // Only symbols of thisDocument are kept alive by the cache, any other
+    // scope could be deleted and its address reused.
+    if (_symbol && _symbol->fileId() != _thisDocument->translationUnit()->fileId()) {
+        _visibleScopes = buildVisibleScopes();
+        return;
+    }
+
+    const LookupCacheKey key(_thisDocument.data(), _symbol ? _symbol->scope() : 0);
+    LookupCacheRegistry *registry = lookupCacheRegistry();
+
+    QSharedPointer<LookupCache> cache;
+    {
+        QMutexLocker locker(&registry->mutex);
+        cache = registry->caches.value(key);
+    }
+
+    if (cache && cache->isUpToDate(_documents)) {
+        _cache = cache;
+        _visibleScopes = cache->visibleScopes;
+        return;
+    }
+
+    cache = QSharedPointer<LookupCache>(new LookupCache);
+    cache->thisDocument = _thisDocument;
+    cache->visibleScopes = buildVisibleScopes(cache.data());
+    _cache = cache;
+    _visibleScopes = cache->visibleScopes;
+
+    QMutexLocker locker(&registry->mutex);
+    // Drop the caches that are out of date, including those where only an
+    // included document was replaced; they would keep the old documents alive.
+    QHash<LookupCacheKey, QSharedPointer<LookupCache> >::iterator it = registry->caches.begin();
+    while (it != registry->caches.end()) {
+        if (! it.value()->isUpToDate(_documents))
+            it = registry->caches.erase(it);
+        else
+            ++it;
+    }
+    if (registry->caches.size() >= MAX_LOOKUP_CACHE_COUNT)
+        registry->caches.clear();
+    registry->caches.insert(key, cache);
+}
+
+bool LookupContext::isVisibleScopes(const QList<Scope *> &scopes) const
+{
+    // Implicitly shared copies of the visible scopes have the same data.
+    return scopes.constBegin() == _visibleScopes.constBegin();
+}
+
+QList<Scope *> LookupContext::buildVisibleScopes(LookupCache *cache)
 {
     QList<Scope *> scopes;
 
@@ -231,9 +375,18 @@ QList<Scope *> LookupContext::buildVisibleScopes()
         if (Document::Ptr doc = document(fn)) {
             scopes.append(doc->globalNamespace()->members());
             todo += doc->includedFiles();
+            if (cache) {
+                cache->documents.append(doc);
+                cache->fileNames.insert(fn);
+            }
+        } else if (cache) {
+            cache->missingFiles.append(fn);
         }
     }
 
+    if (cache)
+        cache->fileNames.insert(_thisDocument->fileName());
+
     while (true) {
         QList<Scope *> expandedScopes;
         expand(scopes, &expandedScopes);
@@ -272,6 +425,39 @@ void LookupContext::expand(const QList<Scope *> &scopes, QList<Scope *> *expande
     }
 }
 
+QList<Scope *> LookupContext::expand(Scope *scope) const
+{
+    // Only the expansions of scopes owned by the documents of the cache
+    // can be remembered, any other scope may go away.
+    bool memoize = false;
+    if (_cache) {
+        if (Symbol *owner = scope->owner()) {
+            const QString fn = QString::fromUtf8(owner->fileName(), owner->fileNameLength());
+            if (_cache->fileNames.contains(fn)) {
+                const Document::Ptr doc = document(fn);
+                memoize = doc && doc->translationUnit()->fileId() == owner->fileId();
+            }
+        }
+    }
+
+    if (memoize) {
+        QMutexLocker locker(&_cache->mutex);
+        QHash<Scope *, QList<Scope *> >::const_iterator it = _cache->expandedScopes.constFind(scope);
+        if (it != _cache->expandedScopes.constEnd())
+            return it.value();
+    }
+
+    QList<Scope *> expandedScopes;
+    expand(scope, _visibleScopes, &expandedScopes);
+
+    if (memoize) {
+        QMutexLocker locker(&_cache->mutex);
+        _cache->expandedScopes.insert(scope, expandedScopes);
+    }
+
+    return expandedScopes;
+}
+
 void LookupContext::expandNamespace(Scope *scope,
                                     const QList<Scope *> &visibleScopes,
                                     QList<Scope *> *expandedScopes) const
@@ -39,6 +39,8 @@
 
 namespace CPlusPlus {
 
+class LookupCache;
+
 class CPLUSPLUS_EXPORT LookupContext
 {
 public:
@@ -111,6 +113,10 @@ public:
 
     void expand(const QList<Scope *> &scopes, QList<Scope *> *expandedScopes) const;
 
+    // Expands the given scope against the visible scopes of this context.
+    // The result is shared by all contexts of the same document and scope.
+    QList<Scope *> expand(Scope *scope) const;
+
     void expand(Scope *scope, const QList<Scope *> &visibleScopes,
                 QList<Scope *> *expandedScopes) const;
 
@@ -131,7 +137,9 @@ public:
                         QList<Scope *> *expandedScopes) const;
 
 private:
-    QList<Scope *> buildVisibleScopes();
+    void initVisibleScopes();
+    QList<Scope *> buildVisibleScopes(LookupCache *cache = 0);
+    bool isVisibleScopes(const QList<Scope *> &scopes) const;
     static bool isNameCompatibleWithIdentifier(Name *name, Identifier *id);
 
 private:
@@ -151,6 +159,9 @@ private:
 
     // Visible scopes.
     QList<Scope *> _visibleScopes;
+
+    // Lookups memoized for the visible scopes, shared between contexts.
+    QSharedPointer<LookupCache> _cache;
 };
 
 } // end of namespace CPlusPlus
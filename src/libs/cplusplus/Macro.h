@@ -70,7 +70,7 @@ public:
     { return _name; }
 
     void setName(const QByteArray &name)
-    { _name = name; }
+    { _name = name; _hashcode = 0; }
 
     QByteArray definition() const
     { return _definition; }
@@ -121,6 +121,8 @@ public:
     unsigned _hashcode;
 
 private:
+    friend class Environment;
+
     QByteArray _name;
     QByteArray _definition;
     QVector<QByteArray> _formals;
@@ -53,27 +53,41 @@
 #include "PreprocessorEnvironment.h"
 #include "Macro.h"
 #include <cstring>
+#include <new>
 
 using namespace CPlusPlus;
 
+enum {
+    MacroBlockSize = 512
+};
+
 Environment::Environment()
     : currentLine(0),
       hideNext(false),
+      lookups(0),
       _macros(0),
       _allocated_macros(0),
       _macro_count(-1),
       _hash(0),
-      _hash_count(401)
+      _hash_count(401),
+      _blocks(0),
+      _block_count(0),
+      _block_used(MacroBlockSize)
 {
 }
 
 Environment::~Environment()
 {
     if (_macros) {
-        qDeleteAll(firstMacro(), lastMacro());
+        for (Macro **it = firstMacro(); it != lastMacro(); ++it)
+            (*it)->~Macro();
         free(_macros);
     }
 
+    for (int i = 0; i < _block_count; ++i)
+        free(_blocks[i]);
+    free(_blocks);
+
     if (_hash)
         free(_hash);
 }
@@ -92,8 +106,11 @@ Macro *Environment::bind(const Macro &__macro)
 {
     Q_ASSERT(! __macro.name().isEmpty());
 
-    Macro *m = new Macro (__macro);
-    m->_hashcode = hashCode(m->name());
+    // The hash code of the name is computed when the macro is bound for the
+    // first time; the copies kept by the documents carry it when merged again.
+    Macro *m = allocateMacro(__macro);
+    if (! m->_hashcode)
+        m->_hashcode = hashCode(m->name().constData(), m->name().size());
 
     if (++_macro_count == _allocated_macros) {
         if (! _allocated_macros)
@@ -117,6 +134,17 @@ Macro *Environment::bind(const Macro &__macro)
     return m;
 }
 
+Macro *Environment::allocateMacro(const Macro &macro)
+{
+    if (_block_used == MacroBlockSize) {
+        _blocks = (Macro **) realloc(_blocks, sizeof(Macro *) * (_block_count + 1));
+        _blocks[_block_count++] = (Macro *) malloc(sizeof(Macro) * MacroBlockSize);
+        _block_used = 0;
+    }
+
+    return new (_blocks[_block_count - 1] + _block_used++) Macro(macro);
+}
+
 Macro *Environment::remove(const QByteArray &name)
 {
     Macro macro;
@@ -193,12 +221,24 @@ bool Environment::isBuiltinMacro(const QByteArray &s) const
 
 Macro *Environment::resolve(const QByteArray &name) const
 {
+    return resolve(name.constData(), name.size());
+}
+
+Macro *Environment::resolve(const char *name, int size) const
+{
+    const unsigned h = hashCode(name, size);
+
+    if (lookups)
+        lookups->append(h);
+
     if (! _macros)
         return 0;
 
-    Macro *it = _hash[hashCode(name) % _hash_count];
+    Macro *it = _hash[h % _hash_count];
     for (; it; it = it->_next) {
-        if (it->name() != name)
+        // compare the names only when the hash codes are equal.
+        if (it->_hashcode != h || it->_name.size() != size
+                || std::memcmp(it->_name.constData(), name, size) != 0)
             continue;
         else if (it->isHidden())
             return 0;
@@ -207,12 +247,17 @@ Macro *Environment::resolve(const QByteArray &name) const
     return it;
 }
 
-unsigned Environment::hashCode(const QByteArray &s)
+unsigned Environment::hashCode(const QByteArray &name)
+{
+    return hashCode(name.constData(), name.size());
+}
+
+unsigned Environment::hashCode(const char *s, int size)
 {
     unsigned hash_value = 0;
 
-    for (int i = 0; i < s.size (); ++i)
-        hash_value = (hash_value << 5) - hash_value + s.at (i);
+    for (int i = 0; i < size; ++i)
+        hash_value = (hash_value << 5) - hash_value + s[i];
 
     return hash_value;
 }
@@ -75,8 +75,11 @@ public:
     Macro *remove(const QByteArray &name);
 
     Macro *resolve(const QByteArray &name) const;
+    Macro *resolve(const char *name, int size) const;
     bool isBuiltinMacro(const QByteArray &name) const;
 
+    static unsigned hashCode(const QByteArray &name);
+
     const Macro *const *firstMacro() const
     { return _macros; }
 
@@ -90,7 +93,8 @@ public:
     { return _macros + _macro_count + 1; }
 
 private:
-    static unsigned hashCode(const QByteArray &s);
+    static unsigned hashCode(const char *s, int size);
+    Macro *allocateMacro(const Macro &macro);
     void rehash();
 
 public:
@@ -98,12 +102,24 @@ public:
     unsigned currentLine;
     bool hideNext;
 
+    // when set, the hash codes of all the names looked up by resolve()
+    // are appended to it, whether they are defined or not.
+    QVector<unsigned> *lookups;
+
 private:
     Macro **_macros;
     int _allocated_macros;
     int _macro_count;
     Macro **_hash;
     int _hash_count;
+
+    // the macros are allocated in blocks of MacroBlockSize
+    Macro **_blocks;
+    int _block_count;
+    int _block_used;
+
+private:
+    Q_DISABLE_COPY(Environment)
 };
 
 } // namespace CPlusPlus
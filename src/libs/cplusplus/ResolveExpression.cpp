@@ -687,8 +687,7 @@ ResolveExpression::resolveMember(const Result &,
                                  NamedType *namedTy,
                                  Class *klass) const
 {
-    QList<Scope *> scopes;
-    _context.expand(klass->members(), _context.visibleScopes(), &scopes);
+    const QList<Scope *> scopes = _context.expand(klass->members());
     QList<Result> results;
 
     QList<Symbol *> candidates = _context.resolve(memberName, scopes);
@@ -723,8 +722,7 @@ ResolveExpression::resolveArrowOperator(const Result &,
                                         NamedType *namedTy,
                                         Class *klass) const
 {
-    QList<Scope *> scopes;
-    _context.expand(klass->members(), _context.visibleScopes(), &scopes);
+    const QList<Scope *> scopes = _context.expand(klass->members());
     QList<Result> results;
 
     Name *memberName = control()->operatorNameId(OperatorNameId::ArrowOp);
@@ -762,8 +760,7 @@ ResolveExpression::resolveArrayOperator(const Result &,
 {
     // ### todo handle index expressions.
 
-    QList<Scope *> scopes;
-    _context.expand(klass->members(), _context.visibleScopes(), &scopes);
+    const QList<Scope *> scopes = _context.expand(klass->members());
     QList<Result> results;
 
     Name *memberName = control()->operatorNameId(OperatorNameId::ArrayAccessOp);
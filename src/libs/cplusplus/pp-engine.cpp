@@ -906,10 +906,11 @@ void Preprocessor::processDefine(TokenIterator firstToken, TokenIterator lastTok
         macro.setDefinition(definition.trimmed());
     }
 
-    env.bind(macro);
+    // the bound copy carries the hash code of the name.
+    const Macro *boundMacro = env.bind(macro);
 
     if (client)
-        client->macroAdded(macro);
+        client->macroAdded(*boundMacro);
 }
 
 void Preprocessor::processIf(TokenIterator firstToken, TokenIterator lastToken)
@@ -195,7 +195,8 @@ const char *MacroExpander::operator () (const char *__first, const char *__last,
                     __first = skip_blanks(++next, __last);
             }
 
-            const QByteArray fast_name(name_begin, name_end - name_begin);
+            // the identifier is looked up in place, without copying it.
+            const QByteArray fast_name = QByteArray::fromRawData(name_begin, name_end - name_begin);
 
             if (const QByteArray *actual = resolve_formal (fast_name))
             {
@@ -215,14 +216,14 @@ const char *MacroExpander::operator () (const char *__first, const char *__last,
             Macro *macro = env.resolve (fast_name);
             if (! macro || macro->isHidden() || env.hideNext)
             {
-                if (fast_name.size () == 7 && fast_name [0] == 'd' && fast_name == "defined")
+                if (fast_name.size () == 7 && fast_name [0] == 'd' && ! qstrncmp(name_begin, "defined", 7))
                     env.hideNext = true;
                 else
                     env.hideNext = false;
 
                 if (fast_name.size () == 8 && fast_name [0] == '_' && fast_name [1] == '_')
                 {
-                    if (fast_name == "__LINE__")
+                    if (! qstrncmp(name_begin, "__LINE__", 8))
                     {
                         char buf [16];
                         const size_t count = qsnprintf (buf, 16, "%d", env.currentLine + lines);
@@ -230,7 +231,7 @@ const char *MacroExpander::operator () (const char *__first, const char *__last,
                         continue;
                     }
 
-                    else if (fast_name == "__FILE__")
+                    else if (! qstrncmp(name_begin, "__FILE__", 8))
                     {
                         __result->append('"');
                         __result->append(env.currentFile);
@@ -238,7 +239,7 @@ const char *MacroExpander::operator () (const char *__first, const char *__last,
                         continue;
                     }
 
-                    else if (fast_name == "__DATE__")
+                    else if (! qstrncmp(name_begin, "__DATE__", 8))
                     {
                         __result->append('"');
                         __result->append(QDate::currentDate().toString().toUtf8());
@@ -246,7 +247,7 @@ const char *MacroExpander::operator () (const char *__first, const char *__last,
                         continue;
                     }
 
-                    else if (fast_name == "__TIME__")
+                    else if (! qstrncmp(name_begin, "__TIME__", 8))
                     {
                         __result->append('"');
                         __result->append(QTime::currentTime().toString().toUtf8());
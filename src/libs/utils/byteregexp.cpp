@@ -0,0 +1,966 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "byteregexp.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+#include <QtCore/QtAlgorithms>
+
+#include <algorithm>
+
+#include <ctype.h>
+#include <string.h>
+
+using namespace Core::Utils;
+
+enum {
+    MaxNodes = 10000,
+    // The DFA caches are flushed when they grow beyond this
+    MaxStates = 2000,
+    Unknown = -2,
+    Dead = -1,
+    EndOfLine = -1
+};
+
+namespace {
+
+struct ByteSet
+{
+    ByteSet()
+    { memset(bits, 0, sizeof(bits)); }
+
+    void add(uchar c)
+    { bits[c >> 5] |= 1u << (c & 31); }
+
+    void addRange(int first, int last)
+    {
+        for (int c = first; c <= last; ++c)
+            add(c);
+    }
+
+    void addSet(const ByteSet &other)
+    {
+        for (int i = 0; i < 8; ++i)
+            bits[i] |= other.bits[i];
+    }
+
+    bool contains(uchar c) const
+    { return bits[c >> 5] & (1u << (c & 31)); }
+
+    int count() const
+    {
+        int n = 0;
+        for (int c = 0; c < 256; ++c)
+            n += contains(c);
+        return n;
+    }
+
+    quint32 bits[8];
+};
+
+inline bool isWordByte(int c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+            || c == '_' || c >= 0x80;
+}
+
+struct Term
+{
+    enum Kind {
+        Empty,
+        // ASCII characters from ascii, and all other characters if nonAscii is set
+        Chars,
+        Concatenation,
+        Alternation,
+        Repetition,
+        LineStart,
+        LineEnd,
+        WordBoundary,
+        NotWordBoundary
+    };
+
+    Term(Kind kind = Empty)
+        : kind(kind), nonAscii(false), min(0), max(0)
+    { }
+
+    Kind kind;
+    ByteSet ascii;
+    bool nonAscii;
+    int min;
+    int max; // -1 for no upper bound
+    QVector<int> children;
+};
+
+// Parses the supported subset of the QRegExp syntax into terms.
+class Parser
+{
+public:
+    Parser(const QByteArray &pattern, bool caseInsensitive)
+        : m_pattern(pattern), m_pos(0), m_caseInsensitive(caseInsensitive), m_error(false)
+    { }
+
+    // Returns the root term, or -1 if the pattern is not supported.
+    int parse()
+    {
+        const int root = parseAlternation();
+        if (m_error || m_pos != m_pattern.size())
+            return -1;
+        return root;
+    }
+
+    QVector<Term> terms;
+
+private:
+    bool atEnd() const
+    { return m_pos == m_pattern.size(); }
+
+    char peek() const
+    { return atEnd() ? 0 : m_pattern.at(m_pos); }
+
+    int add(const Term &term)
+    {
+        terms.append(term);
+        return terms.size() - 1;
+    }
+
+    int error()
+    {
+        m_error = true;
+        return -1;
+    }
+
+    int parseAlternation()
+    {
+        Term alternation(Term::Alternation);
+        alternation.children.append(parseConcatenation());
+        while (! m_error && peek() == '|') {
+            ++m_pos;
+            alternation.children.append(parseConcatenation());
+        }
+        if (m_error)
+            return -1;
+        if (alternation.children.size() == 1)
+            return alternation.children.first();
+        return add(alternation);
+    }
+
+    int parseConcatenation()
+    {
+        Term concatenation(Term::Concatenation);
+        while (! m_error && ! atEnd() && peek() != '|' && peek() != ')')
+            concatenation.children.append(parseRepetition());
+        if (m_error)
+            return -1;
+        if (concatenation.children.isEmpty())
+            return add(Term(Term::Empty));
+        if (concatenation.children.size() == 1)
+            return concatenation.children.first();
+        return add(concatenation);
+    }
+
+    int parseRepetition()
+    {
+        int atom = parseAtom();
+        while (! m_error && ! atEnd()) {
+            Term repetition(Term::Repetition);
+            const char c = peek();
+            if (c == '*') {
+                repetition.min = 0;
+                repetition.max = -1;
+            } else if (c == '+') {
+                repetition.min = 1;
+                repetition.max = -1;
+            } else if (c == '?') {
+                repetition.min = 0;
+                repetition.max = 1;
+            } else if (c == '{') {
+                ++m_pos;
+                repetition.min = repetition.max = parseNumber();
+                if (peek() == ',') {
+                    ++m_pos;
+                    repetition.max = (peek() == '}') ? -1 : parseNumber();
+                }
+                if (peek() != '}' || repetition.min < 0
+                        || (repetition.max != -1 && repetition.max < repetition.min))
+                    return error();
+            } else {
+                break;
+            }
+            ++m_pos;
+
+            const Term::Kind kind = terms.at(atom).kind;
+            if (kind != Term::Chars && kind != Term::Concatenation
+                    && kind != Term::Alternation && kind != Term::Repetition)
+                return error();
+
+            repetition.children.append(atom);
+            atom = add(repetition);
+        }
+        return atom;
+    }
+
+    int parseNumber()
+    {
+        int value = -1;
+        while (! atEnd() && peek() >= '0' && peek() <= '9' && value < 1000)
+            value = qMax(value, 0) * 10 + (m_pattern.at(m_pos++) - '0');
+        return value;
+    }
+
+    int parseAtom()
+    {
+        const char c = m_pattern.at(m_pos++);
+        switch (c) {
+        case '(': {
+            if (peek() == '?') {
+                // only non-capturing groups, no lookaheads
+                if (m_pos + 1 >= m_pattern.size() || m_pattern.at(m_pos + 1) != ':')
+                    return error();
+                m_pos += 2;
+            }
+            const int group = parseAlternation();
+            if (m_error || peek() != ')')
+                return error();
+            ++m_pos;
+            return group;
+        }
+        case '[': {
+            Term term(Term::Chars);
+            if (! parseClass(&term))
+                return error();
+            return add(term);
+        }
+        case '.': {
+            Term term(Term::Chars);
+            term.ascii.addRange(0, 0x7f);
+            term = withoutLineBreaks(term);
+            term.nonAscii = true;
+            return add(term);
+        }
+        case '^':
+            return add(Term(Term::LineStart));
+        case '$':
+            return add(Term(Term::LineEnd));
+        case '\\': {
+            if (atEnd())
+                return error();
+            const char e = m_pattern.at(m_pos);
+            if (e == 'b' || e == 'B') {
+                ++m_pos;
+                return add(Term(e == 'b' ? Term::WordBoundary : Term::NotWordBoundary));
+            }
+            Term term(Term::Chars);
+            if (! parseEscape(&term))
+                return error();
+            return add(term);
+        }
+        case '*': case '+': case '?': case '{': case ')':
+            return error();
+        default: {
+            Term term(Term::Chars);
+            addCharacter(&term, c);
+            return add(term);
+        }
+        }
+    }
+
+    // Parses an escape sequence after the backslash into term.
+    bool parseEscape(Term *term)
+    {
+        const char c = m_pattern.at(m_pos++);
+        switch (c) {
+        case 'd': case 'D':
+            term->ascii.addRange('0', '9');
+            break;
+        case 'w': case 'W':
+            term->ascii.addRange('a', 'z');
+            term->ascii.addRange('A', 'Z');
+            term->ascii.addRange('0', '9');
+            term->ascii.add('_');
+            term->nonAscii = true;
+            break;
+        case 's': case 'S':
+            term->ascii.addRange('\t', '\r');
+            term->ascii.add(' ');
+            break;
+        case 'n': term->ascii.add('\n'); return true;
+        case 'r': term->ascii.add('\r'); return true;
+        case 't': term->ascii.add('\t'); return true;
+        case 'f': term->ascii.add('\f'); return true;
+        case 'v': term->ascii.add('\v'); return true;
+        case 'a': term->ascii.add('\a'); return true;
+        case '0': {
+            int value = 0;
+            for (int i = 0; i < 3 && peek() >= '0' && peek() <= '7'; ++i)
+                value = value * 8 + (m_pattern.at(m_pos++) - '0');
+            if (value >= 0x80)
+                return false;
+            addCharacter(term, value);
+            return true;
+        }
+        case 'x': {
+            int value = 0;
+            for (int i = 0; i < 4 && isxdigit(uchar(peek())); ++i) {
+                const char h = m_pattern.at(m_pos++);
+                value = value * 16 + ((h <= '9') ? h - '0' : (h | 0x20) - 'a' + 10);
+            }
+            if (value >= 0x80)
+                return false;
+            addCharacter(term, value);
+            return true;
+        }
+        default:
+            // backreferences and unknown escapes
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+                return false;
+            addCharacter(term, c);
+            return true;
+        }
+
+        if (c >= 'A' && c <= 'Z')
+            *term = negated(*term);
+        return true;
+    }
+
+    bool parseClass(Term *term)
+    {
+        bool negate = false;
+        if (peek() == '^') {
+            negate = true;
+            ++m_pos;
+        }
+
+        Term chars(Term::Chars);
+        bool first = true;
+        while (! atEnd() && (first || peek() != ']')) {
+            first = false;
+            int c = uchar(m_pattern.at(m_pos++));
+            if (c == '\\') {
+                if (atEnd())
+                    return false;
+                Term escaped(Term::Chars);
+                const char e = peek();
+                if (e == 'b' || e == 'B' || ! parseEscape(&escaped))
+                    return false;
+                if (escaped.nonAscii || escaped.ascii.count() != 1) {
+                    chars.ascii.addSet(escaped.ascii);
+                    chars.nonAscii |= escaped.nonAscii;
+                    continue;
+                }
+                for (c = 0; ! escaped.ascii.contains(c); ++c)
+                    ;
+            }
+
+            if (peek() == '-' && m_pos + 1 < m_pattern.size() && m_pattern.at(m_pos + 1) != ']') {
+                ++m_pos;
+                int last = uchar(m_pattern.at(m_pos++));
+                if (last == '\\') {
+                    Term escaped(Term::Chars);
+                    if (atEnd() || ! parseEscape(&escaped) || escaped.ascii.count() != 1)
+                        return false;
+                    for (last = 0; ! escaped.ascii.contains(last); ++last)
+                        ;
+                }
+                if (last < c)
+                    return false;
+                for (int i = c; i <= last; ++i)
+                    addCharacter(&chars, i);
+            } else {
+                addCharacter(&chars, c);
+            }
+        }
+        if (atEnd())
+            return false;
+        ++m_pos;
+
+        *term = negate ? negated(chars) : chars;
+        return true;
+    }
+
+    void addCharacter(Term *term, int c) const
+    {
+        term->ascii.add(c);
+        if (m_caseInsensitive) {
+            if (c >= 'a' && c <= 'z')
+                term->ascii.add(c - 'a' + 'A');
+            else if (c >= 'A' && c <= 'Z')
+                term->ascii.add(c - 'A' + 'a');
+        }
+    }
+
+    static Term negated(const Term &term)
+    {
+        Term result(Term::Chars);
+        for (int c = 0; c < 0x80; ++c) {
+            if (! term.ascii.contains(c))
+                result.ascii.add(c);
+        }
+        result.nonAscii = ! term.nonAscii;
+        return withoutLineBreaks(result);
+    }
+
+    static Term withoutLineBreaks(const Term &term)
+    {
+        Term result = term;
+        result.ascii.bits['\n' >> 5] &= ~(1u << ('\n' & 31));
+        result.ascii.bits['\r' >> 5] &= ~(1u << ('\r' & 31));
+        return result;
+    }
+
+    QByteArray m_pattern;
+    int m_pos;
+    bool m_caseInsensitive;
+    bool m_error;
+};
+
+struct Node
+{
+    enum Kind {
+        Bytes,
+        Split,
+        Jump,
+        Assertion,
+        Match
+    };
+
+    Node(Kind kind = Match)
+        : kind(kind), set(-1), assertion(Term::Empty), out(-1), out1(-1)
+    { }
+
+    Kind kind;
+    int set;
+    Term::Kind assertion;
+    int out;
+    int out1;
+};
+
+// A partially built NFA: its entry node and the dangling exits,
+// encoded as node * 2 + (0 for out, 1 for out1).
+struct Fragment
+{
+    int start;
+    QVector<int> exits;
+};
+
+} // anonymous namespace
+
+namespace Core {
+namespace Utils {
+
+class ByteRegExpProgram
+{
+public:
+    ByteRegExpProgram(const QString &pattern, Qt::CaseSensitivity cs)
+        : m_start(-1), m_error(false)
+    {
+        for (int i = 0; i < pattern.length(); ++i) {
+            if (pattern.at(i).unicode() >= 0x80)
+                return;
+        }
+
+        Parser parser(pattern.toLatin1(), cs == Qt::CaseInsensitive);
+        const int root = parser.parse();
+        if (root == -1)
+            return;
+        m_terms = parser.terms;
+
+        const Fragment fragment = compile(root);
+        if (m_error)
+            return;
+        patch(fragment.exits, addNode(Node(Node::Match)));
+        m_start = fragment.start;
+        m_literal = literal(root, cs == Qt::CaseInsensitive);
+    }
+
+    bool isValid() const
+    { return m_start != -1; }
+
+    int start() const
+    { return m_start; }
+
+    const Node &node(int index) const
+    { return m_nodes.at(index); }
+
+    int nodeCount() const
+    { return m_nodes.size(); }
+
+    const ByteSet &set(int index) const
+    { return m_sets.at(index); }
+
+    QByteArray requiredLiteral() const
+    { return m_literal; }
+
+private:
+    int addNode(const Node &node)
+    {
+        if (m_nodes.size() >= MaxNodes)
+            m_error = true;
+        m_nodes.append(node);
+        return m_nodes.size() - 1;
+    }
+
+    int addBytes(const ByteSet &set)
+    {
+        m_sets.append(set);
+        Node node(Node::Bytes);
+        node.set = m_sets.size() - 1;
+        return addNode(node);
+    }
+
+    void patch(const QVector<int> &exits, int target)
+    {
+        foreach (int exit, exits) {
+            Node &node = m_nodes[exit / 2];
+            if (exit % 2)
+                node.out1 = target;
+            else
+                node.out = target;
+        }
+    }
+
+    Fragment single(int node) const
+    {
+        Fragment fragment;
+        fragment.start = node;
+        fragment.exits.append(node * 2);
+        return fragment;
+    }
+
+    Fragment compile(int index)
+    {
+        if (m_error)
+            return single(0);
+
+        const Term term = m_terms.at(index);
+        switch (term.kind) {
+        case Term::Empty:
+            return single(addNode(Node(Node::Jump)));
+
+        case Term::Chars:
+            return compileChars(term);
+
+        case Term::Concatenation: {
+            Fragment fragment = compile(term.children.first());
+            for (int i = 1; i < term.children.size(); ++i) {
+                const Fragment next = compile(term.children.at(i));
+                patch(fragment.exits, next.start);
+                fragment.exits = next.exits;
+            }
+            return fragment;
+        }
+
+        case Term::Alternation: {
+            Fragment fragment = compile(term.children.last());
+            for (int i = term.children.size() - 2; i >= 0; --i) {
+                const Fragment alternative = compile(term.children.at(i));
+                Node split(Node::Split);
+                split.out = alternative.start;
+                split.out1 = fragment.start;
+                fragment.start = addNode(split);
+                fragment.exits += alternative.exits;
+            }
+            return fragment;
+        }
+
+        case Term::Repetition: {
+            const int child = term.children.first();
+            Fragment fragment = single(addNode(Node(Node::Jump)));
+            for (int i = 0; i < term.min; ++i) {
+                const Fragment next = compile(child);
+                patch(fragment.exits, next.start);
+                fragment.exits = next.exits;
+            }
+            if (term.max == -1) {
+                const Fragment body = compile(child);
+                Node split(Node::Split);
+                split.out = body.start;
+                const int loop = addNode(split);
+                patch(body.exits, loop);
+                patch(fragment.exits, loop);
+                fragment.exits.clear();
+                fragment.exits.append(loop * 2 + 1);
+            } else {
+                for (int i = term.min; i < term.max && ! m_error; ++i) {
+                    const Fragment body = compile(child);
+                    Node split(Node::Split);
+                    split.out = body.start;
+                    const int optional = addNode(split);
+                    patch(fragment.exits, optional);
+                    fragment.exits = body.exits;
+                    fragment.exits.append(optional * 2 + 1);
+                }
+            }
+            return fragment;
+        }
+
+        default: {
+            Node assertion(Node::Assertion);
+            assertion.assertion = term.kind;
+            return single(addNode(assertion));
+        }
+        }
+    }
+
+    Fragment compileChars(const Term &term)
+    {
+        Fragment fragment;
+
+        int ascii = -1;
+        if (term.ascii.count())
+            ascii = addBytes(term.ascii);
+
+        if (! term.nonAscii) {
+            if (ascii == -1) // matches nothing
+                ascii = addBytes(ByteSet());
+            return single(ascii);
+        }
+
+        // a lead byte followed by any number of continuation bytes
+        ByteSet leadBytes, continuationBytes;
+        leadBytes.addRange(0xc0, 0xff);
+        continuationBytes.addRange(0x80, 0xbf);
+
+        const int lead = addBytes(leadBytes);
+        const int continuation = addBytes(continuationBytes);
+        const int loop = addNode(Node(Node::Split));
+        m_nodes[lead].out = loop;
+        m_nodes[loop].out = continuation;
+        m_nodes[continuation].out = loop;
+
+        fragment.exits.append(loop * 2 + 1);
+        if (ascii == -1) {
+            fragment.start = lead;
+        } else {
+            Node split(Node::Split);
+            split.out = ascii;
+            split.out1 = lead;
+            fragment.start = addNode(split);
+            fragment.exits.append(ascii * 2);
+        }
+        return fragment;
+    }
+
+    // Returns the longest run of single characters the root term requires.
+    QByteArray literal(int root, bool caseInsensitive) const
+    {
+        QVector<int> items;
+        if (m_terms.at(root).kind == Term::Concatenation)
+            items = m_terms.at(root).children;
+        else
+            items.append(root);
+
+        QByteArray longest, current;
+        foreach (int item, items) {
+            const Term &term = m_terms.at(item);
+            int c = -1;
+            if (term.kind == Term::Chars && ! term.nonAscii) {
+                const int count = term.ascii.count();
+                for (int i = 0x80 - 1; i >= 0; --i) {
+                    if (term.ascii.contains(i)) {
+                        c = i;
+                        break;
+                    }
+                }
+                const bool letter = caseInsensitive && c >= 'a' && c <= 'z'
+                        && term.ascii.contains(c - 'a' + 'A');
+                if (count != 1 && ! (count == 2 && letter))
+                    c = -1;
+            }
+
+            if (c != -1) {
+                current.append(char(c));
+                if (current.size() > longest.size())
+                    longest = current;
+            } else {
+                current.clear();
+            }
+        }
+        return longest;
+    }
+
+    QVector<Term> m_terms;
+    QVector<Node> m_nodes;
+    QVector<ByteSet> m_sets;
+    QByteArray m_literal;
+    int m_start;
+    bool m_error;
+};
+
+// A lazily built DFA over a ByteRegExpProgram. Each state is the set of
+// NFA nodes reached by the input so far, together with what is needed to
+// evaluate the assertions: whether the previous byte was part of a word
+// and whether the input is at the start of the line. Assertions also
+// depend on the next byte, so the epsilon closure is only taken when the
+// next byte is known.
+class ByteRegExpDfa
+{
+public:
+    ByteRegExpDfa(const ByteRegExpProgram *program, bool unanchored)
+        : m_program(program), m_unanchored(unanchored), m_generation(0), m_flushes(0)
+    {
+        m_marks.resize(program->nodeCount());
+    }
+
+    int startState(bool previousIsWord, bool atLineStart)
+    {
+        QVector<int> kernel;
+        kernel.append(m_program->start());
+        return state(kernel, previousIsWord, atLineStart);
+    }
+
+    // Consumes the byte c in state. *matched tells whether a match ends
+    // before c.
+    int step(int state, uchar c, bool *matched)
+    {
+        const int cached = m_transitions.at(state * 256 + c);
+        if (cached != Unknown) {
+            *matched = m_matchesBefore.at(state * 256 + c);
+            return cached;
+        }
+
+        const State current = m_states.at(state);
+        QVector<int> bytes;
+        *matched = closure(current, c, &bytes);
+
+        QVector<int> kernel;
+        foreach (int index, bytes) {
+            const Node &node = m_program->node(index);
+            if (m_program->set(node.set).contains(c))
+                kernel.append(node.out);
+        }
+        if (m_unanchored)
+            kernel.append(m_program->start());
+
+        const int flushes = m_flushes;
+        const int next = kernel.isEmpty() ? Dead : this->state(kernel, isWordByte(c), false);
+        if (flushes == m_flushes) {
+            m_transitions[state * 256 + c] = next;
+            m_matchesBefore[state * 256 + c] = *matched;
+        }
+        return next;
+    }
+
+    bool matchesAtEnd(int state)
+    {
+        int &cached = m_states[state].matchesAtEnd;
+        if (cached == Unknown) {
+            QVector<int> bytes;
+            cached = closure(m_states.at(state), EndOfLine, &bytes);
+        }
+        return cached;
+    }
+
+private:
+    struct State
+    {
+        QVector<int> kernel;
+        bool previousIsWord;
+        bool atLineStart;
+        int matchesAtEnd;
+    };
+
+    int state(QVector<int> kernel, bool previousIsWord, bool atLineStart)
+    {
+        qSort(kernel.begin(), kernel.end());
+        kernel.erase(std::unique(kernel.begin(), kernel.end()), kernel.end());
+
+        QByteArray key(reinterpret_cast<const char *>(kernel.constData()), kernel.size() * sizeof(int));
+        key.append(char(previousIsWord | (atLineStart << 1)));
+
+        const int existing = m_stateIds.value(key, -1);
+        if (existing != -1)
+            return existing;
+
+        if (m_states.size() >= MaxStates) {
+            m_states.clear();
+            m_stateIds.clear();
+            m_transitions.clear();
+            m_matchesBefore.clear();
+            ++m_flushes;
+        }
+
+        State state;
+        state.kernel = kernel;
+        state.previousIsWord = previousIsWord;
+        state.atLineStart = atLineStart;
+        state.matchesAtEnd = Unknown;
+        m_states.append(state);
+        m_transitions.resize(m_states.size() * 256);
+        m_matchesBefore.resize(m_states.size() * 256);
+        for (int i = m_transitions.size() - 256; i < m_transitions.size(); ++i)
+            m_transitions[i] = Unknown;
+
+        m_stateIds.insert(key, m_states.size() - 1);
+        return m_states.size() - 1;
+    }
+
+    // Follows the epsilon transitions from state when the next byte is
+    // next, and collects the nodes consuming bytes. Returns whether the
+    // match node was reached.
+    bool closure(const State &state, int next, QVector<int> *bytes)
+    {
+        ++m_generation;
+        bool matched = false;
+        const bool nextIsWord = next != EndOfLine && isWordByte(next);
+
+        QVector<int> stack = state.kernel;
+        while (! stack.isEmpty()) {
+            const int index = stack.last();
+            stack.pop_back();
+            if (index == -1 || m_marks.at(index) == m_generation)
+                continue;
+            m_marks[index] = m_generation;
+
+            const Node &node = m_program->node(index);
+            switch (node.kind) {
+            case Node::Bytes:
+                bytes->append(index);
+                break;
+            case Node::Match:
+                matched = true;
+                break;
+            case Node::Jump:
+                stack.append(node.out);
+                break;
+            case Node::Split:
+                stack.append(node.out1);
+                stack.append(node.out);
+                break;
+            case Node::Assertion: {
+                bool holds = false;
+                if (node.assertion == Term::LineStart)
+                    holds = state.atLineStart;
+                else if (node.assertion == Term::LineEnd)
+                    holds = next == EndOfLine;
+                else if (node.assertion == Term::WordBoundary)
+                    holds = state.previousIsWord != nextIsWord;
+                else if (node.assertion == Term::NotWordBoundary)
+                    holds = state.previousIsWord == nextIsWord;
+                if (holds)
+                    stack.append(node.out);
+                break;
+            }
+            }
+        }
+        return matched;
+    }
+
+    const ByteRegExpProgram *m_program;
+    bool m_unanchored;
+    QVector<State> m_states;
+    QHash<QByteArray, int> m_stateIds;
+    QVector<int> m_transitions;
+    QVector<bool> m_matchesBefore;
+    QVector<int> m_marks;
+    int m_generation;
+    int m_flushes;
+};
+
+} // namespace Utils
+} // namespace Core
+
+ByteRegExp::ByteRegExp(const QString &pattern, Qt::CaseSensitivity cs)
+    : m_program(new ByteRegExpProgram(pattern, cs)),
+      m_anchored(new ByteRegExpDfa(m_program.data(), false)),
+      m_unanchored(new ByteRegExpDfa(m_program.data(), true))
+{
+}
+
+ByteRegExp::ByteRegExp(const ByteRegExp &other)
+    : m_program(other.m_program),
+      m_anchored(new ByteRegExpDfa(m_program.data(), false)),
+      m_unanchored(new ByteRegExpDfa(m_program.data(), true))
+{
+}
+
+ByteRegExp::~ByteRegExp()
+{
+    delete m_anchored;
+    delete m_unanchored;
+}
+
+bool ByteRegExp::isValid() const
+{
+    return m_program->isValid();
+}
+
+QByteArray ByteRegExp::requiredLiteral() const
+{
+    return m_program->requiredLiteral();
+}
+
+int ByteRegExp::indexIn(const char *line, int size, int from, int *matchedLength)
+{
+    if (! isValid() || from > size)
+        return -1;
+
+    const uchar *data = reinterpret_cast<const uchar *>(line);
+    bool matched;
+
+    // Find where the earliest ending match ends. The leftmost match
+    // cannot start after that.
+    int end = -1;
+    int state = m_unanchored->startState(from > 0 && isWordByte(data[from - 1]), from == 0);
+    for (int i = from; i < size; ++i) {
+        state = m_unanchored->step(state, data[i], &matched);
+        if (matched) {
+            end = i;
+            break;
+        }
+    }
+    if (end == -1) {
+        if (! m_unanchored->matchesAtEnd(state))
+            return -1;
+        end = size;
+    }
+
+    for (int start = from; start <= end; ++start) {
+        int longest = -1;
+        state = m_anchored->startState(start > 0 && isWordByte(data[start - 1]), start == 0);
+        int i = start;
+        for (; i < size && state != Dead; ++i) {
+            state = m_anchored->step(state, data[i], &matched);
+            if (matched)
+                longest = i - start;
+        }
+        if (i == size && state != Dead && m_anchored->matchesAtEnd(state))
+            longest = size - start;
+
+        if (longest != -1) {
+            *matchedLength = longest;
+            return start;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#ifndef BYTEREGEXP_H
+#define BYTEREGEXP_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+
+namespace Core {
+namespace Utils {
+
+class ByteRegExpProgram;
+class ByteRegExpDfa;
+
+/* ByteRegExp: Matches the QRegExp syntax subset that does not need
+ * backtracking directly on UTF-8 encoded lines.
+ *
+ * The pattern is compiled once to an NFA, which is turned lazily into
+ * DFAs while matching. Matches are leftmost-longest. Patterns with
+ * backreferences, lookaheads or non-ASCII characters are not supported;
+ * isValid() returns false for those and the caller has to use QRegExp.
+ *
+ * Copies share the compiled pattern but not the DFA caches, so each
+ * thread has to use its own copy. */
+
+class ByteRegExp
+{
+public:
+    ByteRegExp(const QString &pattern, Qt::CaseSensitivity cs);
+    ByteRegExp(const ByteRegExp &other);
+    ~ByteRegExp();
+
+    bool isValid() const;
+
+    // A literal every match contains, to be found with a faster search.
+    QByteArray requiredLiteral() const;
+
+    // Returns the start of the leftmost match in line at or after from,
+    // or -1. The length of the match is stored in matchedLength.
+    int indexIn(const char *line, int size, int from, int *matchedLength);
+
+private:
+    ByteRegExp &operator=(const ByteRegExp &other);
+
+    QSharedPointer<ByteRegExpProgram> m_program;
+    ByteRegExpDfa *m_anchored;
+    ByteRegExpDfa *m_unanchored;
+};
+
+} // namespace Utils
+} // namespace Core
+
+#endif // BYTEREGEXP_H
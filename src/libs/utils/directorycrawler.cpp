@@ -0,0 +1,646 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "directorycrawler.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+#include <QtCore/QRegExp>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#ifdef Q_OS_WIN
+#  include <QtCore/QDateTime>
+#else
+#  include <dirent.h>
+#  include <errno.h>
+#  include <sys/stat.h>
+#  include <sys/types.h>
+#  include <time.h>
+#  include <unistd.h>
+#endif
+
+using namespace Core::Utils;
+
+namespace {
+
+enum { MaxCrawlerThreads = 8 };
+
+// The entries of one directory, as of its modification time.
+struct DirectoryEntries
+{
+    DirectoryEntries() : modificationTime(-1) {}
+
+    qint64 modificationTime; // -1 if the entries must not be reused
+    QStringList files;
+    QStringList subDirectories;
+    QStringList linkedDirectories; // symbolic links to directories
+};
+
+typedef QHash<QString, DirectoryEntries> DirectoryCache;
+
+#ifdef Q_OS_WIN
+typedef QString DirectoryId; // the canonical path
+#else
+typedef QPair<quint64, quint64> DirectoryId; // device and inode
+#endif
+
+static inline QString joinPath(const QString &directory, const QString &name)
+{
+    if (directory.endsWith(QLatin1Char('/')))
+        return directory + name;
+    return directory + QLatin1Char('/') + name;
+}
+
+// Identifies the directory at path and returns its modification time,
+// false if it is not a directory.
+static bool statDirectory(const QString &path, DirectoryId *id, qint64 *modificationTime)
+{
+#ifdef Q_OS_WIN
+    const QFileInfo info(path);
+    if (!info.isDir())
+        return false;
+    *id = info.canonicalFilePath();
+    *modificationTime = info.lastModified().toTime_t();
+    return true;
+#else
+    struct stat st;
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0 || !S_ISDIR(st.st_mode))
+        return false;
+    *id = DirectoryId(st.st_dev, st.st_ino);
+    *modificationTime = st.st_mtime;
+    return true;
+#endif
+}
+
+#ifndef Q_OS_WIN
+static bool isReadable(const QString &directory, const char *name)
+{
+    const QByteArray fileName = QFile::encodeName(joinPath(directory, QFile::decodeName(name)));
+    return ::access(fileName.constData(), R_OK) == 0;
+}
+#endif
+
+// Reads the files and sub directories of path. Links are followed, links to
+// directories are kept apart; entries that are neither files nor directories
+// are left out, so are files that cannot be read if readableOnly is set.
+// Returns false if the directory could not be read.
+static bool readDirectory(const QString &path, bool includeHidden, bool readableOnly,
+                          DirectoryEntries *entries)
+{
+#ifdef Q_OS_WIN
+    const QDir dir(path);
+    if (!dir.isReadable())
+        return false;
+
+    QDir::Filters filters = QDir::AllEntries | QDir::NoDotAndDotDot | QDir::System;
+    if (includeHidden)
+        filters |= QDir::Hidden;
+    foreach (const QFileInfo &info, dir.entryInfoList(filters, QDir::Unsorted)) {
+        if (info.isDir() && info.isSymLink())
+            entries->linkedDirectories.append(info.fileName());
+        else if (info.isDir())
+            entries->subDirectories.append(info.fileName());
+        else if (info.isFile() && (!readableOnly || info.isReadable()))
+            entries->files.append(info.fileName());
+    }
+    return true;
+#else
+    DIR *dir = ::opendir(QFile::encodeName(path).constData());
+    if (!dir)
+        return false;
+
+    // readdir() tells the end of the directory from an error by errno only.
+    for (errno = 0; struct dirent *entry = ::readdir(dir); errno = 0) {
+        const char *name = entry->d_name;
+        if (name[0] == '.') {
+            if (!includeHidden)
+                continue;
+            if (name[1] == 0 || (name[1] == '.' && name[2] == 0))
+                continue;
+        }
+
+        bool isDirectory = false;
+        bool isLink = false;
+        bool isFile = false;
+#  ifdef DT_DIR
+        // The type is known without a stat for most file systems.
+        if (entry->d_type == DT_DIR) {
+            isDirectory = true;
+        } else if (entry->d_type == DT_REG) {
+            isFile = true;
+        } else if (entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN)
+#  endif
+        {
+            const QByteArray fileName = QFile::encodeName(joinPath(path, QFile::decodeName(name)));
+            struct stat st;
+            if (::lstat(fileName.constData(), &st) != 0)
+                continue;
+            if (S_ISLNK(st.st_mode)) {
+                isLink = true;
+                if (::stat(fileName.constData(), &st) != 0)
+                    continue;
+            }
+            isDirectory = S_ISDIR(st.st_mode);
+            isFile = S_ISREG(st.st_mode);
+        }
+
+        if (isDirectory && isLink)
+            entries->linkedDirectories.append(QFile::decodeName(name));
+        else if (isDirectory)
+            entries->subDirectories.append(QFile::decodeName(name));
+        else if (isFile && (!readableOnly || isReadable(path, name)))
+            entries->files.append(QFile::decodeName(name));
+    }
+
+    const bool ok = (errno == 0);
+    ::closedir(dir);
+    return ok;
+#endif
+}
+
+static qint64 currentTime()
+{
+#ifdef Q_OS_WIN
+    return QDateTime::currentDateTime().toTime_t();
+#else
+    return ::time(0);
+#endif
+}
+
+// One crawl: every thread works off its own queue of directories and
+// steals from the others when it runs dry. A directory is pending from the
+// time it is queued until it is read and its sub directories are queued,
+// the crawl is over when nothing is pending. Linked directories are only
+// collected; they are crawled in a later round, so a directory that is also
+// reachable without links is always found under its real path.
+//
+// Every directory carries a share of the future's progress range. It keeps
+// a part for itself and hands the rest on to its sub directories, the way
+// the locator used to report progress.
+class Crawl
+{
+public:
+    Crawl(const DirectoryCrawlerPrivate *d, int threadCount, QFutureInterfaceBase *future);
+    ~Crawl();
+
+    void queue(int thread, const QString &path, double progress);
+    void work(int thread);
+    bool isCanceled() const;
+    QStringList takeLinkedDirectories();
+    double progressRange() const;
+
+    QStringList files() const;
+    DirectoryCache cache() const;
+
+private:
+    struct Task
+    {
+        QString path;
+        double progress;
+    };
+
+    bool take(int thread, Task *task);
+    void crawlDirectory(int thread, const Task &task);
+    void addProgress(double progress);
+
+    struct Worker
+    {
+        QMutex mutex;
+        QList<Task> queue;
+        QList<QRegExp> nameFilters;
+        QStringList files;
+        DirectoryCache cache;
+    };
+
+    const DirectoryCache &m_oldCache;
+    const QSet<QString> &m_ignoredDirectories;
+    const bool m_includeHidden;
+    const bool m_readableOnly;
+    QFutureInterfaceBase *m_future;
+
+    // Directories modified after this are read again the next time, they
+    // may change once more within the resolution of their time stamp.
+    const qint64 m_settledTime;
+
+    QVector<Worker *> m_workers;
+    QAtomicInt m_pending;
+    QMutex m_idleMutex;
+    QWaitCondition m_idle;
+
+    QMutex m_visitedMutex;
+    QSet<DirectoryId> m_visited;
+    QStringList m_linkedDirectories;
+
+    QMutex m_progressMutex;
+    double m_progress;
+    int m_progressValue;
+};
+
+class CrawlRunnable : public QRunnable
+{
+public:
+    CrawlRunnable(Crawl *crawl, int thread, QSemaphore *finished)
+        : m_crawl(crawl), m_thread(thread), m_finished(finished) {}
+
+    void run()
+    {
+        m_crawl->work(m_thread);
+        m_finished->release();
+    }
+
+private:
+    Crawl *m_crawl;
+    int m_thread;
+    QSemaphore *m_finished;
+};
+
+// The helper threads of all crawlers. They outlive the crawls, so that a
+// crawl does not pay for starting threads; the calling thread of a crawl
+// always works, too.
+class CrawlerThreadPool : public QThreadPool
+{
+public:
+    CrawlerThreadPool() { setMaxThreadCount(MaxCrawlerThreads - 1); }
+};
+
+Q_GLOBAL_STATIC(CrawlerThreadPool, crawlerThreadPool)
+
+} // anonymous namespace
+
+namespace Core {
+namespace Utils {
+
+struct DirectoryCrawlerPrivate
+{
+    DirectoryCrawlerPrivate() : includeHidden(true), readableOnly(false) {}
+
+    // Held by crawls, they read the settings and replace the cache.
+    QMutex mutex;
+    QStringList nameFilters;
+    QSet<QString> ignoredDirectories;
+    bool includeHidden;
+    bool readableOnly;
+
+    DirectoryCache cache; // by path
+};
+
+} // namespace Utils
+} // namespace Core
+
+Crawl::Crawl(const DirectoryCrawlerPrivate *d, int threadCount, QFutureInterfaceBase *future)
+    : m_oldCache(d->cache),
+      m_ignoredDirectories(d->ignoredDirectories),
+      m_includeHidden(d->includeHidden),
+      m_readableOnly(d->readableOnly),
+      m_future(future),
+      m_settledTime(currentTime() - 1),
+      m_pending(0),
+      m_progress(0),
+      m_progressValue(future ? future->progressMinimum() : 0)
+{
+    QList<QRegExp> nameFilters;
+    foreach (const QString &nameFilter, d->nameFilters) {
+        const QString pattern = nameFilter.trimmed();
+        if (!pattern.isEmpty())
+            nameFilters.append(QRegExp(pattern, Qt::CaseInsensitive, QRegExp::Wildcard));
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        Worker *worker = new Worker;
+        // QRegExp keeps its match state, every thread needs its own copies.
+        foreach (const QRegExp &nameFilter, nameFilters)
+            worker->nameFilters.append(QRegExp(nameFilter.pattern(), Qt::CaseInsensitive,
+                                               QRegExp::Wildcard));
+        m_workers.append(worker);
+    }
+}
+
+Crawl::~Crawl()
+{
+    qDeleteAll(m_workers);
+}
+
+void Crawl::queue(int thread, const QString &path, double progress)
+{
+    Task task;
+    task.path = path;
+    task.progress = progress;
+
+    m_pending.ref();
+    Worker *worker = m_workers.at(thread);
+    QMutexLocker locker(&worker->mutex);
+    worker->queue.append(task);
+}
+
+bool Crawl::take(int thread, Task *task)
+{
+    // Own work is taken depth first, stolen work from the other end of the
+    // queue, which holds the directories closer to the roots.
+    Worker *own = m_workers.at(thread);
+    {
+        QMutexLocker locker(&own->mutex);
+        if (!own->queue.isEmpty()) {
+            *task = own->queue.takeLast();
+            return true;
+        }
+    }
+
+    for (int i = 1; i < m_workers.size(); ++i) {
+        Worker *victim = m_workers.at((thread + i) % m_workers.size());
+        QMutexLocker locker(&victim->mutex);
+        if (!victim->queue.isEmpty()) {
+            *task = victim->queue.takeFirst();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Crawl::isCanceled() const
+{
+    return m_future && m_future->isCanceled();
+}
+
+double Crawl::progressRange() const
+{
+    if (!m_future)
+        return 0;
+    return m_future->progressMaximum() - m_future->progressMinimum();
+}
+
+void Crawl::addProgress(double progress)
+{
+    if (!m_future || progress <= 0)
+        return;
+
+    QMutexLocker locker(&m_progressMutex);
+    m_progress += progress;
+    const int value = m_future->progressMinimum() + int(m_progress);
+    if (value > m_progressValue) {
+        m_progressValue = value;
+        m_future->setProgressValue(value);
+    }
+}
+
+void Crawl::work(int thread)
+{
+    Task task;
+    while (!isCanceled()) {
+        if (!take(thread, &task)) {
+            QMutexLocker locker(&m_idleMutex);
+            if (m_pending == 0)
+                break;
+            m_idle.wait(&m_idleMutex, 10);
+            continue;
+        }
+
+        crawlDirectory(thread, task);
+
+        if (!m_pending.deref()) {
+            QMutexLocker locker(&m_idleMutex);
+            m_idle.wakeAll();
+        }
+    }
+}
+
+void Crawl::crawlDirectory(int thread, const Task &task)
+{
+    const QString &path = task.path;
+
+    DirectoryId id;
+    qint64 modificationTime;
+    if (!statDirectory(path, &id, &modificationTime)) {
+        addProgress(task.progress);
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_visitedMutex);
+        if (m_visited.contains(id)) {
+            addProgress(task.progress);
+            return;
+        }
+        m_visited.insert(id);
+    }
+
+    DirectoryEntries entries;
+    const DirectoryCache::const_iterator cached = m_oldCache.constFind(path);
+    if (cached != m_oldCache.constEnd() && cached.value().modificationTime != -1
+            && cached.value().modificationTime == modificationTime) {
+        entries = cached.value();
+    } else {
+        // entries that could not be read completely are read again next time.
+        if (readDirectory(path, m_includeHidden, m_readableOnly, &entries)
+                && modificationTime < m_settledTime)
+            entries.modificationTime = modificationTime;
+    }
+
+    Worker *worker = m_workers.at(thread);
+    worker->cache.insert(path, entries);
+
+    foreach (const QString &file, entries.files) {
+        bool matches = worker->nameFilters.isEmpty();
+        for (int i = 0; !matches && i < worker->nameFilters.size(); ++i)
+            matches = worker->nameFilters[i].exactMatch(file);
+        if (matches)
+            worker->files.append(joinPath(path, file));
+    }
+
+    QStringList subDirectories;
+    foreach (const QString &subDirectory, entries.subDirectories) {
+        if (!m_ignoredDirectories.contains(subDirectory))
+            subDirectories.append(subDirectory);
+    }
+
+    // the directory keeps as much of its progress as each sub directory gets.
+    const double progress = task.progress / (subDirectories.size() + 1);
+    addProgress(progress);
+    foreach (const QString &subDirectory, subDirectories)
+        queue(thread, joinPath(path, subDirectory), progress);
+    const bool queued = !subDirectories.isEmpty();
+
+    if (!entries.linkedDirectories.isEmpty()) {
+        QMutexLocker locker(&m_visitedMutex);
+        foreach (const QString &linkedDirectory, entries.linkedDirectories) {
+            if (!m_ignoredDirectories.contains(linkedDirectory))
+                m_linkedDirectories.append(joinPath(path, linkedDirectory));
+        }
+    }
+
+    if (queued && m_workers.size() > 1) {
+        QMutexLocker locker(&m_idleMutex);
+        m_idle.wakeAll();
+    }
+}
+
+QStringList Crawl::takeLinkedDirectories()
+{
+    QMutexLocker locker(&m_visitedMutex);
+    QStringList linkedDirectories = m_linkedDirectories;
+    m_linkedDirectories.clear();
+    // The order decides which of several links to a directory wins.
+    linkedDirectories.sort();
+    return linkedDirectories;
+}
+
+QStringList Crawl::files() const
+{
+    QStringList files;
+    foreach (const Worker *worker, m_workers)
+        files += worker->files;
+    return files;
+}
+
+DirectoryCache Crawl::cache() const
+{
+    DirectoryCache cache;
+    foreach (const Worker *worker, m_workers) {
+        DirectoryCache::const_iterator it = worker->cache.constBegin();
+        for (; it != worker->cache.constEnd(); ++it)
+            cache.insert(it.key(), it.value());
+    }
+    return cache;
+}
+
+// ----------- DirectoryCrawler
+
+DirectoryCrawler::DirectoryCrawler()
+    : m_d(new DirectoryCrawlerPrivate)
+{
+}
+
+DirectoryCrawler::~DirectoryCrawler()
+{
+    delete m_d;
+}
+
+void DirectoryCrawler::setNameFilters(const QStringList &nameFilters)
+{
+    QMutexLocker locker(&m_d->mutex);
+    m_d->nameFilters = nameFilters;
+}
+
+void DirectoryCrawler::setIgnoredDirectories(const QStringList &names)
+{
+    QMutexLocker locker(&m_d->mutex);
+    m_d->ignoredDirectories = names.toSet();
+}
+
+QStringList DirectoryCrawler::defaultIgnoredDirectories()
+{
+    return QStringList() << QLatin1String(".git") << QLatin1String(".svn")
+                         << QLatin1String(".hg") << QLatin1String("CVS");
+}
+
+void DirectoryCrawler::setIncludeHidden(bool includeHidden)
+{
+    QMutexLocker locker(&m_d->mutex);
+    if (m_d->includeHidden != includeHidden) {
+        m_d->includeHidden = includeHidden;
+        m_d->cache.clear(); // the entries depend on it
+    }
+}
+
+void DirectoryCrawler::setReadableOnly(bool readableOnly)
+{
+    QMutexLocker locker(&m_d->mutex);
+    if (m_d->readableOnly != readableOnly) {
+        m_d->readableOnly = readableOnly;
+        m_d->cache.clear(); // the entries depend on it
+    }
+}
+
+QStringList DirectoryCrawler::files(const QStringList &directories, QFutureInterfaceBase *future)
+{
+    QMutexLocker locker(&m_d->mutex);
+
+    const int threadCount = qBound(1, QThread::idealThreadCount(), int(MaxCrawlerThreads));
+    Crawl crawl(m_d, threadCount, future);
+
+    QStringList roots;
+    foreach (const QString &directory, directories) {
+        if (!directory.isEmpty())
+            roots.append(QDir::cleanPath(QDir(directory).absolutePath()));
+    }
+
+    // Each round crawls the directories linked to in the previous one. The
+    // progress is shared out in the first round, linked directories were
+    // mostly seen already.
+    double progress = roots.isEmpty() ? 0 : crawl.progressRange() / roots.size();
+    while (!roots.isEmpty() && !crawl.isCanceled()) {
+        for (int i = 0; i < roots.size(); ++i)
+            crawl.queue(i % threadCount, roots.at(i), progress);
+        progress = 0;
+
+        // Only idle helpers are taken, other crawls may be using the pool.
+        // The queues of workers that did not start are stolen from.
+        QSemaphore finished;
+        int started = 0;
+        for (int i = 1; i < threadCount; ++i) {
+            CrawlRunnable *runnable = new CrawlRunnable(&crawl, i, &finished);
+            if (!crawlerThreadPool()->tryStart(runnable)) {
+                delete runnable;
+                break;
+            }
+            ++started;
+        }
+        crawl.work(0);
+        finished.acquire(started);
+
+        roots = crawl.takeLinkedDirectories();
+    }
+
+    if (!crawl.isCanceled()) {
+        m_d->cache = crawl.cache();
+        // the shares of the progress need not add up exactly.
+        if (future)
+            future->setProgressValue(future->progressMaximum());
+    }
+
+    // the order the threads found the files in changes from run to run.
+    QStringList files = crawl.files();
+    files.sort();
+    return files;
+}
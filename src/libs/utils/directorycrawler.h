@@ -0,0 +1,97 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#ifndef DIRECTORYCRAWLER_H
+#define DIRECTORYCRAWLER_H
+
+#include "utils_global.h"
+
+#include <QtCore/QStringList>
+
+QT_BEGIN_NAMESPACE
+class QFutureInterfaceBase;
+QT_END_NAMESPACE
+
+namespace Core {
+namespace Utils {
+
+struct DirectoryCrawlerPrivate;
+
+/* DirectoryCrawler: Collects the files below a set of directories.
+ *
+ * Directories are read in parallel by several threads, which take work
+ * from each other when they run out. Every directory is entered once,
+ * no matter how many symbolic links lead to it, so link cycles end the
+ * walk. The entries of each directory are remembered together with its
+ * modification time; later crawls only read the directories that have
+ * changed since.
+ *
+ * The files are returned sorted. All functions are thread safe, crawls
+ * of the same crawler run one after the other. The threads are taken from
+ * a pool shared by all crawlers. */
+
+class QWORKBENCH_UTILS_EXPORT DirectoryCrawler
+{
+public:
+    DirectoryCrawler();
+    ~DirectoryCrawler();
+
+    // Wildcard patterns the file names have to match, case insensitively.
+    // All files are returned if there are none.
+    void setNameFilters(const QStringList &nameFilters);
+
+    // Names of directories that are never entered.
+    void setIgnoredDirectories(const QStringList &names);
+    static QStringList defaultIgnoredDirectories();
+
+    void setIncludeHidden(bool includeHidden);
+
+    // Leaves out the files the user may not read. Their permissions are
+    // checked when their directory is read, they are cached along with it.
+    void setReadableOnly(bool readableOnly);
+
+    // Returns the files below directories. Reports its progress within
+    // the progress range of future and stops early, with a partial result,
+    // when future is canceled.
+    QStringList files(const QStringList &directories, QFutureInterfaceBase *future = 0);
+
+private:
+    Q_DISABLE_COPY(DirectoryCrawler)
+
+    DirectoryCrawlerPrivate *m_d;
+};
+
+} // namespace Utils
+} // namespace Core
+
+#endif // DIRECTORYCRAWLER_H
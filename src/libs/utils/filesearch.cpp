@@ -32,188 +32,552 @@
 ***************************************************************************/
 
 #include "filesearch.h"
+#include "byteregexp.h"
+#include "trigramindex.h"
 
 #include <QtCore/QFile>
 #include <QtCore/QDir>
 #include <QtCore/QFutureInterface>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
 #include <QtCore/QtConcurrentRun>
 #include <QtCore/QRegExp>
+#include <QtCore/QRunnable>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtGui/QApplication>
 
 #include <qtconcurrent/runextensions.h>
 
+#include <string.h>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
 using namespace Core::Utils;
 
 namespace {
 
-void runFileSearch(QFutureInterface<FileSearchResult> &future,
-                   QString searchTerm,
-                   QStringList files,
-                   QTextDocument::FindFlags flags)
+// Maps a file into memory, falling back to reading it for files that
+// cannot be mapped (empty files, pipes, ...).
+class MappedFile
 {
-    future.setProgressRange(0, files.size());
-    int numFilesSearched = 0;
-    int numMatches = 0;
+public:
+    MappedFile(const QString &fileName)
+        : m_file(fileName), m_data(0), m_size(0)
+    {
+        if (! m_file.open(QIODevice::ReadOnly))
+            return;
 
-    bool caseInsensitive = !(flags & QTextDocument::FindCaseSensitively);
-    bool wholeWord = (flags & QTextDocument::FindWholeWords);
+        m_size = m_file.size();
+        if (m_size > 0)
+            m_data = reinterpret_cast<const char *>(m_file.map(0, m_size));
 
-    QByteArray sa = searchTerm.toUtf8();
-    int scMaxIndex = sa.length()-1;
-    const char *sc = sa.constData();
+        if (! m_data) {
+            m_contents = m_file.readAll();
+            m_data = m_contents.constData();
+            m_size = m_contents.size();
+        }
+    }
 
-    QByteArray sal = searchTerm.toLower().toUtf8();
-    const char *scl = sal.constData();
+    bool isOpen() const
+    { return m_file.isOpen(); }
 
-    QByteArray sau = searchTerm.toUpper().toUtf8();
-    const char *scu = sau.constData();
+    const char *data() const
+    { return m_data; }
 
-    int chunkSize = qMax(100000, sa.length());
+    qint64 size() const
+    { return m_size; }
 
-    foreach (QString s, files) {
-        if (future.isPaused())
-            future.waitForResume();
-        if (future.isCanceled()) {
-            future.setProgressValueAndText(numFilesSearched,
-                                           qApp->translate("FileSearch", "%1: canceled. %2 occurrences found in %3 files.").
-                                           arg(searchTerm).arg(numMatches).arg(numFilesSearched));
-            break;
+private:
+    QFile m_file;
+    QByteArray m_contents;
+    const char *m_data;
+    qint64 m_size;
+};
+
+static inline bool isWordCharacter(char c)
+{ return (c >= '0' && c <= '9') || c >= 'A'; }
+
+// Boyer-Moore-Horspool matcher on raw bytes. Case insensitive matching
+// folds ASCII letters only, like the search did before.
+class LiteralMatcher
+{
+public:
+    LiteralMatcher(const QByteArray &pattern, bool caseSensitive, bool wholeWord)
+        : m_pattern(pattern), m_caseSensitive(caseSensitive), m_wholeWord(wholeWord)
+    {
+        for (int i = 0; i < 256; ++i)
+            m_fold[i] = (! caseSensitive && i >= 'A' && i <= 'Z') ? i - 'A' + 'a' : i;
+
+        if (! caseSensitive) {
+            for (int i = 0; i < m_pattern.size(); ++i)
+                m_pattern[i] = fold(m_pattern.at(i));
         }
-        QFile file(s);
-        if (!file.open(QIODevice::ReadOnly))
-            continue;
-        int lineNr = 1;
-        const char *startOfLastLine = NULL;
-
-        bool firstChunk = true;
-        while (!file.atEnd()) {
-            if (!firstChunk)
-                file.seek(file.pos()-sa.length()+1);
-
-            const QByteArray chunk = file.read(chunkSize);
-            const char *chunkPtr = chunk.constData();
-            startOfLastLine = chunkPtr;
-            for (const char *regionPtr = chunkPtr; regionPtr < chunkPtr + chunk.length()-scMaxIndex; ++regionPtr) {
-                const char *regionEnd = regionPtr + scMaxIndex;
-
-                if (*regionPtr == '\n') {
-                    startOfLastLine = regionPtr + 1;
-                    ++lineNr;
-                }
-                else if (
-                        // case sensitive
-                        (!caseInsensitive && *regionPtr == sc[0] && *regionEnd == sc[scMaxIndex])
-                        ||
-                        // case insensitive
-                        (caseInsensitive && (*regionPtr == scl[0] || *regionPtr == scu[0])
-                        && (*regionEnd == scl[scMaxIndex] || *regionEnd == scu[scMaxIndex]))
-                         ) {
-                    const char *afterRegion = regionEnd + 1;
-                    const char *beforeRegion = regionPtr - 1;
-                    bool equal = true;
-                    if (wholeWord &&
-                        ( ((*beforeRegion >= '0' && *beforeRegion <= '9') || *beforeRegion >= 'A')
-                        || ((*afterRegion >= '0' && *afterRegion <= '9') || *afterRegion >= 'A')))
-                    {
-                        equal = false;
-                    }
-
-                    int regionIndex = 1;
-                    for (const char *regionCursor = regionPtr + 1; regionCursor < regionEnd; ++regionCursor, ++regionIndex) {
-                        if (  // case sensitive
-                              (!caseInsensitive && equal && *regionCursor != sc[regionIndex])
-                              ||
-                              // case insensitive
-                              (caseInsensitive && equal && *regionCursor != sc[regionIndex] && *regionCursor != scl[regionIndex] && *regionCursor != scu[regionIndex])
-                               ) {
-                         equal = false;
-                        }
-                    }
-                    if (equal) {
-                        int textLength = chunk.length() - (startOfLastLine - chunkPtr);
-                        if (textLength > 0) {
-                            QByteArray res;
-                            res.reserve(256);
-                            int i = 0;
-                            int n = 0;
-                            while (startOfLastLine[i] != '\n' && startOfLastLine[i] != '\r' && i < textLength && n++ < 256)
-                                res.append(startOfLastLine[i++]);
-                            future.reportResult(FileSearchResult(QDir::toNativeSeparators(s), lineNr, QString(res),
-                                                          regionPtr - startOfLastLine, sa.length()));
-                            ++numMatches;
-                        }
-                    }
-                }
+
+        const int length = m_pattern.size();
+        for (int i = 0; i < 256; ++i)
+            m_skip[i] = length;
+        for (int i = 0; i < length - 1; ++i) {
+            const uchar c = m_pattern.at(i);
+            m_skip[c] = length - 1 - i;
+            if (! caseSensitive && c >= 'a' && c <= 'z')
+                m_skip[c - 'a' + 'A'] = length - 1 - i;
+        }
+    }
+
+    int length() const
+    { return m_pattern.size(); }
+
+    // Returns the offset of the next match at or after from, or -1.
+    qint64 indexIn(const char *data, qint64 size, qint64 from) const
+    {
+        const int length = m_pattern.size();
+        if (! length)
+            return -1;
+
+        const char *pattern = m_pattern.constData();
+        const uchar last = pattern[length - 1];
+
+        qint64 pos = from;
+        while (pos + length <= size) {
+            if (m_caseSensitive)
+                pos = prefilter(data, size, pos);
+            if (pos == -1)
+                return -1;
+
+            const uchar c = data[pos + length - 1];
+            if (fold(c) == last && matchesAt(data, pos)
+                    && (! m_wholeWord || isWholeWord(data, size, pos)))
+                return pos;
+
+            pos += m_skip[c];
+        }
+        return -1;
+    }
+
+private:
+    inline uchar fold(uchar c) const
+    { return m_fold[c]; }
+
+    bool matchesAt(const char *data, qint64 pos) const
+    {
+        const int length = m_pattern.size();
+        const char *pattern = m_pattern.constData();
+        if (m_caseSensitive)
+            return ! memcmp(data + pos, pattern, length);
+        for (int i = 0; i < length; ++i) {
+            if (fold(data[pos + i]) != uchar(pattern[i]))
+                return false;
+        }
+        return true;
+    }
+
+    bool isWholeWord(const char *data, qint64 size, qint64 pos) const
+    {
+        if (pos > 0 && isWordCharacter(data[pos - 1]))
+            return false;
+        const qint64 end = pos + m_pattern.size();
+        if (end < size && isWordCharacter(data[end]))
+            return false;
+        return true;
+    }
+
+    // Skips to the next position where both the first and the last byte
+    // of the pattern match. Returns -1 if there is none.
+    qint64 prefilter(const char *data, qint64 size, qint64 pos) const
+    {
+        const int length = m_pattern.size();
+        const char first = m_pattern.at(0);
+        const char last = m_pattern.at(length - 1);
+
+#if defined(__SSE2__)
+        const __m128i firstBlock = _mm_set1_epi8(first);
+        const __m128i lastBlock = _mm_set1_epi8(last);
+        while (pos + length - 1 + 16 <= size) {
+            const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+            const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos + length - 1));
+            const int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, firstBlock),
+                                                             _mm_cmpeq_epi8(blockLast, lastBlock)));
+            if (mask) {
+                int bit = 0;
+                while (! (mask & (1 << bit)))
+                    ++bit;
+                return pos + bit;
             }
-            firstChunk = false;
+            pos += 16;
         }
-        ++numFilesSearched;
-        future.setProgressValueAndText(numFilesSearched, qApp->translate("FileSearch", "%1: %2 occurrences found in %3 of %4 files.").
-                                arg(searchTerm).arg(numMatches).arg(numFilesSearched).arg(files.size()));
+#endif
+
+        while (pos + length <= size) {
+            const char *hit = reinterpret_cast<const char *>(memchr(data + pos, first, size - length + 1 - pos));
+            if (! hit)
+                return -1;
+            pos = hit - data;
+            if (data[pos + length - 1] == last)
+                return pos;
+            ++pos;
+        }
+        return -1;
     }
-    if (!future.isCanceled())
-        future.setProgressValueAndText(numFilesSearched, qApp->translate("FileSearch", "%1: %2 occurrences found in %3 files.").
-                                arg(searchTerm).arg(numMatches).arg(numFilesSearched));
-}
 
-void runFileSearchRegExp(QFutureInterface<FileSearchResult> &future,
-                   QString searchTerm,
-                   QStringList files,
-                   QTextDocument::FindFlags flags)
+    QByteArray m_pattern;
+    bool m_caseSensitive;
+    bool m_wholeWord;
+    uchar m_fold[256];
+    int m_skip[256];
+};
+
+// Counts the lines of a file up to increasing positions.
+class LineCounter
 {
-    future.setProgressRange(0, files.size());
-    int numFilesSearched = 0;
-    int numMatches = 0;
-    if (flags & QTextDocument::FindWholeWords)
-        searchTerm = QString("\\b%1\\b").arg(searchTerm);
-    Qt::CaseSensitivity caseSensitivity = (flags & QTextDocument::FindCaseSensitively) ? Qt::CaseSensitive : Qt::CaseInsensitive;
-    QRegExp expression(searchTerm, caseSensitivity);
-
-    foreach (QString s, files) {
-        if (future.isPaused())
-            future.waitForResume();
-        if (future.isCanceled()) {
-            future.setProgressValueAndText(numFilesSearched,
-                                           qApp->translate("FileSearch", "%1: canceled. %2 occurrences found in %3 files.").
-                                           arg(searchTerm).arg(numMatches).arg(numFilesSearched));
-            break;
+public:
+    LineCounter(const char *data)
+        : m_data(data), m_lineStart(0), m_lineNumber(1)
+    { }
+
+    // Returns the number of the line containing pos.
+    int lineAt(qint64 pos)
+    {
+        const char *nl;
+        while ((nl = reinterpret_cast<const char *>(memchr(m_data + m_lineStart, '\n', pos - m_lineStart)))) {
+            m_lineStart = nl - m_data + 1;
+            ++m_lineNumber;
+        }
+        return m_lineNumber;
+    }
+
+    // The start of the line last returned by lineAt().
+    qint64 lineStart() const
+    { return m_lineStart; }
+
+private:
+    const char *m_data;
+    qint64 m_lineStart;
+    int m_lineNumber;
+};
+
+// Searches the contents of one file. Each search thread uses its own copy.
+class FileMatcher
+{
+public:
+    virtual ~FileMatcher() {}
+
+    virtual FileMatcher *clone() const = 0;
+    virtual void search(const QString &fileName, const char *data, qint64 size,
+                        QVector<FileSearchResult> *results) = 0;
+};
+
+class LiteralFileMatcher : public FileMatcher
+{
+public:
+    LiteralFileMatcher(const LiteralMatcher &matcher)
+        : m_matcher(matcher)
+    { }
+
+    FileMatcher *clone() const
+    { return new LiteralFileMatcher(*this); }
+
+    void search(const QString &fileName, const char *data, qint64 size,
+                QVector<FileSearchResult> *results)
+    {
+        LineCounter lines(data);
+        qint64 pos = 0;
+        while ((pos = m_matcher.indexIn(data, size, pos)) != -1) {
+            const int lineNr = lines.lineAt(pos);
+            const qint64 lineStart = lines.lineStart();
+
+            qint64 lineEnd = lineStart;
+            while (lineEnd < size && lineEnd - lineStart < 256
+                   && data[lineEnd] != '\n' && data[lineEnd] != '\r')
+                ++lineEnd;
+
+            const QByteArray line(data + lineStart, lineEnd - lineStart);
+            results->append(FileSearchResult(fileName, lineNr, QString(line),
+                                             pos - lineStart, m_matcher.length()));
+            ++pos; // overlapping matches are reported, too
         }
-        QFile file(s);
-        if (!file.open(QIODevice::ReadOnly))
-            continue;
-        QTextStream stream(&file);
+    }
+
+private:
+    LiteralMatcher m_matcher;
+};
+
+// Matches regular expressions on the raw UTF-8 lines, only looking at the
+// lines that contain the literal part of the expression, if any.
+class RegExpFileMatcher : public FileMatcher
+{
+public:
+    RegExpFileMatcher(const ByteRegExp &regExp, Qt::CaseSensitivity caseSensitivity)
+        : m_regExp(regExp),
+          m_prefilter(regExp.requiredLiteral(), caseSensitivity == Qt::CaseSensitive, false)
+    { }
+
+    FileMatcher *clone() const
+    { return new RegExpFileMatcher(*this); }
+
+    void search(const QString &fileName, const char *data, qint64 size,
+                QVector<FileSearchResult> *results)
+    {
+        LineCounter lines(data);
+        qint64 pos = 0;
+        while (pos < size) {
+            qint64 lineStart = pos;
+            if (m_prefilter.length()) {
+                const qint64 hit = m_prefilter.indexIn(data, size, pos);
+                if (hit == -1)
+                    break;
+                lines.lineAt(hit);
+                lineStart = lines.lineStart();
+            }
+            const int lineNr = lines.lineAt(lineStart);
+
+            const char *nl = reinterpret_cast<const char *>(memchr(data + lineStart, '\n', size - lineStart));
+            const qint64 lineEnd = nl ? nl - data : size;
+            qint64 textEnd = lineEnd;
+            if (textEnd > lineStart && data[textEnd - 1] == '\r')
+                --textEnd;
+
+            searchLine(fileName, lineNr, data + lineStart, textEnd - lineStart, results);
+            pos = lineEnd + 1;
+        }
+    }
+
+private:
+    void searchLine(const QString &fileName, int lineNr, const char *line, int length,
+                    QVector<FileSearchResult> *results)
+    {
+        QString text;
+        bool decoded = false;
+        int from = 0;
+        int start;
+        int matchedLength;
+        while ((start = m_regExp.indexIn(line, length, from, &matchedLength)) != -1) {
+            from = start + qMax(matchedLength, 1);
+            if (! matchedLength)
+                continue;
+
+            if (! decoded) {
+                text = QString::fromUtf8(line, length);
+                decoded = true;
+            }
+            // report columns in characters, not bytes
+            results->append(FileSearchResult(fileName, lineNr, text,
+                                             QString::fromUtf8(line, start).length(),
+                                             QString::fromUtf8(line + start, matchedLength).length()));
+        }
+    }
+
+    ByteRegExp m_regExp;
+    LiteralMatcher m_prefilter;
+};
+
+// Falls back to QRegExp for the expressions ByteRegExp does not support.
+class QRegExpFileMatcher : public FileMatcher
+{
+public:
+    QRegExpFileMatcher(const QRegExp &expression)
+        : m_expression(expression)
+    { }
+
+    FileMatcher *clone() const
+    { return new QRegExpFileMatcher(*this); }
+
+    void search(const QString &fileName, const char *data, qint64 size,
+                QVector<FileSearchResult> *results)
+    {
+        const QByteArray contents = QByteArray::fromRawData(data, size);
+        QTextStream stream(contents);
         int lineNr = 1;
         QString line;
         while (!stream.atEnd()) {
             line = stream.readLine();
             int pos = 0;
-            while ((pos = expression.indexIn(line, pos)) != -1) {
-                future.reportResult(FileSearchResult(QDir::toNativeSeparators(s), lineNr, line,
-                                              pos, expression.matchedLength()));
-                pos += expression.matchedLength();
+            while ((pos = m_expression.indexIn(line, pos)) != -1) {
+                results->append(FileSearchResult(fileName, lineNr, line,
+                                                 pos, m_expression.matchedLength()));
+                pos += qMax(m_expression.matchedLength(), 1);
             }
             ++lineNr;
         }
-        ++numFilesSearched;
-        future.setProgressValueAndText(numFilesSearched, qApp->translate("FileSearch", "%1: %2 occurrences found in %3 of %4 files.").
-                                arg(searchTerm).arg(numMatches).arg(numFilesSearched).arg(files.size()));
     }
-    if (!future.isCanceled())
+
+private:
+    QRegExp m_expression;
+};
+
+// State shared by the threads searching the files of one query. The
+// results are reported in the order of the files, the results of files
+// searched ahead are held back until the files before them are done.
+class SearchState
+{
+public:
+    SearchState(QFutureInterface<FileSearchResult> &future,
+                const QString &searchTerm,
+                const QStringList &files)
+        : future(future), searchTerm(searchTerm), files(files),
+          nextFile(0), filesSearched(0), matches(0), nextReported(0)
+    { }
+
+    bool takeFile(int *index, QString *fileName)
+    {
+        *index = nextFile.fetchAndAddOrdered(1);
+        if (*index >= files.size())
+            return false;
+        *fileName = files.at(*index);
+        return true;
+    }
+
+    void fileSearched(int index, const QVector<FileSearchResult> &results)
+    {
+        {
+            QMutexLocker locker(&reportMutex);
+            pendingResults.insert(index, results);
+            QMap<int, QVector<FileSearchResult> >::iterator it = pendingResults.begin();
+            while (it != pendingResults.end() && it.key() == nextReported) {
+                if (! it.value().isEmpty())
+                    future.reportResults(it.value());
+                it = pendingResults.erase(it);
+                ++nextReported;
+            }
+        }
+
+        const int count = matches.fetchAndAddOrdered(results.size()) + results.size();
+        const int searched = filesSearched.fetchAndAddOrdered(1) + 1;
+        future.setProgressValueAndText(searched, qApp->translate("FileSearch", "%1: %2 occurrences found in %3 of %4 files.").
+                                       arg(searchTerm).arg(count).arg(searched).arg(files.size()));
+    }
+
+    QFutureInterface<FileSearchResult> &future;
+    const QString searchTerm;
+    const QStringList files;
+    QAtomicInt nextFile;
+    QAtomicInt filesSearched;
+    QAtomicInt matches;
+
+    QMutex reportMutex;
+    QMap<int, QVector<FileSearchResult> > pendingResults;
+    int nextReported;
+};
+
+void searchFiles(SearchState *state, FileMatcher *matcher)
+{
+    int index;
+    QString fileName;
+    while (state->takeFile(&index, &fileName)) {
+        if (state->future.isPaused())
+            state->future.waitForResume();
+        if (state->future.isCanceled())
+            break;
+
+        QVector<FileSearchResult> results;
+        MappedFile file(fileName);
+        if (file.isOpen())
+            matcher->search(QDir::toNativeSeparators(fileName), file.data(), file.size(), &results);
+
+        state->fileSearched(index, results);
+    }
+}
+
+class SearchWorker : public QRunnable
+{
+public:
+    SearchWorker(SearchState *state, FileMatcher *matcher)
+        : m_state(state), m_matcher(matcher)
+    { }
+
+    ~SearchWorker()
+    { delete m_matcher; }
+
+    void run()
+    { searchFiles(m_state, m_matcher); }
+
+private:
+    SearchState *m_state;
+    FileMatcher *m_matcher;
+};
+
+void runSearch(QFutureInterface<FileSearchResult> &future,
+               const QString &searchTerm,
+               const QStringList &files,
+               FileMatcher *matcher)
+{
+    future.setProgressRange(0, files.size());
+    SearchState state(future, searchTerm, files);
+
+    // The calling thread searches too, the others come from a private
+    // pool so that they don't block the global one.
+    QThreadPool pool;
+    const int threadCount = qMin(QThread::idealThreadCount(), files.size()) - 1;
+    for (int i = 0; i < threadCount; ++i)
+        pool.start(new SearchWorker(&state, matcher->clone()));
+
+    searchFiles(&state, matcher);
+    pool.waitForDone();
+
+    const int numFilesSearched = state.filesSearched;
+    const int numMatches = state.matches;
+    if (future.isCanceled())
+        future.setProgressValueAndText(numFilesSearched,
+                                       qApp->translate("FileSearch", "%1: canceled. %2 occurrences found in %3 files.").
+                                       arg(searchTerm).arg(numMatches).arg(numFilesSearched));
+    else
         future.setProgressValueAndText(numFilesSearched, qApp->translate("FileSearch", "%1: %2 occurrences found in %3 files.").
-                                arg(searchTerm).arg(numMatches).arg(numFilesSearched));
+                                       arg(searchTerm).arg(numMatches).arg(numFilesSearched));
+}
+
+void runFileSearch(QFutureInterface<FileSearchResult> &future,
+                   QString searchTerm,
+                   QStringList files,
+                   QTextDocument::FindFlags flags,
+                   const TrigramIndex *index)
+{
+    if (index)
+        files = index->candidateFiles(files, searchTerm, flags, false);
+
+    LiteralFileMatcher matcher(LiteralMatcher(searchTerm.toUtf8(),
+                                              flags & QTextDocument::FindCaseSensitively,
+                                              flags & QTextDocument::FindWholeWords));
+    runSearch(future, searchTerm, files, &matcher);
+}
+
+void runFileSearchRegExp(QFutureInterface<FileSearchResult> &future,
+                   QString searchTerm,
+                   QStringList files,
+                   QTextDocument::FindFlags flags,
+                   const TrigramIndex *index)
+{
+    if (index)
+        files = index->candidateFiles(files, searchTerm, flags, true);
+    if (flags & QTextDocument::FindWholeWords)
+        searchTerm = QString("\\b%1\\b").arg(searchTerm);
+    Qt::CaseSensitivity caseSensitivity = (flags & QTextDocument::FindCaseSensitively) ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    const ByteRegExp regExp(searchTerm, caseSensitivity);
+    if (regExp.isValid()) {
+        RegExpFileMatcher matcher(regExp, caseSensitivity);
+        runSearch(future, searchTerm, files, &matcher);
+    } else {
+        QRegExpFileMatcher matcher(QRegExp(searchTerm, caseSensitivity));
+        runSearch(future, searchTerm, files, &matcher);
+    }
 }
 
 } // namespace
 
 
 QFuture<FileSearchResult> Core::Utils::findInFiles(const QString &searchTerm, const QStringList &files,
-    QTextDocument::FindFlags flags)
+    QTextDocument::FindFlags flags, const TrigramIndex *index)
 {
-    return QtConcurrent::run<FileSearchResult, QString, QStringList, QTextDocument::FindFlags>(runFileSearch, searchTerm, files, flags);
+    return QtConcurrent::run<FileSearchResult, QString, QStringList, QTextDocument::FindFlags, const TrigramIndex *>
+            (runFileSearch, searchTerm, files, flags, index);
 }
 
 QFuture<FileSearchResult> Core::Utils::findInFilesRegExp(const QString &searchTerm, const QStringList &files,
-    QTextDocument::FindFlags flags)
+    QTextDocument::FindFlags flags, const TrigramIndex *index)
 {
-    return QtConcurrent::run<FileSearchResult, QString, QStringList, QTextDocument::FindFlags>(runFileSearchRegExp, searchTerm, files, flags);
+    return QtConcurrent::run<FileSearchResult, QString, QStringList, QTextDocument::FindFlags, const TrigramIndex *>
+            (runFileSearchRegExp, searchTerm, files, flags, index);
 }
@@ -43,6 +43,8 @@
 namespace Core {
 namespace Utils {
 
+class TrigramIndex;
+
 class QWORKBENCH_UTILS_EXPORT FileSearchResult
 {
 public:
@@ -59,10 +61,10 @@ public:
 };
 
 QWORKBENCH_UTILS_EXPORT QFuture<FileSearchResult> findInFiles(const QString &searchTerm, const QStringList &files,
-    QTextDocument::FindFlags flags);
+    QTextDocument::FindFlags flags, const TrigramIndex *index = 0);
 
 QWORKBENCH_UTILS_EXPORT QFuture<FileSearchResult> findInFilesRegExp(const QString &searchTerm, const QStringList &files,
-    QTextDocument::FindFlags flags);
+    QTextDocument::FindFlags flags, const TrigramIndex *index = 0);
 
 } // namespace Utils
 } // namespace Core
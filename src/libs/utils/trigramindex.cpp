@@ -0,0 +1,458 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "trigramindex.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+#include <QtCore/QtAlgorithms>
+
+#include <algorithm>
+
+using namespace Core::Utils;
+
+enum {
+    // Files above this size are never indexed and always searched.
+    MaxFileSize = 16 * 1024 * 1024,
+    IndexMagic = 0x54524749,
+    IndexVersion = 3
+};
+
+namespace {
+
+struct FileEntry
+{
+    FileEntry() : modified(0), size(0), settled(false) {}
+
+    QString fileName;
+    uint modified;
+    qint64 size;
+    // Whether the file was last modified at least a second before it was
+    // read. Modification times only have a resolution of seconds, so an
+    // unsettled file may change again without its time changing.
+    bool settled;
+    // Sorted trigrams, delta and varint encoded.
+    QByteArray trigrams;
+};
+
+inline bool containsId(const QVector<int> &ids, int id)
+{ return qBinaryFind(ids, id) != ids.constEnd(); }
+
+inline uchar fold(uchar c)
+{ return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; }
+
+// Collects the distinct case folded trigrams of data. Trigrams with bytes
+// outside of ASCII are left out, the searches decode and case fold those
+// differently than the index could.
+void collectTrigrams(const char *data, int size, QVector<quint32> *trigrams)
+{
+    for (int i = 0; i + 2 < size; ++i) {
+        const uchar a = data[i], b = data[i + 1], c = data[i + 2];
+        if ((a | b | c) & 0x80)
+            continue;
+        trigrams->append((fold(a) << 16) | (fold(b) << 8) | fold(c));
+    }
+}
+
+void sortTrigrams(QVector<quint32> *trigrams)
+{
+    qSort(trigrams->begin(), trigrams->end());
+    QVector<quint32>::iterator end = std::unique(trigrams->begin(), trigrams->end());
+    trigrams->resize(end - trigrams->begin());
+}
+
+QByteArray encodeTrigrams(const QVector<quint32> &trigrams)
+{
+    QByteArray encoded;
+    encoded.reserve(trigrams.size() * 2);
+    quint32 previous = 0;
+    foreach (quint32 trigram, trigrams) {
+        quint32 delta = trigram - previous;
+        previous = trigram;
+        while (delta >= 0x80) {
+            encoded.append(char(delta | 0x80));
+            delta >>= 7;
+        }
+        encoded.append(char(delta));
+    }
+    return encoded;
+}
+
+QVector<quint32> decodeTrigrams(const QByteArray &encoded)
+{
+    QVector<quint32> trigrams;
+    const uchar *p = reinterpret_cast<const uchar *>(encoded.constData());
+    const uchar *end = p + encoded.size();
+    quint32 previous = 0;
+    while (p != end) {
+        quint32 delta = 0;
+        int shift = 0;
+        while (p != end && (*p & 0x80)) {
+            delta |= quint32(*p++ & 0x7f) << shift;
+            shift += 7;
+        }
+        if (p != end)
+            delta |= quint32(*p++) << shift;
+        previous += delta;
+        trigrams.append(previous);
+    }
+    return trigrams;
+}
+
+// Returns the literal runs every match of the QRegExp pattern contains.
+// Only text outside of groups and character classes is taken, and an
+// alternation anywhere gives up, so the result errs on the safe side.
+QStringList requiredLiterals(const QString &pattern)
+{
+    QStringList literals;
+    QString current;
+    int depth = 0;
+
+    for (int i = 0; i < pattern.length(); ++i) {
+        const QChar c = pattern.at(i);
+
+        if (c == QLatin1Char('|'))
+            return QStringList();
+
+        if (c == QLatin1Char('\\') && i + 1 < pattern.length()) {
+            const QChar next = pattern.at(++i);
+            if (next.isLetterOrNumber()) {
+                literals.append(current);
+                current.clear();
+            } else if (! depth) {
+                current.append(next);
+            }
+            continue;
+        }
+
+        if (c == QLatin1Char('[')) {
+            literals.append(current);
+            current.clear();
+            ++i;
+            if (i < pattern.length() && pattern.at(i) == QLatin1Char('^'))
+                ++i;
+            if (i < pattern.length() && pattern.at(i) == QLatin1Char(']'))
+                ++i;
+            for (; i < pattern.length() && pattern.at(i) != QLatin1Char(']'); ++i) {
+                if (pattern.at(i) == QLatin1Char('\\'))
+                    ++i;
+            }
+        } else if (c == QLatin1Char('(') || c == QLatin1Char(')')) {
+            literals.append(current);
+            current.clear();
+            depth += (c == QLatin1Char('(')) ? 1 : -1;
+        } else if (c == QLatin1Char('?') || c == QLatin1Char('*') || c == QLatin1Char('{')) {
+            // the preceding character is optional
+            current.chop(1);
+            literals.append(current);
+            current.clear();
+            if (c == QLatin1Char('{')) {
+                while (i < pattern.length() && pattern.at(i) != QLatin1Char('}'))
+                    ++i;
+            }
+        } else if (c == QLatin1Char('+') || c == QLatin1Char('.')
+                   || c == QLatin1Char('^') || c == QLatin1Char('$')) {
+            literals.append(current);
+            current.clear();
+        } else if (! depth) {
+            current.append(c);
+        }
+    }
+    literals.append(current);
+    return literals;
+}
+
+} // anonymous namespace
+
+namespace Core {
+namespace Utils {
+
+struct TrigramIndexPrivate
+{
+    TrigramIndexPrivate() {}
+
+    void insert(const FileEntry &entry);
+    void remove(const QString &fileName);
+    QVector<int> filesContaining(const QVector<quint32> &trigrams) const;
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, int> m_fileIds;
+    QVector<FileEntry> m_files;
+    QList<int> m_freeIds;
+    // Sorted file ids per trigram
+    QHash<quint32, QVector<int> > m_postings;
+};
+
+} // namespace Utils
+} // namespace Core
+
+void TrigramIndexPrivate::insert(const FileEntry &entry)
+{
+    remove(entry.fileName);
+
+    int id;
+    if (m_freeIds.isEmpty()) {
+        id = m_files.size();
+        m_files.append(entry);
+    } else {
+        id = m_freeIds.takeLast();
+        m_files[id] = entry;
+    }
+    m_fileIds.insert(entry.fileName, id);
+
+    foreach (quint32 trigram, decodeTrigrams(entry.trigrams)) {
+        QVector<int> &ids = m_postings[trigram];
+        ids.insert(qLowerBound(ids.begin(), ids.end(), id), id);
+    }
+}
+
+void TrigramIndexPrivate::remove(const QString &fileName)
+{
+    const int id = m_fileIds.value(fileName, -1);
+    if (id == -1)
+        return;
+
+    foreach (quint32 trigram, decodeTrigrams(m_files.at(id).trigrams)) {
+        QHash<quint32, QVector<int> >::iterator it = m_postings.find(trigram);
+        if (it == m_postings.end())
+            continue;
+        QVector<int>::iterator pos = qBinaryFind(it->begin(), it->end(), id);
+        if (pos != it->end())
+            it->erase(pos);
+        if (it->isEmpty())
+            m_postings.erase(it);
+    }
+
+    m_fileIds.remove(fileName);
+    m_files[id] = FileEntry();
+    m_freeIds.append(id);
+}
+
+QVector<int> TrigramIndexPrivate::filesContaining(const QVector<quint32> &trigrams) const
+{
+    QList<const QVector<int> *> lists;
+    foreach (quint32 trigram, trigrams) {
+        QHash<quint32, QVector<int> >::const_iterator it = m_postings.constFind(trigram);
+        if (it == m_postings.constEnd())
+            return QVector<int>();
+        lists.append(&it.value());
+    }
+
+    // intersect, starting with the shortest list
+    const QVector<int> *shortest = lists.first();
+    foreach (const QVector<int> *ids, lists) {
+        if (ids->size() < shortest->size())
+            shortest = ids;
+    }
+
+    QVector<int> result;
+    foreach (int id, *shortest) {
+        bool found = true;
+        foreach (const QVector<int> *ids, lists) {
+            if (ids != shortest && ! containsId(*ids, id)) {
+                found = false;
+                break;
+            }
+        }
+        if (found)
+            result.append(id);
+    }
+    return result;
+}
+
+TrigramIndex::TrigramIndex()
+    : m_d(new TrigramIndexPrivate)
+{
+}
+
+TrigramIndex::~TrigramIndex()
+{
+    delete m_d;
+}
+
+bool TrigramIndex::updateFile(const QString &fileName)
+{
+    QFile file(fileName);
+    const QFileInfo info(fileName);
+    if (info.size() > MaxFileSize || ! file.open(QIODevice::ReadOnly)) {
+        removeFile(fileName);
+        return true;
+    }
+
+    FileEntry entry;
+    entry.fileName = fileName;
+    entry.modified = info.lastModified().toTime_t();
+    entry.size = info.size();
+    entry.settled = entry.modified < QDateTime::currentDateTime().toTime_t() - 1;
+
+    QVector<quint32> trigrams;
+    if (const uchar *data = entry.size ? file.map(0, entry.size) : 0) {
+        collectTrigrams(reinterpret_cast<const char *>(data), entry.size, &trigrams);
+    } else {
+        const QByteArray contents = file.readAll();
+        collectTrigrams(contents.constData(), contents.size(), &trigrams);
+    }
+    sortTrigrams(&trigrams);
+    entry.trigrams = encodeTrigrams(trigrams);
+
+    QWriteLocker locker(&m_d->m_lock);
+    m_d->insert(entry);
+    return entry.settled;
+}
+
+void TrigramIndex::removeFile(const QString &fileName)
+{
+    QWriteLocker locker(&m_d->m_lock);
+    m_d->remove(fileName);
+}
+
+void TrigramIndex::retainFiles(const QStringList &files)
+{
+    const QSet<QString> retained = files.toSet();
+
+    QWriteLocker locker(&m_d->m_lock);
+    foreach (const QString &fileName, m_d->m_fileIds.keys()) {
+        if (! retained.contains(fileName))
+            m_d->remove(fileName);
+    }
+}
+
+QStringList TrigramIndex::outdatedFiles(const QStringList &files) const
+{
+    QStringList outdated;
+    QReadLocker locker(&m_d->m_lock);
+    foreach (const QString &fileName, files) {
+        const int id = m_d->m_fileIds.value(fileName, -1);
+        if (id == -1) {
+            outdated.append(fileName);
+            continue;
+        }
+        const FileEntry &entry = m_d->m_files.at(id);
+        const QFileInfo info(fileName);
+        if (! entry.settled || entry.size != info.size()
+                || entry.modified != info.lastModified().toTime_t())
+            outdated.append(fileName);
+    }
+    return outdated;
+}
+
+QStringList TrigramIndex::candidateFiles(const QStringList &files, const QString &searchTerm,
+                                         QTextDocument::FindFlags, bool regExp) const
+{
+    const QStringList literals = regExp ? requiredLiterals(searchTerm) : QStringList(searchTerm);
+
+    QVector<quint32> trigrams;
+    foreach (const QString &literal, literals) {
+        const QByteArray utf8 = literal.toUtf8();
+        collectTrigrams(utf8.constData(), utf8.size(), &trigrams);
+    }
+    if (trigrams.isEmpty())
+        return files;
+    sortTrigrams(&trigrams);
+
+    const QSet<QString> outdated = outdatedFiles(files).toSet();
+
+    QReadLocker locker(&m_d->m_lock);
+    const QVector<int> matching = m_d->filesContaining(trigrams);
+
+    QStringList candidates;
+    foreach (const QString &fileName, files) {
+        if (outdated.contains(fileName)
+                || containsId(matching, m_d->m_fileIds.value(fileName)))
+            candidates.append(fileName);
+    }
+    return candidates;
+}
+
+bool TrigramIndex::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (! file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_4);
+    quint32 magic, version;
+    in >> magic >> version;
+    if (magic != IndexMagic || version != IndexVersion)
+        return false;
+
+    int count;
+    in >> count;
+
+    QWriteLocker locker(&m_d->m_lock);
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        FileEntry entry;
+        in >> entry.fileName >> entry.modified >> entry.size >> entry.settled >> entry.trigrams;
+        if (in.status() == QDataStream::Ok)
+            m_d->insert(entry);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool TrigramIndex::save(const QString &fileName) const
+{
+    QDir().mkpath(QFileInfo(fileName).path());
+
+    const QString tempFileName = fileName + QLatin1String(".tmp");
+    QFile file(tempFileName);
+    if (! file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_4);
+    out << quint32(IndexMagic) << quint32(IndexVersion);
+    {
+        QReadLocker locker(&m_d->m_lock);
+        out << m_d->m_fileIds.size();
+        foreach (int id, m_d->m_fileIds) {
+            const FileEntry &entry = m_d->m_files.at(id);
+            out << entry.fileName << entry.modified << entry.size << entry.settled << entry.trigrams;
+        }
+    }
+    file.close();
+
+    if (out.status() != QDataStream::Ok) {
+        QFile::remove(tempFileName);
+        return false;
+    }
+    QFile::remove(fileName);
+    return QFile::rename(tempFileName, fileName);
+}
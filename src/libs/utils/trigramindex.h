@@ -0,0 +1,93 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include "utils_global.h"
+
+#include <QtCore/QStringList>
+#include <QtGui/QTextDocument>
+
+namespace Core {
+namespace Utils {
+
+struct TrigramIndexPrivate;
+
+/* TrigramIndex: Remembers which three byte sequences occur in a set of
+ * files, so that text searches only need to scan the files that can
+ * possibly contain a match.
+ *
+ * Trigrams are case folded, the same index serves case sensitive and
+ * case insensitive searches. Files are keyed by name, size and
+ * modification time; files that are unknown, changed on disk or were
+ * modified within a second of being read are always considered to be
+ * candidates, so a stale index never hides matches.
+ *
+ * All functions are thread safe. */
+
+class QWORKBENCH_UTILS_EXPORT TrigramIndex
+{
+public:
+    TrigramIndex();
+    ~TrigramIndex();
+
+    // (Re-)indexes fileName from its contents on disk. Returns false if the
+    // file was modified too recently to be trusted; it stays outdated until
+    // it is updated again a second later.
+    bool updateFile(const QString &fileName);
+    void removeFile(const QString &fileName);
+
+    // Drops all files that are not in files.
+    void retainFiles(const QStringList &files);
+
+    // Returns the files that are not indexed or changed since.
+    QStringList outdatedFiles(const QStringList &files) const;
+
+    // Returns the files that may contain searchTerm.
+    QStringList candidateFiles(const QStringList &files, const QString &searchTerm,
+                               QTextDocument::FindFlags flags, bool regExp) const;
+
+    bool load(const QString &fileName);
+    bool save(const QString &fileName) const;
+
+private:
+    Q_DISABLE_COPY(TrigramIndex)
+
+    TrigramIndexPrivate *m_d;
+};
+
+} // namespace Utils
+} // namespace Core
+
+#endif // TRIGRAMINDEX_H
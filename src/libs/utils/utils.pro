@@ -9,6 +9,9 @@ SOURCES += \
     reloadpromptutils.cpp \
     settingsutils.cpp \
     filesearch.cpp \
+    byteregexp.cpp \
+    trigramindex.cpp \
+    directorycrawler.cpp \
     pathchooser.cpp \
     filewizardpage.cpp \
     filewizarddialog.cpp \
@@ -30,6 +33,9 @@ HEADERS += \
     reloadpromptutils.h \
     settingsutils.h \
     filesearch.h \
+    byteregexp.h \
+    trigramindex.h \
+    directorycrawler.h \
     listutils.h \
     pathchooser.h \
     filewizardpage.h \
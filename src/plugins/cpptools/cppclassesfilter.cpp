@@ -36,13 +36,10 @@
 using namespace CppTools::Internal;
 
 CppClassesFilter::CppClassesFilter(CppModelManager *manager, Core::EditorManager *editorManager)
-    : CppQuickOpenFilter(manager, editorManager)
+    : CppQuickOpenFilter(manager, editorManager, SearchSymbols::Classes, true)
 {
     setShortcutString("c");
     setIncludedByDefault(false);
-
-    search.setSymbolsToSearchFor(SearchSymbols::Classes);
-    search.setSeparateScope(true);
 }
 
 CppClassesFilter::~CppClassesFilter()
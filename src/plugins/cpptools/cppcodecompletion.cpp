@@ -485,8 +485,8 @@ int CppCodeCompletion::startCompletion(TextEditor::ITextEditable *editor)
                 addMacros(context);
             }
 
-            const QList<Scope *> scopes = context.expand(context.visibleScopes());
-            foreach (Scope *scope, scopes) {
+            // The visible scopes are expanded already.
+            foreach (Scope *scope, context.visibleScopes()) {
                 for (unsigned i = 0; i < scope->symbolCount(); ++i) {
                     addCompletionItem(scope->symbolAt(i));
                 }
@@ -771,13 +771,49 @@ void CppCodeCompletion::addKeywords()
     }
 }
 
-void CppCodeCompletion::addMacros(const LookupContext &context)
+bool CppCodeCompletion::isUpToDate(const IncludeClosure &closure,
+                                   const LookupContext &context) const
 {
-    // macro completion items.
-    QSet<QByteArray> macroNames;
+    if (closure.includedFiles != context.thisDocument()->includedFiles())
+        return false;
+
+    foreach (const Document::Ptr &doc, closure.documents) {
+        if (context.document(doc->fileName()) != doc)
+            return false;
+    }
+
+    foreach (const QString &fileName, closure.missingFiles) {
+        if (context.document(fileName))
+            return false;
+    }
+
+    return true;
+}
+
+// The current document is not part of its include closure: it changes
+// while typing, its included files do not.
+CppCodeCompletion::IncludeClosure *CppCodeCompletion::includeClosure(const LookupContext &context)
+{
+    Document::Ptr thisDocument = context.thisDocument();
+    const QString fileName = thisDocument->fileName();
+
+    QHash<QString, IncludeClosure>::iterator it = m_includeClosures.find(fileName);
+    if (it != m_includeClosures.end()) {
+        if (isUpToDate(it.value(), context))
+            return &it.value();
+        m_includeClosures.erase(it);
+    }
+
+    // don't keep old versions of the documents alive for too long.
+    if (m_includeClosures.size() >= MAX_INCLUDE_CLOSURE_COUNT)
+        m_includeClosures.clear();
+
+    IncludeClosure closure;
+    closure.includedFiles = thisDocument->includedFiles();
+
     QSet<QString> processed;
-    QList<QString> todo;
-    todo.append(context.thisDocument()->fileName());
+    processed.insert(fileName);
+    QList<QString> todo = closure.includedFiles;
     while (! todo.isEmpty()) {
         QString fn = todo.last();
         todo.removeLast();
@@ -785,16 +821,40 @@ void CppCodeCompletion::addMacros(const LookupContext &context)
             continue;
         processed.insert(fn);
         if (Document::Ptr doc = context.document(fn)) {
+            closure.documents.append(doc);
             foreach (const Macro &macro, doc->definedMacros()) {
-                macroNames.insert(macro.name());
+                if (closure.macroNames.contains(macro.name()))
+                    continue;
+                closure.macroNames.insert(macro.name());
+
+                TextEditor::CompletionItem item(this);
+                item.m_text = QString::fromUtf8(macro.name().constData(), macro.name().length());
+                item.m_icon = m_icons.macroIcon();
+                closure.macroItems.append(item);
             }
             todo += doc->includedFiles();
+        } else {
+            closure.missingFiles.append(fn);
         }
     }
 
-    foreach (const QByteArray &macroName, macroNames) {
+    return &m_includeClosures.insert(fileName, closure).value();
+}
+
+void CppCodeCompletion::addMacros(const LookupContext &context)
+{
+    // macro completion items.
+    const IncludeClosure *closure = includeClosure(context);
+    m_completions += closure->macroItems;
+
+    QSet<QByteArray> macroNames = closure->macroNames;
+    foreach (const Macro &macro, context.thisDocument()->definedMacros()) {
+        if (macroNames.contains(macro.name()))
+            continue;
+        macroNames.insert(macro.name());
+
         TextEditor::CompletionItem item(this);
-        item.m_text = QString::fromUtf8(macroName.constData(), macroName.length());
+        item.m_text = QString::fromUtf8(macro.name().constData(), macro.name().length());
         item.m_icon = m_icons.macroIcon();
         m_completions.append(item);
     }
@@ -811,10 +871,16 @@ void CppCodeCompletion::completeNamespace(const QList<Symbol *> &candidates,
                                           const LookupContext &context)
 {
     QList<Scope *> todo;
-    QList<Scope *> visibleScopes = context.visibleScopes();
+    QSet<Scope *> processed;
     foreach (Symbol *candidate, candidates) {
-        if (Namespace *ns = candidate->asNamespace())
-            context.expand(ns->members(), visibleScopes, &todo);
+        if (Namespace *ns = candidate->asNamespace()) {
+            foreach (Scope *scope, context.expand(ns->members())) {
+                if (! processed.contains(scope)) {
+                    processed.insert(scope);
+                    todo.append(scope);
+                }
+            }
+        }
     }
 
     foreach (Scope *scope, todo) {
@@ -835,8 +901,7 @@ void CppCodeCompletion::completeClass(const QList<Symbol *> &candidates,
 
     Class *klass = candidates.first()->asClass();
 
-    QList<Scope *> todo;
-    context.expand(klass->members(), context.visibleScopes(), &todo);
+    const QList<Scope *> todo = context.expand(klass->members());
 
     foreach (Scope *scope, todo) {
         addCompletionItem(scope->owner());
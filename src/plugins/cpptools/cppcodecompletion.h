@@ -45,8 +45,10 @@
 #include <texteditor/icompletioncollector.h>
 
 // Qt
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
+#include <QtCore/QSet>
 
 namespace Core {
 class ICore;
@@ -88,6 +90,20 @@ public:
     void setPartialCompletionEnabled(bool partialCompletionEnabled);
 
 private:
+    // What completion needs to know about the files included by a
+    // document, kept until one of them changes.
+    struct IncludeClosure
+    {
+        QStringList includedFiles;                 // of the document itself
+        QList<CPlusPlus::Document::Ptr> documents; // included directly or not
+        QStringList missingFiles;
+        QSet<QByteArray> macroNames;
+        QList<TextEditor::CompletionItem> macroItems;
+    };
+
+    IncludeClosure *includeClosure(const CPlusPlus::LookupContext &context);
+    bool isUpToDate(const IncludeClosure &closure, const CPlusPlus::LookupContext &context) const;
+
     void addKeywords();
     void addMacros(const CPlusPlus::LookupContext &context);
     void addCompletionItem(CPlusPlus::Symbol *symbol);
@@ -146,6 +162,10 @@ private:
     unsigned m_completionOperator;
 
     QPointer<FunctionArgumentWidget> m_functionArgumentWidget;
+
+    QHash<QString, IncludeClosure> m_includeClosures;
+
+    enum { MAX_INCLUDE_CLOSURE_COUNT = 4 };
 };
 
 } // namespace Internal
@@ -36,13 +36,10 @@
 using namespace CppTools::Internal;
 
 CppFunctionsFilter::CppFunctionsFilter(CppModelManager *manager, Core::EditorManager *editorManager)
-    : CppQuickOpenFilter(manager, editorManager)
+    : CppQuickOpenFilter(manager, editorManager, SearchSymbols::Functions, true)
 {
     setShortcutString("m");
     setIncludedByDefault(false);
-
-    search.setSymbolsToSearchFor(SearchSymbols::Functions);
-    search.setSeparateScope(true);
 }
 
 CppFunctionsFilter::~CppFunctionsFilter()
@@ -0,0 +1,409 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "cppindexcache.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QReadLocker>
+#include <QtCore/QWriteLocker>
+
+using namespace CppTools::Internal;
+using namespace CPlusPlus;
+
+enum {
+    CacheMagic = 0x43505049, // "CPPI"
+    CacheVersion = 4
+};
+
+enum MacroFlags {
+    HiddenMacro       = 0x1,
+    FunctionLikeMacro = 0x2,
+    VariadicMacro     = 0x4
+};
+
+static QDataStream &operator<<(QDataStream &out, const CppIndexCache::Key &key)
+{
+    return out << key.fileName << quint32(key.modified) << key.size << key.digest
+               << quint32(key.configuration);
+}
+
+static QDataStream &operator>>(QDataStream &in, CppIndexCache::Key &key)
+{
+    return in >> key.fileName >> key.modified >> key.size >> key.digest >> key.configuration;
+}
+
+static QByteArray serialize(const CppIndexCache::Entry &entry)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_4);
+
+    out << entry.preprocessedCode;
+
+    out << quint32(entry.includes.size());
+    foreach (const Document::Include &include, entry.includes)
+        out << include.fileName() << quint32(include.line());
+
+    out << quint32(entry.definedMacros.size());
+    foreach (const Macro &macro, entry.definedMacros) {
+        quint8 flags = 0;
+        if (macro.isHidden())
+            flags |= HiddenMacro;
+        if (macro.isFunctionLike())
+            flags |= FunctionLikeMacro;
+        if (macro.isVariadic())
+            flags |= VariadicMacro;
+
+        out << macro.name() << macro.definition() << macro.formals()
+            << macro.fileName() << quint32(macro.line()) << flags;
+    }
+
+    out << quint32(entry.skippedBlocks.size());
+    foreach (const Document::Block &block, entry.skippedBlocks)
+        out << quint32(block.begin()) << quint32(block.end());
+
+    out << quint32(entry.diagnosticMessages.size());
+    foreach (const Document::DiagnosticMessage &m, entry.diagnosticMessages)
+        out << qint32(m.level()) << m.fileName() << quint32(m.line())
+            << quint32(m.column()) << m.text();
+
+    out << entry.macroLookups;
+
+    out << quint32(entry.dependencies.size());
+    foreach (const CppIndexCache::Key &key, entry.dependencies)
+        out << key;
+
+    return data;
+}
+
+static bool deserialize(const QByteArray &data, CppIndexCache::Entry *entry)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_4_4);
+
+    in >> entry->preprocessedCode;
+
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString fileName;
+        quint32 line;
+        in >> fileName >> line;
+        entry->includes.append(Document::Include(fileName, line));
+    }
+
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QByteArray name;
+        QByteArray definition;
+        QVector<QByteArray> formals;
+        QByteArray fileName;
+        quint32 line;
+        quint8 flags;
+        in >> name >> definition >> formals >> fileName >> line >> flags;
+
+        Macro macro;
+        macro.setName(name);
+        macro.setDefinition(definition);
+        foreach (const QByteArray &formal, formals)
+            macro.addFormal(formal);
+        macro.setFileName(fileName);
+        macro.setLine(line);
+        macro.setHidden(flags & HiddenMacro);
+        macro.setFunctionLike(flags & FunctionLikeMacro);
+        macro.setVariadic(flags & VariadicMacro);
+        entry->definedMacros.append(macro);
+    }
+
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        quint32 begin;
+        quint32 end;
+        in >> begin >> end;
+        entry->skippedBlocks.append(Document::Block(begin, end));
+    }
+
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        qint32 level;
+        QString fileName;
+        quint32 line;
+        quint32 column;
+        QString text;
+        in >> level >> fileName >> line >> column >> text;
+        entry->diagnosticMessages.append(Document::DiagnosticMessage(level, fileName,
+                                                                     line, column, text));
+    }
+
+    in >> entry->macroLookups;
+
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        CppIndexCache::Key key;
+        in >> key;
+        entry->dependencies.append(key);
+    }
+
+    return in.status() == QDataStream::Ok;
+}
+
+CppIndexCache::CppIndexCache(const QString &fileName)
+    : m_fileName(fileName),
+      m_map(0),
+      m_mapSize(0)
+{ }
+
+CppIndexCache::~CppIndexCache()
+{ close(); }
+
+QString CppIndexCache::fileName() const
+{ return m_fileName; }
+
+bool CppIndexCache::open()
+{
+    QWriteLocker locker(&m_lock);
+    return mapFile();
+}
+
+void CppIndexCache::close()
+{
+    QWriteLocker locker(&m_lock);
+    unmapFile();
+}
+
+bool CppIndexCache::hasPendingEntries() const
+{
+    QReadLocker locker(&m_lock);
+    return ! m_pending.isEmpty();
+}
+
+QStringList CppIndexCache::fileNames() const
+{
+    QReadLocker locker(&m_lock);
+    return (m_index.keys().toSet() + m_pending.keys().toSet()).toList();
+}
+
+// m_lock must be locked for writing.
+bool CppIndexCache::mapFile()
+{
+    m_file.setFileName(m_fileName);
+    if (! m_file.open(QFile::ReadOnly))
+        return false;
+
+    m_mapSize = m_file.size();
+    m_map = m_file.map(0, m_mapSize);
+    if (! m_map) {
+        m_file.close();
+        return false;
+    }
+
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char *>(m_map),
+                                                    m_mapSize);
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_4_4);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    in >> magic >> version >> count;
+
+    if (magic != CacheMagic || version != CacheVersion) {
+        unmapFile();
+        return false;
+    }
+
+    QList<IndexItem> items;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        IndexItem item;
+        in >> item.key >> item.offset >> item.size;
+        items.append(item);
+    }
+
+    const qint64 dataStart = in.device()->pos();
+    foreach (IndexItem item, items) {
+        if (dataStart + item.offset + item.size > m_mapSize)
+            continue; // truncated file
+        item.offset += dataStart;
+        m_index.insert(item.key.fileName, item);
+    }
+
+    return in.status() == QDataStream::Ok;
+}
+
+// m_lock must be locked for writing.
+void CppIndexCache::unmapFile()
+{
+    m_index.clear();
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = 0;
+    }
+    m_file.close();
+}
+
+QByteArray CppIndexCache::mappedData(const IndexItem &item) const
+{ return QByteArray::fromRawData(reinterpret_cast<const char *>(m_map) + item.offset, item.size); }
+
+bool CppIndexCache::restore(const Key &key, Entry *entry) const
+{
+    QReadLocker locker(&m_lock);
+
+    if (m_pending.contains(key.fileName)) {
+        const PendingItem &pending = m_pending[key.fileName];
+        if (pending.key == key)
+            return deserialize(pending.data, entry);
+        return false;
+    }
+
+    if (! m_map || ! m_index.contains(key.fileName))
+        return false;
+
+    const IndexItem &item = m_index[key.fileName];
+    if (! (item.key == key))
+        return false;
+
+    return deserialize(mappedData(item), entry);
+}
+
+void CppIndexCache::store(const Key &key, const Entry &entry)
+{
+    PendingItem pending;
+    pending.key = key;
+    pending.data = serialize(entry);
+
+    QWriteLocker locker(&m_lock);
+    m_pending.insert(key.fileName, pending);
+}
+
+// The indexer may go on restoring and storing entries while the cache
+// is written, the lock is taken for writing only to replace the file.
+bool CppIndexCache::save(const QStringList &fileNames)
+{
+    QByteArray index;
+    QByteArray blobs;
+    quint32 count = 0;
+    QList<Key> savedPendingKeys;
+
+    QDataStream indexOut(&index, QIODevice::WriteOnly);
+    indexOut.setVersion(QDataStream::Qt_4_4);
+
+    {
+        QReadLocker locker(&m_lock);
+
+        foreach (const QString &fileName, fileNames) {
+            Key key;
+            QByteArray data;
+
+            if (m_pending.contains(fileName)) {
+                const PendingItem &pending = m_pending[fileName];
+                key = pending.key;
+                data = pending.data;
+                savedPendingKeys.append(key);
+            } else if (m_map && m_index.contains(fileName)) {
+                const IndexItem &item = m_index[fileName];
+                key = item.key;
+                data = QByteArray(reinterpret_cast<const char *>(m_map) + item.offset, item.size);
+            } else {
+                continue;
+            }
+
+            indexOut << key << quint32(blobs.size()) << quint32(data.size());
+            blobs += data;
+            ++count;
+        }
+    }
+
+    QDir().mkpath(QFileInfo(m_fileName).path());
+
+    const QString tempFileName = m_fileName + QLatin1String(".tmp");
+    QFile file(tempFileName);
+    if (! file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_4);
+    out << quint32(CacheMagic) << quint32(CacheVersion) << count;
+    out.writeRawData(index.constData(), index.size());
+    out.writeRawData(blobs.constData(), blobs.size());
+    file.close();
+
+    if (out.status() != QDataStream::Ok) {
+        QFile::remove(tempFileName);
+        return false;
+    }
+
+    QWriteLocker locker(&m_lock);
+
+    // the mapping must go before the file is replaced.
+    unmapFile();
+    QFile::remove(m_fileName);
+    const bool renamed = QFile::rename(tempFileName, m_fileName);
+    mapFile();
+
+    // entries stored in the meantime stay pending.
+    foreach (const Key &key, savedPendingKeys) {
+        if (m_pending.value(key.fileName).key == key)
+            m_pending.remove(key.fileName);
+    }
+
+    return renamed;
+}
+
+CppIndexCache::Key CppIndexCache::key(const QString &fileName, const QByteArray &contents,
+                                      uint configuration)
+{
+    const QFileInfo fileInfo(fileName);
+
+    Key k;
+    k.fileName = fileName;
+    k.modified = fileInfo.lastModified().toTime_t();
+    k.size = quint32(fileInfo.size());
+    k.digest = QCryptographicHash::hash(contents, QCryptographicHash::Md5);
+    k.configuration = configuration;
+    return k;
+}
+
+uint CppIndexCache::configurationKey(const QByteArray &definedMacros,
+                                     const QStringList &includePaths,
+                                     const QStringList &frameworkPaths)
+{
+    const QString separator = QLatin1String("\n");
+    uint h = qHash(definedMacros);
+    h = h * 31 + qHash(includePaths.join(separator));
+    h = h * 31 + qHash(frameworkPaths.join(separator));
+    return h;
+}
@@ -0,0 +1,154 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#ifndef CPPINDEXCACHE_H
+#define CPPINDEXCACHE_H
+
+#include <cplusplus/CppDocument.h>
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+namespace CppTools {
+namespace Internal {
+
+/*
+    On-disk cache of the preprocessed documents of the code model.
+
+    The cache file is memory mapped when it is opened and the entries are
+    decoded only when the indexer asks for them. An entry is used only if
+    the file name, size, MD5 digest of the contents and the configuration
+    (defines, include and framework paths) all still match, and none of
+    the files it includes, directly or not, has changed since. An included
+    file whose modification time and size did not change is not read again
+    to check it.
+
+    New entries are written out by save(), which the model manager calls
+    from time to time and at shutdown.
+
+    Symbols are not serialized, they are rebuilt by parsing the cached
+    preprocessed source. What is saved is the expensive part: reading the
+    included files, resolving them and expanding the macros.
+*/
+class CppIndexCache
+{
+public:
+    class Key
+    {
+    public:
+        Key()
+            : modified(0), size(0), configuration(0)
+        { }
+
+        // The modification time is not compared, a file that was
+        // touched but not changed still matches.
+        bool operator==(const Key &other) const
+        {
+            return size == other.size
+                    && configuration == other.configuration
+                    && digest == other.digest
+                    && fileName == other.fileName;
+        }
+
+        QString fileName;
+        uint modified;
+        quint32 size;
+        QByteArray digest;
+        uint configuration;
+    };
+
+    class Entry
+    {
+    public:
+        QByteArray preprocessedCode;
+        QList<CPlusPlus::Document::Include> includes;
+        QList<CPlusPlus::Macro> definedMacros;
+        QList<CPlusPlus::Document::Block> skippedBlocks;
+        QList<CPlusPlus::Document::DiagnosticMessage> diagnosticMessages;
+        QVector<unsigned> macroLookups;
+        QList<Key> dependencies; // the keys of all the included files
+    };
+
+    CppIndexCache(const QString &fileName);
+    ~CppIndexCache();
+
+    QString fileName() const;
+
+    bool open();
+    void close();
+    bool hasPendingEntries() const;
+    QStringList fileNames() const;
+    bool save(const QStringList &fileNames);
+
+    bool restore(const Key &key, Entry *entry) const;
+    void store(const Key &key, const Entry &entry);
+
+    static Key key(const QString &fileName, const QByteArray &contents, uint configuration);
+    static uint configurationKey(const QByteArray &definedMacros,
+                                 const QStringList &includePaths,
+                                 const QStringList &frameworkPaths);
+
+private:
+    struct IndexItem
+    {
+        Key key;
+        quint32 offset;
+        quint32 size;
+    };
+
+    struct PendingItem
+    {
+        Key key;
+        QByteArray data;
+    };
+
+    bool mapFile();
+    void unmapFile();
+    QByteArray mappedData(const IndexItem &item) const;
+
+    QString m_fileName;
+    mutable QReadWriteLock m_lock;
+    QFile m_file;
+    uchar *m_map;
+    qint64 m_mapSize;
+    QHash<QString, IndexItem> m_index;
+    QHash<QString, PendingItem> m_pending;
+};
+
+} // namespace Internal
+} // namespace CppTools
+
+#endif // CPPINDEXCACHE_H
@@ -34,6 +34,8 @@
 #include <cplusplus/pp.h>
 
 #include "cppmodelmanager.h"
+#include "cppindexcache.h"
+#include "cppsymbolindex.h"
 #include "cpptoolsconstants.h"
 #include "cpptoolseditorsupport.h"
 
@@ -65,9 +67,13 @@
 #include <Lexer.h>
 #include <Token.h>
 
+#include <QtCore/QCoreApplication>
 #include <QtCore/QDebug>
 #include <QtCore/QMutexLocker>
+#include <QtCore/QSettings>
+#include <QtCore/QThreadPool>
 #include <QtCore/QTime>
+#include <QtCore/QTimer>
 
 //#include <QtGui/QPlainTextEdit>
 
@@ -109,6 +115,61 @@ static const char pp_configuration[] =
 namespace CppTools {
 namespace Internal {
 
+/*
+    State shared by all the workers of one indexing run.
+
+    The files are split into contiguous ranges, one per worker, so that
+    sources living next to each other (and usually including the same
+    headers) end up on the same worker. A worker that runs out of files
+    steals from the back of the busiest queue.
+
+    The snapshot is shared as well: a header parsed by one worker is
+    merged, not re-preprocessed, by the others.
+*/
+class CppPreprocessor;
+
+class CppIndexer
+{
+public:
+    enum Phase {
+        PreprocessPhase,
+        ParsePhase,
+        CheckPhase,
+        PhaseCount
+    };
+
+    CppIndexer(const Snapshot &snapshot, const QStringList &files, int workerCount);
+    ~CppIndexer();
+
+    int workerCount() const
+    { return m_queues.size(); }
+
+    void addPreprocessor(CppPreprocessor *preproc);
+    CppPreprocessor *preprocessor(int worker) const
+    { return m_preprocessors.at(worker); }
+
+    int fileCount() const
+    { return m_fileCount; }
+
+    bool takeFile(int worker, QString *fileName);
+    int fileDone();
+
+    Document::Ptr document(const QString &fileName) const;
+    void insertDocument(Document::Ptr doc);
+
+    void addTime(Phase phase, int msecs);
+    QString timingSummary() const;
+
+private:
+    mutable QMutex m_mutex;
+    Snapshot m_snapshot;
+    QList<QStringList> m_queues;
+    QList<CppPreprocessor *> m_preprocessors;
+    int m_fileCount;
+    QAtomicInt m_filesDone;
+    QAtomicInt m_times[PhaseCount];
+};
+
 class CppPreprocessor: public CPlusPlus::Client
 {
 public:
@@ -118,17 +179,29 @@ public:
     void setIncludePaths(const QStringList &includePaths);
     void setFrameworkPaths(const QStringList &frameworkPaths);
     void setProjectFiles(const QStringList &files);
+    void setIndexer(CppIndexer *indexer);
+    void setIndexCache(CppIndexCache *indexCache, uint configurationKey);
+    void setDirtyFiles(const QSet<QString> &files);
+    void setActiveLines(const QString &fileName, unsigned firstLine, unsigned lastLine);
     void run(QString &fileName);
     void operator()(QString &fileName);
 
 protected:
     CPlusPlus::Document::Ptr switchDocument(CPlusPlus::Document::Ptr doc);
+    CPlusPlus::Document::Ptr cachedDocument(const QString &fileName) const;
+
+    void processSource(const QString &fileName, const QByteArray &contents);
+    bool restoreFromCache(const CppIndexCache::Key &key, QByteArray *preprocessedCode);
+    void storeInCache(const CppIndexCache::Key &key, const QByteArray &preprocessedCode);
+    CppIndexCache::Key fileKey(const QString &fileName);
+    bool isUpToDate(const CppIndexCache::Key &key);
+    QList<CppIndexCache::Key> dependencies(CPlusPlus::Document::Ptr doc);
+    void defineMacro(const Macro &macro);
 
     bool includeFile(const QString &absoluteFilePath, QByteArray *result);
     QByteArray tryIncludeFile(QString &fileName, IncludeType type);
 
     void mergeEnvironment(CPlusPlus::Document::Ptr doc);
-    void mergeEnvironment(CPlusPlus::Document::Ptr doc, QSet<QString> *processed);
 
     virtual void macroAdded(const Macro &macro);
     virtual void startExpandingMacro(unsigned offset,
@@ -151,16 +224,116 @@ private:
     QStringList m_projectFiles;
     QStringList m_frameworkPaths;
     QSet<QString> m_included;
+    QSet<QString> m_merged; // files whose macros, and those of their includes, were
+                            // merged into env in this translation unit
+    QSet<QString> m_dirtyFiles; // files whose cache entries are out of date
+    QHash<QString, CppIndexCache::Key> m_fileKeys; // of the files read in this run
+    int m_nestedTime; // ms spent in the includes of the file being processed
     CPlusPlus::Document::Ptr m_currentDoc;
+    CppIndexer *m_indexer;
+    CppIndexCache *m_indexCache;
+    uint m_configurationKey;
+    QString m_activeFile;
+    unsigned m_firstActiveLine;
+    unsigned m_lastActiveLine;
 };
 
 } // namespace Internal
 } // namespace CppTools
 
+CppIndexer::CppIndexer(const Snapshot &snapshot, const QStringList &files, int workerCount)
+    : m_snapshot(snapshot),
+      m_fileCount(files.size()),
+      m_filesDone(0)
+{
+    workerCount = qBound(1, workerCount, qMax(1, files.size()));
+
+    const int chunk = files.size() / workerCount;
+    int start = 0;
+    for (int i = 0; i < workerCount; ++i) {
+        const int count = (i == workerCount - 1) ? files.size() - start : chunk;
+        m_queues.append(files.mid(start, count));
+        start += count;
+    }
+
+    for (int i = 0; i < PhaseCount; ++i)
+        m_times[i] = 0;
+}
+
+CppIndexer::~CppIndexer()
+{ qDeleteAll(m_preprocessors); }
+
+void CppIndexer::addPreprocessor(CppPreprocessor *preproc)
+{
+    preproc->setIndexer(this);
+    m_preprocessors.append(preproc);
+}
+
+bool CppIndexer::takeFile(int worker, QString *fileName)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QStringList &own = m_queues[worker];
+    if (! own.isEmpty()) {
+        *fileName = own.takeFirst();
+        return true;
+    }
+
+    // steal from the back of the longest queue.
+    int victim = -1;
+    for (int i = 0; i < m_queues.size(); ++i) {
+        if (m_queues.at(i).isEmpty())
+            continue;
+        else if (victim == -1 || m_queues.at(i).size() > m_queues.at(victim).size())
+            victim = i;
+    }
+
+    if (victim == -1)
+        return false;
+
+    *fileName = m_queues[victim].takeLast();
+    return true;
+}
+
+int CppIndexer::fileDone()
+{ return m_filesDone.fetchAndAddOrdered(1) + 1; }
+
+Document::Ptr CppIndexer::document(const QString &fileName) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_snapshot.value(fileName);
+}
+
+void CppIndexer::insertDocument(Document::Ptr doc)
+{
+    QMutexLocker locker(&m_mutex);
+    m_snapshot.insert(doc->fileName(), doc);
+}
+
+void CppIndexer::addTime(Phase phase, int msecs)
+{ m_times[phase].fetchAndAddRelaxed(msecs); }
+
+QString CppIndexer::timingSummary() const
+{
+    return QCoreApplication::translate("CppTools::Internal::CppIndexer",
+                                       "%1 files indexed by %2 threads.\n"
+                                       "Preprocess: %3 ms, parse: %4 ms, check: %5 ms")
+            .arg(m_fileCount).arg(m_queues.size())
+            .arg(int(m_times[PreprocessPhase]))
+            .arg(int(m_times[ParsePhase]))
+            .arg(int(m_times[CheckPhase]));
+}
+
 CppPreprocessor::CppPreprocessor(QPointer<CppModelManager> modelManager)
     : m_modelManager(modelManager),
     m_snapshot(modelManager->snapshot()),
-    m_proc(this, env)
+    m_proc(this, env),
+    m_indexer(0),
+    m_indexCache(0),
+    m_configurationKey(0),
+    m_nestedTime(0),
+    m_firstActiveLine(0),
+    m_lastActiveLine(0)
 { }
 
 void CppPreprocessor::setWorkingCopy(const QMap<QString, QByteArray> &workingCopy)
@@ -175,8 +348,33 @@ void CppPreprocessor::setFrameworkPaths(const QStringList &frameworkPaths)
 void CppPreprocessor::setProjectFiles(const QStringList &files)
 { m_projectFiles = files; }
 
+void CppPreprocessor::setIndexer(CppIndexer *indexer)
+{ m_indexer = indexer; }
+
+void CppPreprocessor::setIndexCache(CppIndexCache *indexCache, uint configurationKey)
+{
+    m_indexCache = indexCache;
+    m_configurationKey = configurationKey;
+}
+
+void CppPreprocessor::setDirtyFiles(const QSet<QString> &files)
+{ m_dirtyFiles = files; }
+
+void CppPreprocessor::setActiveLines(const QString &fileName, unsigned firstLine, unsigned lastLine)
+{
+    m_activeFile = fileName;
+    m_firstActiveLine = firstLine;
+    m_lastActiveLine = lastLine;
+}
+
 void CppPreprocessor::run(QString &fileName)
-{ sourceNeeded(fileName, IncludeGlobal, /*line = */ 0); }
+{
+    // env outlives the translation unit, which may have undefined macros
+    // of the files merged so far; they are merged again when included.
+    m_merged.clear();
+
+    sourceNeeded(fileName, IncludeGlobal, /*line = */ 0);
+}
 
 void CppPreprocessor::operator()(QString &fileName)
 { run(fileName); }
@@ -321,25 +519,20 @@ void CppPreprocessor::stopExpandingMacro(unsigned, const Macro &)
 }
 
 void CppPreprocessor::mergeEnvironment(Document::Ptr doc)
-{
-    QSet<QString> processed;
-    mergeEnvironment(doc, &processed);
-}
-
-void CppPreprocessor::mergeEnvironment(Document::Ptr doc, QSet<QString> *processed)
 {
     if (! doc)
         return;
 
     const QString fn = doc->fileName();
 
-    if (processed->contains(fn))
+    // the macros of a file are merged only once, however often it is included.
+    if (m_merged.contains(fn))
         return;
 
-    processed->insert(fn);
+    m_merged.insert(fn);
 
     foreach (QString includedFile, doc->includedFiles()) {
-        mergeEnvironment(m_snapshot.value(includedFile), processed);
+        mergeEnvironment(cachedDocument(includedFile));
     }
 
     foreach (const Macro macro, doc->definedMacros()) {
@@ -384,36 +577,235 @@ void CppPreprocessor::sourceNeeded(QString &fileName, IncludeType type,
         }
     }
 
-    if (! contents.isEmpty()) {
-        Document::Ptr cachedDoc = m_snapshot.value(fileName);
-        if (cachedDoc && m_currentDoc) {
-            mergeEnvironment(cachedDoc);
-        } else {
-            Document::Ptr previousDoc = switchDocument(Document::create(fileName));
+    processSource(fileName, contents);
+}
+
+void CppPreprocessor::processSource(const QString &fileName, const QByteArray &contents)
+{
+    if (contents.isEmpty())
+        return;
+
+    Document::Ptr cachedDoc = cachedDocument(fileName);
+    if (cachedDoc && m_currentDoc) {
+        mergeEnvironment(cachedDoc);
+        return;
+    }
+
+    Document::Ptr previousDoc = switchDocument(Document::create(fileName));
+
+    if (fileName == m_activeFile) {
+        m_currentDoc->setSkipFunctionBody(true);
+        m_currentDoc->setActiveLines(m_firstActiveLine, m_lastActiveLine);
+    }
+
+    // the editor's working copy is never cached.
+    const bool cacheable = m_indexCache && ! m_workingCopy.contains(fileName);
+    CppIndexCache::Key key;
+    if (cacheable) {
+        key = CppIndexCache::key(fileName, contents, m_configurationKey);
+        m_fileKeys.insert(fileName, key);
+    }
 
-            const QByteArray previousFile = env.currentFile;
-            const unsigned previousLine = env.currentLine;
+    // The includes are processed while this file is preprocessed, their
+    // time is taken off the time of this file.
+    const int previousNestedTime = m_nestedTime;
+    m_nestedTime = 0;
 
-            env.currentFile = QByteArray(m_currentDoc->translationUnit()->fileName(),
-                                         m_currentDoc->translationUnit()->fileNameLength());
+    QTime total;
+    total.start();
+    QTime tm;
+    tm.start();
 
-            QByteArray preprocessedCode;
-            m_proc(contents, &preprocessedCode);
-            //qDebug() << preprocessedCode;
+    // the key of a dirty file is still valid, but one of its includes changed.
+    const bool restorable = cacheable && ! m_dirtyFiles.contains(fileName);
 
-            env.currentFile = previousFile;
-            env.currentLine = previousLine;
+    QByteArray preprocessedCode;
+    if (! (restorable && restoreFromCache(key, &preprocessedCode))) {
+        const QByteArray previousFile = env.currentFile;
+        const unsigned previousLine = env.currentLine;
+        QVector<unsigned> *previousLookups = env.lookups;
 
-            m_currentDoc->setSource(preprocessedCode);
-            m_currentDoc->parse();
-            m_currentDoc->check();
-            m_currentDoc->releaseTranslationUnit(); // release the AST and the token stream.
+        env.currentFile = QByteArray(m_currentDoc->translationUnit()->fileName(),
+                                     m_currentDoc->translationUnit()->fileNameLength());
 
-            if (m_modelManager)
-                m_modelManager->emitDocumentUpdated(m_currentDoc);
-            (void) switchDocument(previousDoc);
+        // the names looked up tell which macros the document depends on.
+        QVector<unsigned> lookups;
+        env.lookups = &lookups;
+
+        m_proc(contents, &preprocessedCode);
+        //qDebug() << preprocessedCode;
+
+        env.currentFile = previousFile;
+        env.currentLine = previousLine;
+        env.lookups = previousLookups;
+
+        m_currentDoc->setMacroLookups(lookups);
+
+        if (cacheable)
+            storeInCache(key, preprocessedCode);
+    }
+    m_merged.insert(fileName);
+
+    if (m_indexer)
+        m_indexer->addTime(CppIndexer::PreprocessPhase, tm.restart() - m_nestedTime);
+
+    m_currentDoc->setSource(preprocessedCode);
+    m_currentDoc->parse();
+
+    if (m_indexer)
+        m_indexer->addTime(CppIndexer::ParsePhase, tm.restart());
+
+    m_currentDoc->check();
+
+    if (m_indexer)
+        m_indexer->addTime(CppIndexer::CheckPhase, tm.elapsed());
+
+    m_currentDoc->releaseTranslationUnit(); // release the AST and the token stream.
+
+    if (m_indexer)
+        m_indexer->insertDocument(m_currentDoc);
+
+    if (m_modelManager)
+        m_modelManager->emitDocumentUpdated(m_currentDoc);
+    (void) switchDocument(previousDoc);
+
+    m_nestedTime = previousNestedTime + total.elapsed();
+}
+
+bool CppPreprocessor::restoreFromCache(const CppIndexCache::Key &key, QByteArray *preprocessedCode)
+{
+    CppIndexCache::Entry entry;
+    if (! m_indexCache->restore(key, &entry))
+        return false;
+
+    // the preprocessed code depends on every file that was included.
+    foreach (const CppIndexCache::Key &dependency, entry.dependencies) {
+        if (! isUpToDate(dependency))
+            return false;
+    }
+
+    // The includes and the macro definitions are replayed in source order,
+    // so that the snapshot and the environment look the same as if the file
+    // was preprocessed: an include that is preprocessed again sees the
+    // macros defined before it.
+    int macroIndex = 0;
+    foreach (const Document::Include &include, entry.includes) {
+        for (; macroIndex < entry.definedMacros.size(); ++macroIndex) {
+            const Macro &macro = entry.definedMacros.at(macroIndex);
+            if (macro.line() > include.line())
+                break;
+            defineMacro(macro);
+        }
+
+        QString includedFile = include.fileName();
+
+        // an include that is indexed already is not read again.
+        if (Document::Ptr includedDoc = cachedDocument(includedFile)) {
+            m_currentDoc->addIncludeFile(includedFile, include.line());
+            mergeEnvironment(includedDoc);
+            continue;
+        }
+
+        const QByteArray contents = tryIncludeFile(includedFile, IncludeLocal);
+        m_currentDoc->addIncludeFile(includedFile, include.line());
+        processSource(includedFile, contents);
+    }
+
+    for (; macroIndex < entry.definedMacros.size(); ++macroIndex)
+        defineMacro(entry.definedMacros.at(macroIndex));
+
+    foreach (const Document::Block &block, entry.skippedBlocks) {
+        m_currentDoc->startSkippingBlocks(block.begin());
+        m_currentDoc->stopSkippingBlocks(block.end());
+    }
+
+    foreach (const Document::DiagnosticMessage &m, entry.diagnosticMessages)
+        m_currentDoc->addDiagnosticMessage(m);
+
+    m_currentDoc->setMacroLookups(entry.macroLookups);
+
+    *preprocessedCode = entry.preprocessedCode;
+    return true;
+}
+
+void CppPreprocessor::storeInCache(const CppIndexCache::Key &key, const QByteArray &preprocessedCode)
+{
+    CppIndexCache::Entry entry;
+    entry.preprocessedCode = preprocessedCode;
+    entry.includes = m_currentDoc->includes();
+    entry.definedMacros = m_currentDoc->definedMacros();
+    entry.skippedBlocks = m_currentDoc->skippedBlocks();
+    entry.diagnosticMessages = m_currentDoc->diagnosticMessages();
+    entry.macroLookups = m_currentDoc->macroLookups();
+    entry.dependencies = dependencies(m_currentDoc);
+
+    // an include from the working copy can't be checked later on.
+    foreach (const CppIndexCache::Key &dependency, entry.dependencies) {
+        if (dependency.fileName.isEmpty())
+            return;
+    }
+
+    m_indexCache->store(key, entry);
+}
+
+// The key of a file that can't be read has no digest, it stops
+// matching when the file appears. Files of the working copy have no key.
+CppIndexCache::Key CppPreprocessor::fileKey(const QString &fileName)
+{
+    QHash<QString, CppIndexCache::Key>::const_iterator it = m_fileKeys.constFind(fileName);
+    if (it != m_fileKeys.constEnd())
+        return it.value();
+
+    CppIndexCache::Key key;
+    if (! m_workingCopy.contains(fileName)) {
+        QFile file(fileName);
+        if (file.open(QFile::ReadOnly)) {
+            QTextStream stream(&file);
+            key = CppIndexCache::key(fileName, stream.readAll().toUtf8(), m_configurationKey);
+        } else {
+            key.fileName = fileName;
+            key.configuration = m_configurationKey;
         }
     }
+
+    m_fileKeys.insert(fileName, key);
+    return key;
+}
+
+// A file whose modification time and size did not change is not read.
+bool CppPreprocessor::isUpToDate(const CppIndexCache::Key &key)
+{
+    if (! m_fileKeys.contains(key.fileName) && ! m_workingCopy.contains(key.fileName)
+            && ! key.digest.isEmpty()) {
+        const QFileInfo fileInfo(key.fileName);
+        if (fileInfo.isFile() && fileInfo.lastModified().toTime_t() == key.modified
+                && quint32(fileInfo.size()) == key.size)
+            return key.configuration == m_configurationKey;
+    }
+
+    return fileKey(key.fileName) == key;
+}
+
+QList<CppIndexCache::Key> CppPreprocessor::dependencies(Document::Ptr doc)
+{
+    QList<CppIndexCache::Key> keys;
+    QSet<QString> processed;
+    QStringList todo = doc->includedFiles();
+    while (! todo.isEmpty()) {
+        const QString fn = todo.takeLast();
+        if (processed.contains(fn))
+            continue;
+        processed.insert(fn);
+        keys.append(fileKey(fn));
+        if (Document::Ptr includedDoc = cachedDocument(fn))
+            todo += includedDoc->includedFiles();
+    }
+    return keys;
+}
+
+void CppPreprocessor::defineMacro(const Macro &macro)
+{
+    m_currentDoc->appendMacro(*env.bind(macro));
 }
 
 Document::Ptr CppPreprocessor::switchDocument(Document::Ptr doc)
@@ -423,7 +815,68 @@ Document::Ptr CppPreprocessor::switchDocument(Document::Ptr doc)
     return previousDoc;
 }
 
+Document::Ptr CppPreprocessor::cachedDocument(const QString &fileName) const
+{
+    if (m_indexer)
+        return m_indexer->document(fileName);
+
+    return m_snapshot.value(fileName);
+}
+
+
 
+namespace {
+
+// a name can be defined and undefined several times, all of them count.
+QHash<QByteArray, QString> macroDefinitions(const QList<Macro> &macros)
+{
+    QHash<QByteArray, QString> definitions;
+    foreach (const Macro &macro, macros) {
+        QString &definition = definitions[macro.name()];
+        definition += macro.toString();
+        definition += QLatin1Char('\n');
+    }
+    return definitions;
+}
+
+// Returns the hash codes of the names of the macros that are defined
+// differently by the two lists.
+QSet<unsigned> changedMacros(const QList<Macro> &previousMacros, const QList<Macro> &macros)
+{
+    const QHash<QByteArray, QString> previous = macroDefinitions(previousMacros);
+    const QHash<QByteArray, QString> current = macroDefinitions(macros);
+
+    QSet<unsigned> changed;
+
+    QHashIterator<QByteArray, QString> it(current);
+    while (it.hasNext()) {
+        it.next();
+        if (previous.value(it.key()) != it.value())
+            changed.insert(Environment::hashCode(it.key()));
+    }
+
+    QHashIterator<QByteArray, QString> previousIt(previous);
+    while (previousIt.hasNext()) {
+        previousIt.next();
+        if (! current.contains(previousIt.key()))
+            changed.insert(Environment::hashCode(previousIt.key()));
+    }
+
+    return changed;
+}
+
+// An include that was not found is recorded with the name it was spelled with.
+bool hasUnresolvedIncludes(Document::Ptr doc)
+{
+    foreach (const QString &includedFile, doc->includedFiles()) {
+        if (! QFileInfo(includedFile).isAbsolute()
+                && includedFile != QLatin1String(pp_configuration_file))
+            return true;
+    }
+    return false;
+}
+
+} // end of anonymous namespace
 
 /*!
     \class CppTools::CppModelManager
@@ -436,10 +889,27 @@ Document::Ptr CppPreprocessor::switchDocument(Document::Ptr doc)
 
 CppModelManager::CppModelManager(QObject *parent) :
     CppModelManagerInterface(parent),
-    m_core(ExtensionSystem::PluginManager::instance()->getObject<Core::ICore>())
+    m_core(ExtensionSystem::PluginManager::instance()->getObject<Core::ICore>()),
+    m_indexerWorkerCount(0)
 {
     m_dirty = true;
 
+    const QString configDir = QFileInfo(m_core->settings()->fileName()).path();
+    m_indexCache = new CppIndexCache(configDir + QLatin1String("/qtcreator/cppindex.cache"));
+    m_indexCache->open();
+
+    m_dependentFilesTimer = new QTimer(this);
+    m_dependentFilesTimer->setSingleShot(true);
+    m_dependentFilesTimer->setInterval(DEPENDENT_FILES_INTERVAL);
+    connect(m_dependentFilesTimer, SIGNAL(timeout()), this, SLOT(refreshDependentFiles()));
+
+    // the new cache entries are written out while working, too, so that
+    // they are not lost if Qt Creator does not shut down cleanly.
+    m_indexCacheTimer = new QTimer(this);
+    m_indexCacheTimer->setInterval(INDEX_CACHE_INTERVAL);
+    connect(m_indexCacheTimer, SIGNAL(timeout()), this, SLOT(writeIndexCache()));
+    m_indexCacheTimer->start();
+
     m_projectExplorer = ExtensionSystem::PluginManager::instance()
                         ->getObject<ProjectExplorer::ProjectExplorerPlugin>();
 
@@ -472,7 +942,27 @@ CppModelManager::CppModelManager(QObject *parent) :
 }
 
 CppModelManager::~CppModelManager()
-{ }
+{
+    qDeleteAll(m_symbolIndexes);
+    delete m_indexCache;
+}
+
+void CppModelManager::saveIndexCache()
+{
+    if (m_core->progressManager())
+        m_core->progressManager()->cancelTasks(CppTools::Constants::TASK_INDEX);
+
+    m_indexCacheTimer->stop();
+    m_indexCache->save(m_snapshot.keys());
+}
+
+// Unlike saveIndexCache(), this keeps the entries of the files that
+// were not indexed again yet.
+void CppModelManager::writeIndexCache()
+{
+    if (m_indexCache->hasPendingEntries())
+        m_indexCache->save(m_indexCache->fileNames());
+}
 
 Snapshot CppModelManager::snapshot() const
 { return m_snapshot; }
@@ -589,19 +1079,159 @@ void CppModelManager::updateProjectInfo(const ProjectInfo &pinfo)
     m_dirty = true;
 }
 
-QFuture<void> CppModelManager::refreshSourceFiles(const QStringList &sourceFiles)
+void CppModelManager::updateProjectSources(const ProjectInfo &pinfo)
 {
-    if (! sourceFiles.isEmpty() && qgetenv("QTCREATOR_NO_CODE_INDEXER").isNull()) {
-        const QMap<QString, QByteArray> workingCopy = buildWorkingCopyList();
+    if (! pinfo.isValid())
+        return;
+
+    const QByteArray previousMacros = definedMacros();
+    const QStringList previousPaths = includePaths() + frameworkPaths();
+
+    updateProjectInfo(pinfo);
+
+    QStringList files;
+    foreach (const QString &fileName, pinfo.sourceFiles) {
+        if (! m_snapshot.contains(fileName))
+            files.append(fileName);
+    }
+
+    // the new files might be found by includes that were not before.
+    if (! files.isEmpty()) {
+        QMapIterator<QString, Document::Ptr> it(m_snapshot);
+        while (it.hasNext()) {
+            it.next();
+            if (hasUnresolvedIncludes(it.value()))
+                files.append(it.key());
+        }
+    }
+
+    files += filesAffectedByPaths(previousPaths, includePaths() + frameworkPaths());
+    files.removeDuplicates();
+
+    // The documents that depend on the changed defines are reindexed once
+    // the configuration is preprocessed again, see onDocumentUpdated().
+    if (files.isEmpty() && definedMacros() != previousMacros)
+        files.append(QLatin1String(pp_configuration_file));
+
+    updateSourceFiles(files);
+}
+
+// Returns the documents that might include other files when the include
+// paths change from \a previousPaths to \a paths.
+QStringList CppModelManager::filesAffectedByPaths(const QStringList &previousPaths,
+                                                  const QStringList &paths) const
+{
+    QStringList files;
+    if (paths == previousPaths)
+        return files;
+
+    QStringList removedPaths;
+    foreach (const QString &path, previousPaths) {
+        if (! paths.contains(path))
+            removedPaths.append(QDir::cleanPath(path) + QLatin1Char('/'));
+    }
+
+    QStringList addedPaths;
+    foreach (const QString &path, paths) {
+        if (! previousPaths.contains(path))
+            addedPaths.append(QDir::cleanPath(path) + QLatin1Char('/'));
+    }
+
+    QStringList searchedPaths;
+    foreach (const QString &path, previousPaths)
+        searchedPaths.append(QDir::cleanPath(path) + QLatin1Char('/'));
+
+    QMapIterator<QString, Document::Ptr> it(m_snapshot);
+    while (it.hasNext()) {
+        it.next();
+        Document::Ptr doc = it.value();
+
+        // only the order changed, any include might be found somewhere else.
+        if (removedPaths.isEmpty() && addedPaths.isEmpty()) {
+            if (! doc->includedFiles().isEmpty())
+                files.append(it.key());
+            continue;
+        }
+
+        if (! addedPaths.isEmpty() && hasUnresolvedIncludes(doc)) {
+            files.append(it.key());
+            continue;
+        }
+
+        bool affected = false;
+        foreach (const QString &includedFile, doc->includedFiles()) {
+            foreach (const QString &path, removedPaths) {
+                if (includedFile.startsWith(path)) {
+                    affected = true;
+                    break;
+                }
+            }
+
+            // an added path can hide the file found in a previous one.
+            for (int i = 0; ! affected && i < searchedPaths.size(); ++i) {
+                const QString &path = searchedPaths.at(i);
+                if (! includedFile.startsWith(path))
+                    continue;
+
+                const QString relativeName = includedFile.mid(path.length());
+                foreach (const QString &addedPath, addedPaths) {
+                    if (QFileInfo(addedPath + relativeName).isFile()) {
+                        affected = true;
+                        break;
+                    }
+                }
+            }
+
+            if (affected)
+                break;
+        }
+
+        if (affected)
+            files.append(it.key());
+    }
+
+    return files;
+}
+
+void CppModelManager::setIndexerWorkerCount(int count)
+{ m_indexerWorkerCount = count; }
+
+int CppModelManager::indexerWorkerCount() const
+{ return m_indexerWorkerCount; }
+
+CppIndexer *CppModelManager::createIndexer(const QStringList &sourceFiles, int workerCount,
+                                           const QSet<QString> &dirtyFiles)
+{
+    const QMap<QString, QByteArray> workingCopy = buildWorkingCopyList();
+
+    const uint configurationKey = CppIndexCache::configurationKey(definedMacros(),
+                                                                  includePaths(),
+                                                                  frameworkPaths());
 
+    CppIndexer *indexer = new CppIndexer(m_snapshot, sourceFiles, workerCount);
+    for (int i = 0; i < indexer->workerCount(); ++i) {
         CppPreprocessor *preproc = new CppPreprocessor(this);
         preproc->setProjectFiles(projectFiles());
         preproc->setIncludePaths(includePaths());
         preproc->setFrameworkPaths(frameworkPaths());
         preproc->setWorkingCopy(workingCopy);
+        preproc->setIndexCache(m_indexCache, configurationKey);
+        preproc->setDirtyFiles(dirtyFiles);
+        indexer->addPreprocessor(preproc);
+    }
+    return indexer;
+}
+
+QFuture<void> CppModelManager::refreshSourceFiles(const QStringList &sourceFiles,
+                                                  const QSet<QString> &dirtyFiles)
+{
+    if (! sourceFiles.isEmpty() && qgetenv("QTCREATOR_NO_CODE_INDEXER").isNull()) {
+        int workerCount = m_indexerWorkerCount;
+        if (workerCount <= 0)
+            workerCount = QThread::idealThreadCount();
 
-        QFuture<void> result = QtConcurrent::run(&CppModelManager::parse,
-                                                 preproc, sourceFiles);
+        CppIndexer *indexer = createIndexer(sourceFiles, workerCount, dirtyFiles);
+        QFuture<void> result = QtConcurrent::run(&CppModelManager::parse, indexer);
 
         if (sourceFiles.count() > 1) {
             m_core->progressManager()->addTask(result, tr("Indexing"),
@@ -613,6 +1243,18 @@ QFuture<void> CppModelManager::refreshSourceFiles(const QStringList &sourceFiles
     return QFuture<void>();
 }
 
+QFuture<void> CppModelManager::refreshEditorDocument(const QString &fileName,
+                                                     unsigned firstLine,
+                                                     unsigned lastLine)
+{
+    if (qgetenv("QTCREATOR_NO_CODE_INDEXER").isNull()) {
+        CppIndexer *indexer = createIndexer(QStringList(fileName), 1);
+        indexer->preprocessor(0)->setActiveLines(fileName, firstLine, lastLine);
+        return QtConcurrent::run(&CppModelManager::parse, indexer);
+    }
+    return QFuture<void>();
+}
+
 /*!
     \fn    void CppModelManager::editorOpened(Core::IEditor *editor)
     \brief If a C++ editor is opened, the model manager listens to content changes
@@ -652,13 +1294,130 @@ bool CppModelManager::isCppEditor(Core::IEditor *editor) const
     return editor->context().contains(uid);
 }
 
+CppSymbolIndex *CppModelManager::symbolIndex(SearchSymbols::SymbolTypes symbolTypes,
+                                             bool separateScope)
+{
+    QMutexLocker locker(&mutex);
+
+    foreach (CppSymbolIndex *index, m_symbolIndexes) {
+        if (index->symbolTypes() == symbolTypes && index->separateScope() == separateScope)
+            return index;
+    }
+
+    CppSymbolIndex *index = new CppSymbolIndex(symbolTypes, separateScope);
+    foreach (Document::Ptr doc, m_snapshot)
+        index->updateDocument(doc);
+    m_symbolIndexes.append(index);
+    return index;
+}
+
+// Called by the indexer threads, so the symbols are searched there.
 void CppModelManager::emitDocumentUpdated(Document::Ptr doc)
-{ emit documentUpdated(doc); }
+{
+    mutex.lock();
+    const QList<CppSymbolIndex *> symbolIndexes = m_symbolIndexes;
+    mutex.unlock();
+
+    foreach (CppSymbolIndex *index, symbolIndexes)
+        index->updateDocument(doc);
+
+    emit documentUpdated(doc);
+}
+
+void CppModelManager::updateIncludeGraph(Document::Ptr previousDoc, Document::Ptr doc)
+{
+    if (previousDoc) {
+        const QString fileName = previousDoc->fileName();
+        foreach (const QString &includedFile, previousDoc->includedFiles()) {
+            QHash<QString, QSet<QString> >::iterator it = m_includedBy.find(includedFile);
+            if (it == m_includedBy.end())
+                continue;
+
+            it->remove(fileName);
+            if (it->isEmpty())
+                m_includedBy.erase(it);
+        }
+    }
+
+    if (doc) {
+        const QString fileName = doc->fileName();
+        foreach (const QString &includedFile, doc->includedFiles())
+            m_includedBy[includedFile].insert(fileName);
+    }
+}
+
+// Schedules the files that include \a fileName, directly or not, and looked
+// up one of the changed macros for reindexing.
+void CppModelManager::addDependentFiles(const QString &fileName,
+                                        const QSet<unsigned> &changedMacros)
+{
+    QStringList includers;
+    if (fileName == QLatin1String(pp_configuration_file)) {
+        // every document sees the configuration.
+        includers = m_snapshot.keys();
+    } else {
+        QSet<QString> processed;
+        QStringList todo(fileName);
+        while (! todo.isEmpty()) {
+            const QString fn = todo.takeLast();
+            foreach (const QString &includer, m_includedBy.value(fn)) {
+                if (! processed.contains(includer)) {
+                    processed.insert(includer);
+                    todo.append(includer);
+                }
+            }
+        }
+        includers = processed.toList();
+    }
+
+    foreach (const QString &includer, includers) {
+        if (includer == fileName)
+            continue;
+
+        Document::Ptr doc = m_snapshot.value(includer);
+        if (! doc)
+            continue;
+
+        foreach (unsigned hashCode, changedMacros) {
+            if (doc->hasMacroLookup(hashCode)) {
+                m_dependentFiles.insert(includer);
+                break;
+            }
+        }
+    }
+
+    if (! m_dependentFiles.isEmpty() && ! m_dependentFilesTimer->isActive())
+        m_dependentFilesTimer->start();
+}
+
+void CppModelManager::refreshDependentFiles()
+{
+    QSet<QString> files;
+    foreach (const QString &fileName, m_dependentFiles) {
+        if (m_snapshot.contains(fileName)) // not removed in the meantime
+            files.insert(fileName);
+    }
+    m_dependentFiles.clear();
+
+    // the contents did not change, so the cached entries are out of date.
+    (void) refreshSourceFiles(files.toList(), files);
+}
 
 void CppModelManager::onDocumentUpdated(Document::Ptr doc)
 {
     const QString fileName = doc->fileName();
+    Document::Ptr previousDoc = m_snapshot.value(fileName);
     m_snapshot[fileName] = doc;
+
+    updateIncludeGraph(previousDoc, doc);
+
+    if (previousDoc) {
+        const QSet<unsigned> changed = changedMacros(previousDoc->definedMacros(),
+                                                     doc->definedMacros());
+        if (! changed.isEmpty())
+            addDependentFiles(fileName, changed);
+    }
+
     QList<Core::IEditor *> openedEditors = m_core->editorManager()->openedEditors();
     foreach (Core::IEditor *editor, openedEditors) {
         if (editor->file()->fileName() == fileName) {
@@ -772,53 +1531,88 @@ void CppModelManager::onSessionUnloaded()
     GC();
 }
 
+namespace {
+
+class CppIndexerWorker: public QRunnable
+{
+public:
+    CppIndexerWorker(QFutureInterface<void> &future, CppIndexer *indexer, int worker)
+        : m_future(future), m_indexer(indexer), m_worker(worker)
+    { }
+
+    void run()
+    { CppModelManager::indexFiles(m_future, m_indexer, m_worker); }
+
+private:
+    QFutureInterface<void> &m_future;
+    CppIndexer *m_indexer;
+    int m_worker;
+};
+
+} // end of anonymous namespace
+
 void CppModelManager::parse(QFutureInterface<void> &future,
-                            CppPreprocessor *preproc,
-                            QStringList files)
+                            CppIndexer *indexer)
 {
-    QTC_ASSERT(!files.isEmpty(), return);
+    QTC_ASSERT(indexer->fileCount() != 0, delete indexer; return);
 
+    future.setProgressRange(0, indexer->fileCount());
+
+    // The calling thread is the first worker, the others run in a private
+    // pool so that they do not starve the global one.
+    QThreadPool pool;
+    pool.setMaxThreadCount(indexer->workerCount() - 1);
+    for (int i = 1; i < indexer->workerCount(); ++i)
+        pool.start(new CppIndexerWorker(future, indexer, i));
+
+    indexFiles(future, indexer, 0);
+    pool.waitForDone();
+
+    future.setProgressValueAndText(indexer->fileCount(), indexer->timingSummary());
+
+    delete indexer;
+}
+
+void CppModelManager::indexFiles(QFutureInterface<void> &future,
+                                 CppIndexer *indexer,
+                                 int worker)
+{
     // Change the priority of the background parser thread to idle.
     QThread::currentThread()->setPriority(QThread::IdlePriority);
 
-    future.setProgressRange(0, files.size());
+    CppPreprocessor *preproc = indexer->preprocessor(worker);
 
     QString conf = QLatin1String(pp_configuration_file);
     (void) preproc->run(conf);
 
-    const int STEP = 10;
-
-    for (int i = 0; i < files.size(); ++i) {
+    QString fileName;
+    while (indexer->takeFile(worker, &fileName)) {
         if (future.isPaused())
             future.waitForResume();
 
         if (future.isCanceled())
             break;
 
-        future.setProgressValue(i);
-
 #ifdef CPPTOOLS_DEBUG_PARSING_TIME
         QTime tm;
         tm.start();
 #endif
 
-        QString fileName = files.at(i);
         preproc->run(fileName);
 
-        if (! (i % STEP)) // Yields execution of the current thread.
-            QThread::yieldCurrentThread();
+        const int done = indexer->fileDone();
+        future.setProgressValue(done);
+
+        if (! (done % 10))
+            future.setProgressValueAndText(done, indexer->timingSummary());
 
 #ifdef CPPTOOLS_DEBUG_PARSING_TIME
         qDebug() << fileName << "parsed in:" << tm.elapsed();
 #endif
     }
 
-    future.setProgressValue(files.size());
-
     // Restore the previous thread priority.
     QThread::currentThread()->setPriority(QThread::NormalPriority);
-
-    delete preproc;
 }
 
 void CppModelManager::GC()
@@ -853,6 +1647,12 @@ void CppModelManager::GC()
         }
     }
 
+    foreach (const QString &fn, removedFiles)
+        updateIncludeGraph(m_snapshot.value(fn), Document::Ptr());
+
+    foreach (CppSymbolIndex *index, m_symbolIndexes)
+        index->removeFiles(removedFiles);
+
     emit aboutToRemoveFiles(removedFiles);
     m_snapshot = documents;
 }
@@ -35,12 +35,19 @@
 #define CPPMODELMANAGER_H
 
 #include <cpptools/cppmodelmanagerinterface.h>
+#include <cpptools/searchsymbols.h>
 #include <projectexplorer/project.h>
 #include <cplusplus/CppDocument.h>
 
+#include <QHash>
 #include <QMap>
 #include <QFutureInterface>
 #include <QMutex>
+#include <QSet>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
 
 namespace Core {
 class ICore;
@@ -59,7 +66,10 @@ namespace CppTools {
 namespace Internal {
 
 class CppEditorSupport;
+class CppIndexCache;
+class CppIndexer;
 class CppPreprocessor;
+class CppSymbolIndex;
 
 class CppModelManager : public CppModelManagerInterface
 {
@@ -74,11 +84,34 @@ public:
     virtual QList<ProjectInfo> projectInfos() const;
     virtual ProjectInfo projectInfo(ProjectExplorer::Project *project) const;
     virtual void updateProjectInfo(const ProjectInfo &pinfo);
+    virtual void updateProjectSources(const ProjectInfo &pinfo);
 
     virtual CPlusPlus::Snapshot snapshot() const;
     virtual void GC();
 
-    QFuture<void> refreshSourceFiles(const QStringList &sourceFiles);
+    // The dirty files are preprocessed again even if they are in the index cache.
+    QFuture<void> refreshSourceFiles(const QStringList &sourceFiles,
+                                     const QSet<QString> &dirtyFiles = QSet<QString>());
+
+    // Reparses the document of an editor. Only the function bodies
+    // overlapping the given (1-based) lines are parsed and checked.
+    QFuture<void> refreshEditorDocument(const QString &fileName,
+                                        unsigned firstLine,
+                                        unsigned lastLine);
+
+    // 0 means one worker per core.
+    void setIndexerWorkerCount(int count);
+    int indexerWorkerCount() const;
+
+    void saveIndexCache();
+
+    // The symbols of the snapshot, found with the given settings.
+    // The index is kept up to date as documents are updated or removed.
+    CppSymbolIndex *symbolIndex(SearchSymbols::SymbolTypes symbolTypes, bool separateScope);
+
+    static void indexFiles(QFutureInterface<void> &future,
+                           CppIndexer *indexer,
+                           int worker);
 
     inline Core::ICore *core() const { return m_core; }
 
@@ -102,9 +135,19 @@ private Q_SLOTS:
     void onAboutToRemoveProject(ProjectExplorer::Project *project);
     void onSessionUnloaded();
     void onProjectAdded(ProjectExplorer::Project *project);
+    void refreshDependentFiles();
+    void writeIndexCache();
 
 private:
     QMap<QString, QByteArray> buildWorkingCopyList();
+    CppIndexer *createIndexer(const QStringList &sourceFiles, int workerCount,
+                              const QSet<QString> &dirtyFiles = QSet<QString>());
+
+    void updateIncludeGraph(CPlusPlus::Document::Ptr previousDoc,
+                            CPlusPlus::Document::Ptr doc);
+    void addDependentFiles(const QString &fileName, const QSet<unsigned> &changedMacros);
+    QStringList filesAffectedByPaths(const QStringList &previousPaths,
+                                     const QStringList &paths) const;
 
     QStringList projectFiles()
     {
@@ -137,8 +180,7 @@ private:
     QByteArray internalDefinedMacros() const;
 
     static void parse(QFutureInterface<void> &future,
-                      CppPreprocessor *preproc,
-                      QStringList files);
+                      CppIndexer *indexer);
 
 private:
     Core::ICore *m_core;
@@ -152,16 +194,28 @@ private:
     QStringList m_frameworkPaths;
     QByteArray m_definedMacros;
 
+    int m_indexerWorkerCount;
+    CppIndexCache *m_indexCache;
+    QList<CppSymbolIndex *> m_symbolIndexes;
+
     // editor integration
     QMap<TextEditor::ITextEditor *, CppEditorSupport *> m_editorSupport;
 
     // project integration
     QMap<ProjectExplorer::Project *, ProjectInfo> m_projects;
 
+    // dependency tracking
+    QHash<QString, QSet<QString> > m_includedBy; // reverse include graph
+    QSet<QString> m_dependentFiles; // files to reindex because of a changed include
+    QTimer *m_dependentFilesTimer;
+    QTimer *m_indexCacheTimer;
+
     mutable QMutex mutex;
 
     enum {
-        MAX_SELECTION_COUNT = 5
+        MAX_SELECTION_COUNT = 5,
+        DEPENDENT_FILES_INTERVAL = 500,
+        INDEX_CACHE_INTERVAL = 5 * 60 * 1000
     };
 };
 
@@ -91,6 +91,10 @@ public:
     virtual QList<ProjectInfo> projectInfos() const = 0;
     virtual ProjectInfo projectInfo(ProjectExplorer::Project *project) const = 0;
     virtual void updateProjectInfo(const ProjectInfo &pinfo) = 0;
+
+    // Like updateProjectInfo(), but also reindexes the documents affected
+    // by the new source files, include paths and defines of the project.
+    virtual void updateProjectSources(const ProjectInfo &pinfo) = 0;
 };
 
 } // namespace CppTools
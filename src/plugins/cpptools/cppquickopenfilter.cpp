@@ -33,6 +33,7 @@
 
 #include "cppquickopenfilter.h"
 #include "cppmodelmanager.h"
+#include "cppsymbolindex.h"
 
 #include <coreplugin/editormanager/editormanager.h>
 #include <coreplugin/editormanager/ieditor.h>
@@ -41,35 +42,20 @@
 
 using namespace CppTools::Internal;
 
-CppQuickOpenFilter::CppQuickOpenFilter(CppModelManager *manager, Core::EditorManager *editorManager)
+CppQuickOpenFilter::CppQuickOpenFilter(CppModelManager *manager, Core::EditorManager *editorManager,
+                                       SearchSymbols::SymbolTypes symbolTypes,
+                                       bool separateScope)
     : m_manager(manager),
     m_editorManager(editorManager),
-    m_forceNewSearchList(true)
+    m_index(manager->symbolIndex(symbolTypes, separateScope))
 {
     setShortcutString(":");
     setIncludedByDefault(false);
-
-    connect(manager, SIGNAL(documentUpdated(CPlusPlus::Document::Ptr)),
-            this, SLOT(onDocumentUpdated(CPlusPlus::Document::Ptr)));
-
-    connect(manager, SIGNAL(aboutToRemoveFiles(QStringList)),
-            this, SLOT(onAboutToRemoveFiles(QStringList)));
 }
 
 CppQuickOpenFilter::~CppQuickOpenFilter()
 { }
 
-void CppQuickOpenFilter::onDocumentUpdated(CPlusPlus::Document::Ptr doc)
-{
-    m_searchList[doc->fileName()] = Info(doc);
-}
-
-void CppQuickOpenFilter::onAboutToRemoveFiles(const QStringList &files)
-{
-    foreach (const QString &file, files)
-        m_searchList.remove(file);
-}
-
 void CppQuickOpenFilter::refresh(QFutureInterface<void> &future)
 {
     Q_UNUSED(future);
@@ -81,38 +67,22 @@ static bool compareLexigraphically(const QuickOpen::FilterEntry &a,
     return a.displayName < b.displayName;
 }
 
-QList<QuickOpen::FilterEntry> CppQuickOpenFilter::matchesFor(const QString &origEntry)
+QList<QuickOpen::FilterEntry> CppQuickOpenFilter::matchesFor(QFutureInterface<QuickOpen::FilterEntry> &future,
+                                                             const QString &origEntry)
 {
     QString entry = trimWildcards(origEntry);
     QList<QuickOpen::FilterEntry> entries;
-    QStringMatcher matcher(entry, Qt::CaseInsensitive);
     const QRegExp regexp("*"+entry+"*", Qt::CaseInsensitive, QRegExp::Wildcard);
     if (!regexp.isValid())
         return entries;
-    bool hasWildcard = (entry.contains('*') || entry.contains('?'));
-
-    QMutableMapIterator<QString, Info> it(m_searchList);
-    while (it.hasNext()) {
-        it.next();
-
-        Info info = it.value();
-        if (info.dirty) {
-            info.dirty = false;
-            info.items = search(info.doc);
-            it.setValue(info);
-        }
-
-        QList<ModelItemInfo> items = info.items;
 
-        foreach (ModelItemInfo info, items) {
-            if ((hasWildcard && regexp.exactMatch(info.symbolName))
-                    || (!hasWildcard && matcher.indexIn(info.symbolName) != -1)) {
-                QVariant id = qVariantFromValue(info);
-                QuickOpen::FilterEntry filterEntry(this, info.symbolName, id, info.icon);
-                filterEntry.extraInfo = info.symbolType;
-                entries.append(filterEntry);
-            }
-        }
+    foreach (const ModelItemInfo &info, m_index->find(entry, &future)) {
+        if (future.isCanceled())
+            return QList<QuickOpen::FilterEntry>();
+        QVariant id = qVariantFromValue(info);
+        QuickOpen::FilterEntry filterEntry(this, info.symbolName, id, info.icon);
+        filterEntry.extraInfo = info.symbolType;
+        entries.append(filterEntry);
     }
 
     if (entries.size() < 1000)
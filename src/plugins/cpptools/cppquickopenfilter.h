@@ -46,45 +46,30 @@ namespace CppTools {
 namespace Internal {
 
 class CppModelManager;
+class CppSymbolIndex;
 
 class CppQuickOpenFilter : public QuickOpen::IQuickOpenFilter
 {
     Q_OBJECT
 public:
-    CppQuickOpenFilter(CppModelManager *manager, Core::EditorManager *editorManager);
+    CppQuickOpenFilter(CppModelManager *manager, Core::EditorManager *editorManager,
+                       SearchSymbols::SymbolTypes symbolTypes
+                           = SearchSymbols::Classes | SearchSymbols::Functions | SearchSymbols::Enums,
+                       bool separateScope = false);
     ~CppQuickOpenFilter();
 
     QString trName() const { return tr("Classes and Methods"); }
     QString name() const { return QLatin1String("Classes and Methods"); }
     Priority priority() const { return Medium; }
-    QList<QuickOpen::FilterEntry> matchesFor(const QString &entry);
+    QList<QuickOpen::FilterEntry> matchesFor(QFutureInterface<QuickOpen::FilterEntry> &future,
+                                             const QString &entry);
     void accept(QuickOpen::FilterEntry selection) const;
     void refresh(QFutureInterface<void> &future);
 
-protected:
-    SearchSymbols search;
-
-private slots:
-    void onDocumentUpdated(CPlusPlus::Document::Ptr doc);
-    void onAboutToRemoveFiles(const QStringList &files);
-
 private:
     CppModelManager *m_manager;
     Core::EditorManager *m_editorManager;
-
-    struct Info {
-        Info(): dirty(true) {}
-        Info(CPlusPlus::Document::Ptr doc): doc(doc), dirty(true) {}
-
-        CPlusPlus::Document::Ptr doc;
-        QList<ModelItemInfo> items;
-        bool dirty;
-    };
-
-    QMap<QString, Info> m_searchList;
-    QList<ModelItemInfo> m_previousResults;
-    bool m_forceNewSearchList;
-    QString m_previousEntry;
+    CppSymbolIndex *m_index;
 };
 
 } // namespace Internal
@@ -0,0 +1,235 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "cppsymbolindex.h"
+
+#include <QtCore/QReadLocker>
+#include <QtCore/QRegExp>
+#include <QtCore/QWriteLocker>
+
+using namespace CppTools::Internal;
+using namespace CPlusPlus;
+
+static inline quint64 trigram(const QString &key, int i)
+{
+    return (quint64(key.at(i).unicode()) << 32)
+            | (quint64(key.at(i + 1).unicode()) << 16)
+            | quint64(key.at(i + 2).unicode());
+}
+
+CppSymbolIndex::CppSymbolIndex(SearchSymbols::SymbolTypes symbolTypes, bool separateScope)
+    : m_symbolTypes(symbolTypes),
+      m_separateScope(separateScope),
+      m_trigramCount(0),
+      m_staleTrigramCount(0)
+{ }
+
+CppSymbolIndex::~CppSymbolIndex()
+{ }
+
+SearchSymbols::SymbolTypes CppSymbolIndex::symbolTypes() const
+{ return m_symbolTypes; }
+
+bool CppSymbolIndex::separateScope() const
+{ return m_separateScope; }
+
+void CppSymbolIndex::updateDocument(Document::Ptr doc)
+{
+    if (! m_search.hasLocalData()) {
+        SearchSymbols *search = new SearchSymbols;
+        search->setSymbolsToSearchFor(m_symbolTypes);
+        search->setSeparateScope(m_separateScope);
+        m_search.setLocalData(search);
+    }
+
+    const QString fileName = doc->fileName();
+    const QList<ModelItemInfo> items = (*m_search.localData())(doc);
+
+    QWriteLocker locker(&m_lock);
+    removeFile(fileName);
+    foreach (const ModelItemInfo &info, items)
+        insertItem(fileName, info);
+}
+
+void CppSymbolIndex::removeFiles(const QStringList &fileNames)
+{
+    QWriteLocker locker(&m_lock);
+    foreach (const QString &fileName, fileNames)
+        removeFile(fileName);
+}
+
+void CppSymbolIndex::clear()
+{
+    QWriteLocker locker(&m_lock);
+    m_names.clear();
+    m_nameIds.clear();
+    m_freeNameIds.clear();
+    m_namesOfFile.clear();
+    m_trigrams.clear();
+    m_trigramCount = 0;
+    m_staleTrigramCount = 0;
+}
+
+QList<ModelItemInfo> CppSymbolIndex::find(const QString &text,
+                                          const QFutureInterfaceBase *future) const
+{
+    QList<ModelItemInfo> result;
+
+    const QString key = text.toLower();
+    const bool hasWildcard = text.contains(QLatin1Char('*')) || text.contains(QLatin1Char('?'));
+    const QRegExp regexp(QLatin1Char('*') + text + QLatin1Char('*'),
+                         Qt::CaseInsensitive, QRegExp::Wildcard);
+    if (hasWildcard && ! regexp.isValid())
+        return result;
+
+    // The longest part without wildcards selects the candidates. Character
+    // sets are not taken apart, patterns with them test every name.
+    QString literal;
+    if (! hasWildcard) {
+        literal = key;
+    } else if (! key.contains(QLatin1Char('['))) {
+        foreach (const QString &part, key.split(QRegExp(QLatin1String("[*?]")))) {
+            if (part.size() > literal.size())
+                literal = part;
+        }
+    }
+
+    QReadLocker locker(&m_lock);
+
+    QVector<int> candidates;
+    const bool testAll = literal.size() < 3;
+    if (! testAll) {
+        const QVector<int> *rarest = 0;
+        for (int i = 0; i + 2 < literal.size(); ++i) {
+            QHash<quint64, QVector<int> >::const_iterator it = m_trigrams.constFind(trigram(literal, i));
+            if (it == m_trigrams.constEnd())
+                return result;
+            if (! rarest || it.value().size() < rarest->size())
+                rarest = &it.value();
+        }
+        candidates = *rarest;
+        qSort(candidates);
+    }
+
+    const int count = testAll ? m_names.size() : candidates.size();
+    for (int i = 0; i != count; ++i) {
+        if (future && (i & 1023) == 0 && future->isCanceled())
+            break;
+
+        if (! testAll && i && candidates.at(i) == candidates.at(i - 1))
+            continue;
+
+        const Name &name = m_names.at(testAll ? i : candidates.at(i));
+        if (name.items.isEmpty())
+            continue;
+        if (hasWildcard ? ! regexp.exactMatch(name.text) : ! name.key.contains(key))
+            continue;
+
+        foreach (const Item &item, name.items)
+            result.append(item.info);
+    }
+
+    return result;
+}
+
+void CppSymbolIndex::removeFile(const QString &fileName)
+{
+    foreach (int id, m_namesOfFile.take(fileName)) {
+        QList<Item> &items = m_names[id].items;
+        for (int i = items.size() - 1; i >= 0; --i) {
+            if (items.at(i).document == fileName)
+                items.removeAt(i);
+        }
+        if (items.isEmpty())
+            releaseName(id);
+    }
+
+    if (m_staleTrigramCount > m_trigramCount / 2) {
+        m_trigrams.clear();
+        m_trigramCount = 0;
+        m_staleTrigramCount = 0;
+        for (int id = 0; id < m_names.size(); ++id) {
+            if (! m_names.at(id).items.isEmpty())
+                insertTrigrams(id);
+        }
+    }
+}
+
+void CppSymbolIndex::insertItem(const QString &fileName, const ModelItemInfo &info)
+{
+    int id = m_nameIds.value(info.symbolName, -1);
+    if (id == -1) {
+        Name name;
+        name.text = info.symbolName;
+        name.key = info.symbolName.toLower();
+        if (m_freeNameIds.isEmpty()) {
+            id = m_names.size();
+            m_names.append(name);
+        } else {
+            id = m_freeNameIds.takeLast();
+            m_names[id] = name;
+        }
+        m_nameIds.insert(name.text, id);
+        insertTrigrams(id);
+    }
+
+    Name &name = m_names[id];
+
+    // the items of a document are inserted in one go.
+    if (name.items.isEmpty() || name.items.last().document != fileName)
+        m_namesOfFile[fileName].append(id);
+
+    Item item;
+    item.document = fileName;
+    item.info = info;
+    item.info.symbolName = name.text; // share the string
+    name.items.append(item);
+}
+
+void CppSymbolIndex::releaseName(int id)
+{
+    Name &name = m_names[id];
+    m_nameIds.remove(name.text);
+    m_staleTrigramCount += qMax(0, name.key.size() - 2);
+    name = Name();
+    m_freeNameIds.append(id);
+}
+
+void CppSymbolIndex::insertTrigrams(int id)
+{
+    const QString &key = m_names.at(id).key;
+    for (int i = 0; i + 2 < key.size(); ++i) {
+        m_trigrams[trigram(key, i)].append(id);
+        ++m_trigramCount;
+    }
+}
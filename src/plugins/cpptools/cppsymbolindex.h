@@ -0,0 +1,117 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#ifndef CPPSYMBOLINDEX_H
+#define CPPSYMBOLINDEX_H
+
+#include "searchsymbols.h"
+
+#include <QtCore/QFutureInterface>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
+
+namespace CppTools {
+namespace Internal {
+
+/*
+    Index of the symbols searched by the locator filters.
+
+    Every symbol name is stored once, together with the symbols of that
+    name from all documents. Names are found through the trigrams of their
+    lower case form: a query only verifies the names listed for its rarest
+    trigram instead of testing every symbol of every document.
+
+    Documents are searched for symbols by the thread that updates them, the
+    index is locked only to replace the items of the document.
+*/
+class CppSymbolIndex
+{
+public:
+    CppSymbolIndex(SearchSymbols::SymbolTypes symbolTypes, bool separateScope);
+    ~CppSymbolIndex();
+
+    SearchSymbols::SymbolTypes symbolTypes() const;
+    bool separateScope() const;
+
+    void updateDocument(CPlusPlus::Document::Ptr doc);
+    void removeFiles(const QStringList &fileNames);
+    void clear();
+
+    // Case insensitive substring match, '*' and '?' are wildcards.
+    // Stops early, with a partial result, once future is canceled.
+    QList<ModelItemInfo> find(const QString &text,
+                              const QFutureInterfaceBase *future = 0) const;
+
+private:
+    struct Item
+    {
+        QString document;
+        ModelItemInfo info;
+    };
+
+    struct Name
+    {
+        QString text;
+        QString key; // lower case
+        QList<Item> items;
+    };
+
+    void removeFile(const QString &fileName);
+    void insertItem(const QString &fileName, const ModelItemInfo &info);
+    void releaseName(int id);
+    void insertTrigrams(int id);
+
+    SearchSymbols::SymbolTypes m_symbolTypes;
+    bool m_separateScope;
+    QThreadStorage<SearchSymbols *> m_search;
+
+    mutable QReadWriteLock m_lock;
+    QVector<Name> m_names;
+    QHash<QString, int> m_nameIds;
+    QList<int> m_freeNameIds;
+    QHash<QString, QList<int> > m_namesOfFile;
+
+    // Released names stay in the lists until there are as many of them
+    // as there are live ones.
+    QHash<quint64, QVector<int> > m_trigrams;
+    int m_trigramCount;
+    int m_staleTrigramCount;
+};
+
+} // namespace Internal
+} // namespace CppTools
+
+#endif // CPPSYMBOLINDEX_H
@@ -13,13 +13,17 @@ HEADERS += cpptools_global.h \
     cppclassesfilter.h \
     searchsymbols.h \
     cppfunctionsfilter.h \
-    completionsettingspage.h
+    completionsettingspage.h \
+    cppindexcache.h \
+    cppsymbolindex.h
 SOURCES += cppquickopenfilter.cpp \
     cpptoolseditorsupport.cpp \
     cppclassesfilter.cpp \
     searchsymbols.cpp \
     cppfunctionsfilter.cpp \
-    completionsettingspage.cpp
+    completionsettingspage.cpp \
+    cppindexcache.cpp \
+    cppsymbolindex.cpp
 
 # Input
 SOURCES += cpptoolsplugin.cpp \
@@ -37,18 +37,29 @@
 #include <texteditor/itexteditor.h>
 
 #include <QTimer>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QPlainTextEdit>
 
 using namespace CppTools::Internal;
 
 CppEditorSupport::CppEditorSupport(CppModelManager *modelManager)
     : QObject(modelManager),
       _modelManager(modelManager),
-      _updateDocumentInterval(UPDATE_DOCUMENT_DEFAULT_INTERVAL)
+      _updateDocumentInterval(UPDATE_DOCUMENT_DEFAULT_INTERVAL),
+      _firstEditedLine(-1),
+      _lastEditedLine(-1),
+      _blockCount(0)
 {
     _updateDocumentTimer = new QTimer(this);
     _updateDocumentTimer->setSingleShot(true);
     _updateDocumentTimer->setInterval(_updateDocumentInterval);
     connect(_updateDocumentTimer, SIGNAL(timeout()), this, SLOT(updateDocumentNow()));
+
+    _fullUpdateDocumentTimer = new QTimer(this);
+    _fullUpdateDocumentTimer->setSingleShot(true);
+    _fullUpdateDocumentTimer->setInterval(FULL_UPDATE_DOCUMENT_INTERVAL);
+    connect(_fullUpdateDocumentTimer, SIGNAL(timeout()), this, SLOT(updateDocumentFully()));
 }
 
 CppEditorSupport::~CppEditorSupport()
@@ -64,6 +75,12 @@ void CppEditorSupport::setTextEditor(TextEditor::ITextEditor *textEditor)
     if (! _textEditor)
         return;
 
+    if (QPlainTextEdit *edit = qobject_cast<QPlainTextEdit *>(_textEditor->widget())) {
+        _blockCount = edit->document()->blockCount();
+        connect(edit->document(), SIGNAL(contentsChange(int,int,int)),
+                this, SLOT(onContentsChange(int,int,int)));
+    }
+
     connect(_textEditor, SIGNAL(contentsChanged()), this, SLOT(updateDocument()));
     updateDocument();
 }
@@ -85,12 +102,59 @@ void CppEditorSupport::setUpdateDocumentInterval(int updateDocumentInterval)
 void CppEditorSupport::updateDocument()
 { _updateDocumentTimer->start(_updateDocumentInterval); }
 
+void CppEditorSupport::onContentsChange(int position, int /*charsRemoved*/, int charsAdded)
+{
+    QTextDocument *document = qobject_cast<QTextDocument *>(sender());
+    if (! document)
+        return;
+
+    const int firstLine = document->findBlock(position).blockNumber();
+    const int lastLine = document->findBlock(position + charsAdded).blockNumber();
+    const int delta = document->blockCount() - _blockCount;
+    _blockCount = document->blockCount();
+
+    if (_lastEditedLine == -1) {
+        _firstEditedLine = firstLine;
+        _lastEditedLine = lastLine;
+        return;
+    }
+
+    // the lines edited before move with the inserted or removed lines.
+    if (_lastEditedLine > firstLine)
+        _lastEditedLine = qMax(firstLine, _lastEditedLine + delta);
+
+    _firstEditedLine = qMin(_firstEditedLine, firstLine);
+    _lastEditedLine = qMax(_lastEditedLine, lastLine);
+}
+
 void CppEditorSupport::updateDocumentNow()
 {
     if (_documentParser.isRunning()) {
         _updateDocumentTimer->start(_updateDocumentInterval);
+    } else if (_lastEditedLine == -1) {
+        updateDocumentFully();
+    } else {
+        // Reparse the function bodies around the edited lines now,
+        // and the whole document once the user stops typing.
+        _updateDocumentTimer->stop();
+        _documentParser = _modelManager->refreshEditorDocument(_textEditor->file()->fileName(),
+                                                               _firstEditedLine + 1,
+                                                               _lastEditedLine + 1);
+        _firstEditedLine = -1;
+        _lastEditedLine = -1;
+        _fullUpdateDocumentTimer->start();
+    }
+}
+
+void CppEditorSupport::updateDocumentFully()
+{
+    if (_documentParser.isRunning()) {
+        _fullUpdateDocumentTimer->start();
     } else {
         _updateDocumentTimer->stop();
+        _fullUpdateDocumentTimer->stop();
+        _firstEditedLine = -1;
+        _lastEditedLine = -1;
         QStringList sourceFiles(_textEditor->file()->fileName());
         _documentParser = _modelManager->refreshSourceFiles(sourceFiles);
     }
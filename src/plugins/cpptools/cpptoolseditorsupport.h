@@ -70,15 +70,26 @@ public:
 private Q_SLOTS:
     void updateDocument();
     void updateDocumentNow();
+    void updateDocumentFully();
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
 
 private:
-    enum { UPDATE_DOCUMENT_DEFAULT_INTERVAL = 150 };
+    enum {
+        UPDATE_DOCUMENT_DEFAULT_INTERVAL = 150,
+        FULL_UPDATE_DOCUMENT_INTERVAL = 1000
+    };
 
     CppModelManager *_modelManager;
     QPointer<TextEditor::ITextEditor> _textEditor;
     QTimer *_updateDocumentTimer;
+    QTimer *_fullUpdateDocumentTimer;
     int _updateDocumentInterval;
     QFuture<void> _documentParser;
+
+    // the lines edited since the last update, -1 if unknown.
+    int _firstEditedLine;
+    int _lastEditedLine;
+    int _blockCount;
 };
 
 } // namespace Internal
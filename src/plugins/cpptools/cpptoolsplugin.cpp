@@ -122,6 +122,9 @@ bool CppToolsPlugin::initialize(const QStringList & /*arguments*/, QString *)
     m_completion->setAutoInsertBraces(settings->value(QLatin1String("AutoInsertBraces"), true).toBool());
     m_completion->setPartialCompletionEnabled(settings->value(QLatin1String("PartiallyComplete"), true).toBool());
     settings->endGroup();
+    settings->beginGroup(QLatin1String("Indexer"));
+    m_modelManager->setIndexerWorkerCount(settings->value(QLatin1String("WorkerCount"), 0).toInt());
+    settings->endGroup();
     settings->endGroup();
 
     return true;
@@ -133,6 +136,8 @@ void CppToolsPlugin::extensionsInitialized()
 
 void CppToolsPlugin::shutdown()
 {
+    m_modelManager->saveIndexCache();
+
     // Save settings
     QSettings *settings = m_core->settings();
     settings->beginGroup(QLatin1String("CppTools"));
@@ -141,6 +146,9 @@ void CppToolsPlugin::shutdown()
     settings->setValue(QLatin1String("AutoInsertBraces"), m_completion->autoInsertBraces());
     settings->setValue(QLatin1String("PartiallyComplete"), m_completion->isPartialCompletionEnabled());
     settings->endGroup();
+    settings->beginGroup(QLatin1String("Indexer"));
+    settings->setValue(QLatin1String("WorkerCount"), m_modelManager->indexerWorkerCount());
+    settings->endGroup();
     settings->endGroup();
 }
 
@@ -269,6 +269,10 @@ void GdbEngine::init()
 
     m_oldestAcceptableToken = -1;
 
+    m_inbufferPos = 0;
+    m_inbufferComplete = 0;
+    m_responsePending = false;
+
     // Gdb Process interaction
     connect(&m_gdbProc, SIGNAL(error(QProcess::ProcessError)), this,
         SLOT(gdbProcError(QProcess::ProcessError)));
@@ -380,8 +384,11 @@ void GdbEngine::handleResponse()
 {
     static QTime lastTime;
 
+    m_responsePending = false;
+
     emit gdbOutputAvailable("            ", currentTime());
-    emit gdbOutputAvailable("stdout:", m_inbuffer);
+    emit gdbOutputAvailable("stdout:", QString::fromAscii(m_inbuffer.constData() + m_inbufferPos,
+                                                          m_inbufferComplete - m_inbufferPos));
 
 #if 0
     qDebug() // << "#### start response handling #### "
@@ -396,13 +403,15 @@ void GdbEngine::handleResponse()
 
     lastTime = QTime::currentTime();
 
+    // Only the complete lines are looked at. The position is updated before
+    // each record is handled, handlers may cause more output to be read.
+    bool waitForMore = false;
     while (1) {
-        if (m_inbuffer.isEmpty())
+        if (m_inbufferPos >= m_inbufferComplete)
             break;
 
-        const char *from = m_inbuffer.constData();
-        // FIXME: check for line ending in '\n(gdb)\n'
-        const char *to = from + m_inbuffer.size();
+        const char *from = m_inbuffer.constData() + m_inbufferPos;
+        const char *to = m_inbuffer.constData() + m_inbufferComplete;
         const char *inner;
 
         //const char *oldfrom = from;
@@ -423,6 +432,7 @@ void GdbEngine::handleResponse()
 
         if (from == to) {
             //qDebug() << "Returning: " << toString();
+            m_inbufferPos = m_inbufferComplete;
             break;
         }
 
@@ -437,7 +447,7 @@ void GdbEngine::handleResponse()
             //qDebug() << "UNREQUESTED DATA " << s << " TAKEN AS APPLICATION OUTPUT";
             //s += '\n';
 
-            m_inbuffer = QByteArray(from, to - from);
+            m_inbufferPos = from - m_inbuffer.constData();
             emit applicationOutputAvailable("app-stdout: ", s);
             continue;
         }
@@ -460,19 +470,13 @@ void GdbEngine::handleResponse()
                 //qDebug() << "ASYNCCLASS" << asyncClass;
 
                 GdbMi record;
-                while (from != to && *from == ',') {
+                if (from != to && *from == ',') {
                     ++from; // skip ','
-                    GdbMi data;
-                    data.parseResultOrValue(from, to);
-                    if (data.isValid()) {
-                        //qDebug() << "parsed response: " << data.toString();
-                        record.m_children += data;
-                        record.m_type = GdbMi::Tuple;
-                    }
+                    record.fromResults(from, to);
                 }
                 //dump(oldfrom, from, record.toString());
                 skipTerminator(from, to);
-                m_inbuffer = QByteArray(from, to - from);
+                m_inbufferPos = from - m_inbuffer.constData();
                 if (asyncClass == "stopped") {
                     handleAsyncOutput(record);
                 } else if (asyncClass == "running") {
@@ -487,9 +491,9 @@ void GdbEngine::handleResponse()
             case '@':
             case '&': {
                 QString data = GdbMi::parseCString(from, to);
-                handleStreamOutput(data, c);
                 //dump(oldfrom, from, record.toString());
-                m_inbuffer = QByteArray(from, to - from);
+                m_inbufferPos = from - m_inbuffer.constData();
+                handleStreamOutput(data, c);
                 break;
             }
 
@@ -500,9 +504,15 @@ void GdbEngine::handleResponse()
                     str += QLatin1Char(*from);
                 ++from; // skip the ' '
                 int len = str.toInt();
+                // the contents may contain new lines, wait until all of it is there
+                if (from + len > m_inbuffer.constData() + m_inbuffer.size()) {
+                    waitForMore = true;
+                    break;
+                }
                 QByteArray ba(from, len);
                 from += len;
-                m_inbuffer = QByteArray(from, to - from);
+                m_inbufferPos = from - m_inbuffer.constData();
+                m_inbufferComplete = qMax(m_inbufferComplete, m_inbufferPos);
                 m_customOutputForToken[token] += QString(ba);
                 break;
             }
@@ -535,9 +545,7 @@ void GdbEngine::handleResponse()
                 skipSpaces(from, to);
                 if (from != to && *from == ',') {
                     ++from;
-                    record.data.parseTuple_helper(from, to);
-                    record.data.m_type = GdbMi::Tuple;
-                    record.data.m_name = "data";
+                    record.data.fromResults(from, to, "data");
                 }
                 skipSpaces(from, to);
                 skipTerminator(from, to);
@@ -561,18 +569,27 @@ void GdbEngine::handleResponse()
                 m_pendingConsoleStreamOutput.clear();
 
                 //dump(oldfrom, from, record.toString());
-                m_inbuffer = QByteArray(from, to - from);
+                m_inbufferPos = from - m_inbuffer.constData();
                 handleResultRecord(record);
                 break;
             }
             default: {
-                qDebug() << "FIXME: UNKNOWN CODE: " << c << " IN " << m_inbuffer;
-                m_inbuffer = QByteArray(from, to - from);
+                qDebug() << "FIXME: UNKNOWN CODE: " << c << " IN "
+                    << QByteArray(m_inbuffer.constData() + m_inbufferPos, m_inbufferComplete - m_inbufferPos);
+                m_inbufferPos = from - m_inbuffer.constData();
                 break;
             }
         }
+        if (waitForMore)
+            break;
     }
 
+    // Drop what has been handled. The records parsed from the buffer
+    // keep it alive for as long as they need it.
+    m_inbuffer = m_inbuffer.mid(m_inbufferPos);
+    m_inbufferComplete -= m_inbufferPos;
+    m_inbufferPos = 0;
+
     //qDebug() << "##### end response handling ####\n\n\n"
     //    << currentTime() << lastTime.msecsTo(QTime::currentTime());
     lastTime = QTime::currentTime();
@@ -630,19 +647,20 @@ void GdbEngine::readGdbStandardOutput()
     fixMac(out);
     #endif
 
+    // Records end with a new line. Only the new output is searched for the
+    // end of the last complete one, what was read before is never looked at again.
+    const int lastNewLine = out.lastIndexOf('\n');
     m_inbuffer.append(out);
-    //QTC_ASSERT(!m_inbuffer.isEmpty(), return);
-
-    char c = m_inbuffer[m_inbuffer.size() - 1];
-    static const QByteArray termArray("(gdb) ");
-    if (out.indexOf(termArray) == -1 && c != 10 && c != 13) {
+    if (lastNewLine == -1) {
         //qDebug() << "\n\nBuffer not yet filled, waiting for more data to arrive";
-        //qDebug() << m_inbuffer.data() << m_inbuffer.size();
-        //qDebug() << "\n\n";
         return;
     }
+    m_inbufferComplete = m_inbuffer.size() - out.size() + lastNewLine + 1;
 
-    emit gdbResponseAvailable();
+    if (!m_responsePending) {
+        m_responsePending = true;
+        emit gdbResponseAvailable();
+    }
 }
 
 void GdbEngine::interruptInferior()
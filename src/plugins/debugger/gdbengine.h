@@ -208,6 +208,9 @@ private:
     void handleQuerySources(const GdbResultRecord &response);
 
     QByteArray m_inbuffer;
+    int m_inbufferPos;      // the start of the first record not handled yet
+    int m_inbufferComplete; // the end of the last complete line
+    bool m_responsePending;
 
     QProcess m_gdbProc;
 
@@ -35,165 +35,401 @@
 
 #include <utils/qtcassert.h>
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QByteArray>
+#include <QtCore/QHash>
 #include <QtCore/QTextStream>
+#include <QtCore/QVector>
+
+#include <string.h>
 
 namespace Debugger {
 namespace Internal {
 
+enum {
+    NodeBlockSize = 256,
+    // tuples with fewer children are searched linearly by findChild()
+    MinimumIndexedChildCount = 16
+};
+
+struct GdbMiNode
+{
+    GdbMiArena *arena;
+    GdbMi::Type type;
+    const char *name;
+    int nameSize;
+    const char *data;
+    int dataSize;
+    bool escaped;   // data still contains the escapes of the c-string
+    int firstChild; // the children are contiguous in arena->children
+    int childCount;
+};
+
+class GdbMiArena
+{
+public:
+    GdbMiArena() : blockUsed(NodeBlockSize) {}
+    ~GdbMiArena()
+    {
+        foreach (GdbMiNode *block, blocks)
+            delete [] block;
+    }
+
+    GdbMiNode *newNode(GdbMi::Type type)
+    {
+        if (blockUsed == NodeBlockSize) {
+            blocks.append(new GdbMiNode[NodeBlockSize]);
+            blockUsed = 0;
+        }
+        GdbMiNode *node = blocks.last() + blockUsed++;
+        node->arena = this;
+        node->type = type;
+        node->name = 0;
+        node->nameSize = 0;
+        node->data = 0;
+        node->dataSize = 0;
+        node->escaped = false;
+        node->firstChild = children.size();
+        node->childCount = 0;
+        return node;
+    }
+
+    // Keeps a string the nodes refer to that is not part of the input.
+    const char *addString(const QByteArray &str)
+    {
+        strings.append(str);
+        return strings.last().constData();
+    }
+
+    QAtomicInt ref;
+    QByteArray input;              // the parsed text
+    QList<QByteArray> strings;
+    QList<GdbMiNode *> blocks;
+    int blockUsed;
+    QVector<GdbMiNode *> children;
+    QVector<GdbMiNode *> stack;    // the children collected while parsing
+    QHash<const GdbMiNode *, QHash<QByteArray, int> > nameIndexes;
+};
+
 QTextStream & operator<<(QTextStream & os, const GdbMi & mi)
 {
     return os << mi.toString();
 }
 
-//static void skipSpaces(const GdbMi::Char *&from, const GdbMi::Char *to)
+//static void skipSpaces(const char *&from, const char *to)
 //{
 //    while (from != to && QChar(*from).isSpace())
 //        ++from;
 //}
 
+namespace {
 
-void GdbMi::parseResultOrValue(const Char *&from, const Char *to)
+QByteArray unescapeCString(QByteArray result)
 {
-    //skipSpaces(from, to);
-    while (from != to && QChar(*from).isSpace())
-        ++from;
-
-    //qDebug() << "parseResultOrValue: " << QByteArray::fromLatin1(from, to - from);
-    parseValue(from, to);
-    if (isValid()) {
-        //qDebug() << "no valid result in " << QByteArray::fromLatin1(from, to - from);
-        return;
-    }
-    if (from == to || *from == '(')
-        return;
-    const Char *ptr = from;
-    while (ptr < to && *ptr != '=') {
-        //qDebug() << "adding" << QChar(*ptr) << "to name";
-        ++ptr;
-    }
-    m_name = QByteArray(from, ptr - from);
-    from = ptr;
-    if (from < to && *from == '=') {
-        ++from;
-        parseValue(from, to);
+    if (result.contains('\\')) {
+        if (result.contains("\\032\\032"))
+            result.clear();
+        else {
+            result = result.replace("\\n", "\n");
+            result = result.replace("\\t", "\t");
+            result = result.replace("\\\"", "\"");
+        }
     }
+    return result;
 }
 
-QByteArray GdbMi::parseCString(const Char *&from, const Char *to)
+// Finds the end of the c-string starting at from, sets *contents to what is
+// between the double quotes.
+void scanCString(const char *&from, const char *to,
+                 const char **contents, int *size, bool *escaped)
 {
-    QByteArray result;
-    //qDebug() << "parseCString: " << QByteArray::fromUtf16(from, to - from);
-    if (*from != '"') {
-        qDebug() << "MI Parse Error, double quote expected";
-        return QByteArray();
-    }
-    const Char *ptr = from;
+    *contents = 0;
+    *size = 0;
+    *escaped = false;
+
+    const char *ptr = from;
     ++ptr;
     while (ptr < to) {
         if (*ptr == '"') {
+            *contents = from + 1;
+            *size = ptr - from - 1;
             ++ptr;
-            result = QByteArray(from + 1, ptr - from - 2);
             break;
         }
-        if (*ptr == '\\' && ptr < to - 1)
-            ++ptr;
-        ++ptr;
-    }
-
-    if (result.contains('\\')) {
-        if (result.contains("\\032\\032"))
-            result.clear();
-        else {
-            result = result.replace("\\n", "\n");
-            result = result.replace("\\t", "\t");
-            result = result.replace("\\\"", "\"");
+        if (*ptr == '\\') {
+            *escaped = true;
+            if (ptr < to - 1)
+                ++ptr;
         }
+        ++ptr;
     }
-
     from = ptr;
-    return result;
 }
 
-void GdbMi::parseValue(const Char *&from, const Char *to)
+void finishChildren(GdbMiNode *node, int stackBase)
 {
-    //qDebug() << "parseValue: " << QByteArray::fromUtf16(from, to - from);
-    switch (*from) {
-    case '{':
-        parseTuple(from, to);
-        break;
-    case '[':
-        parseList(from, to);
-        break;
-    case '"':
-        m_type = Const;
-        m_data = parseCString(from, to);
-        break;
-    default:
-        break;
-    }
+    GdbMiArena *arena = node->arena;
+    node->firstChild = arena->children.size();
+    node->childCount = arena->stack.size() - stackBase;
+    for (int i = stackBase; i < arena->stack.size(); ++i)
+        arena->children.append(arena->stack.at(i));
+    arena->stack.resize(stackBase);
 }
 
+GdbMiNode *parseValue(GdbMiArena *arena, const char *&from, const char *to);
 
-void GdbMi::parseTuple(const Char *&from, const Char *to)
+GdbMiNode *parseResultOrValue(GdbMiArena *arena, const char *&from, const char *to)
 {
-    //qDebug() << "parseTuple: " << QByteArray::fromUtf16(from, to - from);
-    QTC_ASSERT(*from == '{', /**/);
-    ++from;
-    parseTuple_helper(from, to);
+    //skipSpaces(from, to);
+    while (from != to && QChar(*from).isSpace())
+        ++from;
+
+    GdbMiNode *node = parseValue(arena, from, to);
+    if (node)
+        return node;
+    if (from == to || *from == '(')
+        return 0;
+    const char *ptr = from;
+    while (ptr < to && *ptr != '=')
+        ++ptr;
+    const char *name = from;
+    const int nameSize = ptr - from;
+    from = ptr;
+    if (from < to && *from == '=') {
+        ++from;
+        node = parseValue(arena, from, to);
+        if (node) {
+            node->name = name;
+            node->nameSize = nameSize;
+        }
+    }
+    return node;
 }
 
-void GdbMi::parseTuple_helper(const Char *&from, const Char *to)
+GdbMiNode *parseTuple(GdbMiArena *arena, const char *&from, const char *to)
 {
-    //qDebug() << "parseTuple_helper: " << QByteArray::fromUtf16(from, to - from);
-    m_type = Tuple;
+    QTC_ASSERT(*from == '{', /**/);
+    ++from;
+    GdbMiNode *node = arena->newNode(GdbMi::Tuple);
+    const int stackBase = arena->stack.size();
     while (from < to) {
         if (*from == '}') {
             ++from;
             break;
         }
-        GdbMi child;
-        child.parseResultOrValue(from, to);
-        //qDebug() << "\n=======\n" << qPrintable(child.toString()) << "\n========\n";
-        if (!child.isValid())
-            return;
-        m_children += child;
-        if (*from == ',')
+        GdbMiNode *child = parseResultOrValue(arena, from, to);
+        if (!child)
+            break;
+        arena->stack.append(child);
+        if (from < to && *from == ',')
             ++from;
     }
+    finishChildren(node, stackBase);
+    return node;
 }
 
-void GdbMi::parseList(const Char *&from, const Char *to)
+GdbMiNode *parseList(GdbMiArena *arena, const char *&from, const char *to)
 {
-    //qDebug() << "parseList: " << QByteArray::fromUtf16(from, to - from);
     QTC_ASSERT(*from == '[', /**/);
     ++from;
-    m_type = List;
+    GdbMiNode *node = arena->newNode(GdbMi::List);
+    const int stackBase = arena->stack.size();
     while (from < to) {
         if (*from == ']') {
             ++from;
             break;
         }
-        GdbMi child;
-        child.parseResultOrValue(from, to);
-        if (child.isValid())
-            m_children += child;
-        if (*from == ',')
+        const char *start = from;
+        GdbMiNode *child = parseResultOrValue(arena, from, to);
+        if (child)
+            arena->stack.append(child);
+        if (from < to && *from == ',')
             ++from;
+        else if (from == start)
+            break; // nothing to make sense of
+    }
+    finishChildren(node, stackBase);
+    return node;
+}
+
+GdbMiNode *parseValue(GdbMiArena *arena, const char *&from, const char *to)
+{
+    if (from == to)
+        return 0;
+
+    switch (*from) {
+    case '{':
+        return parseTuple(arena, from, to);
+    case '[':
+        return parseList(arena, from, to);
+    case '"': {
+        GdbMiNode *node = arena->newNode(GdbMi::Const);
+        scanCString(from, to, &node->data, &node->dataSize, &node->escaped);
+        return node;
+    }
+    default:
+        return 0;
+    }
+}
+
+int findChildIndex(GdbMiNode *node, const QByteArray &name)
+{
+    GdbMiArena *arena = node->arena;
+    GdbMiNode * const *children = arena->children.constData() + node->firstChild;
+
+    if (node->childCount < MinimumIndexedChildCount) {
+        for (int i = 0; i < node->childCount; ++i) {
+            if (children[i]->nameSize == name.size()
+                    && !memcmp(children[i]->name, name.constData(), name.size()))
+                return i;
+        }
+        return -1;
+    }
+
+    QHash<QByteArray, int> &index = arena->nameIndexes[node];
+    if (index.isEmpty()) {
+        // backwards, so that the first of several children with the same name wins
+        for (int i = node->childCount - 1; i >= 0; --i)
+            index.insert(QByteArray::fromRawData(children[i]->name, children[i]->nameSize), i);
     }
+    return index.value(name, -1);
+}
+
+} // anonymous namespace
+
+GdbMi::GdbMi(const QByteArray &str)
+    : m_node(0)
+{
+    fromString(str);
+}
+
+GdbMi::GdbMi(GdbMiNode *node)
+    : m_node(node)
+{
+    if (m_node)
+        m_node->arena->ref.ref();
+}
+
+GdbMi::GdbMi(const GdbMi &other)
+    : m_node(other.m_node)
+{
+    if (m_node)
+        m_node->arena->ref.ref();
+}
+
+GdbMi::~GdbMi()
+{
+    if (m_node && !m_node->arena->ref.deref())
+        delete m_node->arena;
+}
+
+GdbMi &GdbMi::operator=(const GdbMi &other)
+{
+    if (other.m_node)
+        other.m_node->arena->ref.ref();
+    if (m_node && !m_node->arena->ref.deref())
+        delete m_node->arena;
+    m_node = other.m_node;
+    return *this;
+}
+
+GdbMi::Type GdbMi::type() const
+{
+    return m_node ? m_node->type : Invalid;
+}
+
+QByteArray GdbMi::name() const
+{
+    if (!m_node)
+        return QByteArray();
+    return QByteArray(m_node->name, m_node->nameSize);
+}
+
+bool GdbMi::hasName(const char *name) const
+{
+    const int size = qstrlen(name);
+    if (!m_node)
+        return size == 0;
+    return m_node->nameSize == size && !memcmp(m_node->name, name, size);
+}
+
+QByteArray GdbMi::data() const
+{
+    if (!m_node)
+        return QByteArray();
+    if (m_node->escaped) {
+        // unescape once, the node refers to the result from now on
+        const QByteArray data = unescapeCString(QByteArray(m_node->data, m_node->dataSize));
+        m_node->data = m_node->arena->addString(data);
+        m_node->dataSize = data.size();
+        m_node->escaped = false;
+    }
+    return QByteArray(m_node->data, m_node->dataSize);
+}
+
+QList<GdbMi> GdbMi::children() const
+{
+    QList<GdbMi> result;
+    for (int i = 0; i < childCount(); ++i)
+        result.append(childAt(i));
+    return result;
+}
+
+int GdbMi::childCount() const
+{
+    return m_node ? m_node->childCount : 0;
+}
+
+GdbMi GdbMi::childAt(int index) const
+{
+    QTC_ASSERT(index >= 0 && index < childCount(), return GdbMi());
+    return GdbMi(m_node->arena->children.at(m_node->firstChild + index));
+}
+
+QByteArray GdbMi::parseCString(const char *&from, const char *to)
+{
+    //qDebug() << "parseCString: " << QByteArray::fromUtf16(from, to - from);
+    if (*from != '"') {
+        qDebug() << "MI Parse Error, double quote expected";
+        return QByteArray();
+    }
+    const char *contents;
+    int size;
+    bool escaped;
+    scanCString(from, to, &contents, &size, &escaped);
+    const QByteArray result(contents, size);
+    return escaped ? unescapeCString(result) : result;
 }
 
 void GdbMi::setStreamOutput(const QByteArray &name, const QByteArray &content)
 {
     if (content.isEmpty())
         return;
-    GdbMi child;
-    child.m_type = Const;
-    child.m_name = name;
-    child.m_data = content;
-    m_children += child;
-    if (m_type == Invalid)
-        m_type = Tuple;
+    if (!m_node)
+        *this = GdbMi((new GdbMiArena)->newNode(Tuple));
+    GdbMiArena *arena = m_node->arena;
+
+    GdbMiNode *child = arena->newNode(Const);
+    child->name = arena->addString(name);
+    child->nameSize = name.size();
+    child->data = arena->addString(content);
+    child->dataSize = content.size();
+
+    // keep the children contiguous, move them behind the others if needed
+    if (m_node->firstChild + m_node->childCount != arena->children.size()) {
+        const int firstChild = arena->children.size();
+        for (int i = 0; i < m_node->childCount; ++i) {
+            GdbMiNode *sibling = arena->children.at(m_node->firstChild + i);
+            arena->children.append(sibling);
+        }
+        m_node->firstChild = firstChild;
+    }
+    arena->children.append(child);
+    ++m_node->childCount;
+    arena->nameIndexes.remove(m_node);
+
+    if (m_node->type == Invalid)
+        m_node->type = Tuple;
 }
 
 static QByteArray ind(int indent)
@@ -203,7 +439,7 @@ static QByteArray ind(int indent)
 
 void GdbMi::dumpChildren(QByteArray * str, bool multiline, int indent) const
 {
-    for (int i = 0; i < m_children.size(); ++i) {
+    for (int i = 0; i < childCount(); ++i) {
         if (i != 0) {
             *str += ',';
             if (multiline)
@@ -211,14 +447,15 @@ void GdbMi::dumpChildren(QByteArray * str, bool multiline, int indent) const
         }
         if (multiline)
             *str += ind(indent);
-        *str += m_children.at(i).toString(multiline, indent);
+        *str += childAt(i).toString(multiline, indent);
     }
 }
 
 QByteArray GdbMi::toString(bool multiline, int indent) const
 {
     QByteArray result;
-    switch (m_type) {
+    const QByteArray name = this->name();
+    switch (type()) {
     case Invalid:
         if (multiline) {
             result += ind(indent) + "Invalid\n";
@@ -227,17 +464,17 @@ QByteArray GdbMi::toString(bool multiline, int indent) const
         }
         break;
     case Const:
-        if (!m_name.isEmpty())
-            result += m_name + "=";
+        if (!name.isEmpty())
+            result += name + "=";
         if (multiline) {
-        result += "\"" + m_data + "\"";
+        result += "\"" + data() + "\"";
         } else {
-            result += "\"" + m_data + "\"";
+            result += "\"" + data() + "\"";
         }
         break;
     case Tuple:
-        if (!m_name.isEmpty())
-            result += m_name + "=";
+        if (!name.isEmpty())
+            result += name + "=";
         if (multiline) {
             result += "{\n";
             dumpChildren(&result, multiline, indent + 1);
@@ -249,8 +486,8 @@ QByteArray GdbMi::toString(bool multiline, int indent) const
         }
         break;
     case List:
-        if (!m_name.isEmpty())
-            result += m_name + "=";
+        if (!name.isEmpty())
+            result += name + "=";
         if (multiline) {
             result += "[\n";
             dumpChildren(&result, multiline, indent + 1);
@@ -267,28 +504,75 @@ QByteArray GdbMi::toString(bool multiline, int indent) const
 
 void GdbMi::fromString(const QByteArray &ba)
 {
-    const Char *from = ba.constBegin();
-    const Char *to = ba.constEnd();
-    parseResultOrValue(from, to);
+    GdbMiArena *arena = new GdbMiArena;
+    arena->input = ba;
+    const char *from = arena->input.constData();
+    const char *to = from + arena->input.size();
+    GdbMiNode *node = parseResultOrValue(arena, from, to);
+    if (node) {
+        *this = GdbMi(node);
+    } else {
+        delete arena;
+        *this = GdbMi();
+    }
+}
+
+void GdbMi::fromResults(const char *&from, const char *to, const QByteArray &name)
+{
+    // A record ends with its line, newlines in c-strings are escaped. Only
+    // the line is kept, values that outlive the record would otherwise keep
+    // the whole input alive.
+    const char *lineEnd = static_cast<const char *>(memchr(from, '\n', to - from));
+    if (!lineEnd)
+        lineEnd = to;
+
+    GdbMiArena *arena = new GdbMiArena;
+    arena->input = QByteArray(from, lineEnd - from);
+    const char *begin = arena->input.constData();
+    const char *pos = begin;
+    const char *end = begin + arena->input.size();
+
+    GdbMiNode *node = arena->newNode(Tuple);
+    if (!name.isEmpty()) {
+        node->name = arena->addString(name);
+        node->nameSize = name.size();
+    }
+    const int stackBase = arena->stack.size();
+    while (pos != end) {
+        GdbMiNode *child = parseResultOrValue(arena, pos, end);
+        if (!child)
+            break;
+        arena->stack.append(child);
+        if (pos == end || *pos != ',')
+            break;
+        ++pos;
+    }
+    finishChildren(node, stackBase);
+    *this = GdbMi(node);
+    from += pos - begin;
 }
 
 GdbMi GdbMi::findChild(const QByteArray &name) const
 {
-    for (int i = 0; i < m_children.size(); ++i)
-        if (m_children.at(i).m_name == name)
-            return m_children.at(i);
-    return GdbMi();
+    if (!m_node)
+        return GdbMi();
+    const int index = findChildIndex(m_node, name);
+    return index == -1 ? GdbMi() : childAt(index);
 }
 
 
 GdbMi GdbMi::findChild(const QByteArray &name, const QByteArray &defaultData) const
 {
-    for (int i = 0; i < m_children.size(); ++i)
-        if (m_children.at(i).m_name == name)
-            return m_children.at(i);
-    GdbMi result;
-    result.m_data = defaultData;
-    return result;
+    if (m_node) {
+        const int index = findChildIndex(m_node, name);
+        if (index != -1)
+            return childAt(index);
+    }
+    GdbMiArena *arena = new GdbMiArena;
+    GdbMiNode *node = arena->newNode(Invalid);
+    node->data = arena->addString(defaultData);
+    node->dataSize = defaultData.size();
+    return GdbMi(node);
 }
 
 
@@ -91,16 +91,32 @@ token ==>
 
  */
 
+class GdbMiArena;
+struct GdbMiNode;
+
+/*
+    A value parsed from GDB/MI output.
+
+    The nodes of a parsed tree are allocated in blocks from an arena that
+    belongs to one parse, and names and c-string contents are slices of
+    a copy of the parsed text, which the arena keeps alive. A GdbMi is a
+    reference counted handle to one of these nodes, so copying it, taking
+    children or finding a child copy no trees. C-strings are unescaped only when
+    their data() is asked for.
+
+    GdbMi values referring to the same tree share it, setStreamOutput()
+    is meant to complete a freshly parsed record before it is passed on.
+*/
+
 // FIXME: rename into GdbMiValue
 class GdbMi
 {
 public:
-    GdbMi() : m_type(Invalid) {}
-    explicit GdbMi(const QByteArray &str) { fromString(str); }
-
-    QByteArray m_name;
-    QByteArray m_data;
-    QList<GdbMi> m_children;
+    GdbMi() : m_node(0) {}
+    explicit GdbMi(const QByteArray &str);
+    GdbMi(const GdbMi &other);
+    ~GdbMi();
+    GdbMi &operator=(const GdbMi &other);
 
     enum Type {
         Invalid,
@@ -109,45 +125,39 @@ public:
         List,
     };
 
-    Type m_type;
+    Type type() const;
+    QByteArray name() const;
+    bool hasName(const char *name) const;
 
-    inline Type type() const { return m_type; }
-    inline QByteArray name() const { return m_name; }
-    inline bool hasName(const char *name) const { return m_name == name; }
+    inline bool isValid() const { return type() != Invalid; }
+    inline bool isConst() const { return type() == Const; }
+    inline bool isTuple() const { return type() == Tuple; }
+    inline bool isList() const { return type() == List; }
 
-    inline bool isValid() const { return m_type != Invalid; }
-    inline bool isConst() const { return m_type == Const; }
-    inline bool isTuple() const { return m_type == Tuple; }
-    inline bool isList() const { return m_type == List; }
+    QByteArray data() const;
+    QList<GdbMi> children() const;
+    int childCount() const;
 
-
-    inline QByteArray data() const { return m_data; }
-    inline const QList<GdbMi> &children() const { return m_children; }
-    inline int childCount() const { return m_children.size(); }
-
-    const GdbMi & childAt(int index) const { return m_children[index]; } 
-    GdbMi & childAt(int index) { return m_children[index]; }
+    GdbMi childAt(int index) const;
     GdbMi findChild(const QByteArray &name) const;
     GdbMi findChild(const QByteArray &name, const QByteArray &defaultString) const;
 
     QByteArray toString(bool multiline = false, int indent = 0) const;
     void fromString(const QByteArray &str);
+    // Parses "result ( "," result )*" starting at from into a tuple called
+    // name. The tuple keeps a copy of the rest of the line only.
+    void fromResults(const char *&from, const char *to,
+                     const QByteArray &name = QByteArray());
     void setStreamOutput(const QByteArray &name, const QByteArray &content);
 
+    static QByteArray parseCString(const char *&from, const char *to);
+
 private:
-    friend class GdbResultRecord;
-    friend class GdbEngine;
-
-    //typedef ushort Char;
-    typedef char Char;
-    static QByteArray parseCString(const Char *&from, const Char *to);
-    void parseResultOrValue(const Char *&from, const Char *to);
-    void parseValue(const Char *&from, const Char *to);
-    void parseTuple(const Char *&from, const Char *to);
-    void parseTuple_helper(const Char *&from, const Char *to);
-    void parseList(const Char *&from, const Char *to);
+    explicit GdbMi(GdbMiNode *node);
 
     void dumpChildren(QByteArray *str, bool multiline, int indent) const;
+
+    GdbMiNode *m_node;
 };
 
 enum GdbResultClass
@@ -178,6 +188,8 @@ private:
 } // namespace Internal
 } // namespace Debugger
 
+Q_DECLARE_TYPEINFO(Debugger::Internal::GdbMi, Q_MOVABLE_TYPE);
+
 //Q_DECLARE_METATYPE(GdbDebugger::Internal::GdbMi);
 
 #endif // DEBUGGER_GDBMI_H
@@ -41,6 +41,7 @@
 
 #include <QtCore/QDebug>
 #include <QtCore/QEvent>
+#include <QtCore/QVector>
 
 #include <QtGui/QApplication>
 #include <QtGui/QLabel>
@@ -264,32 +265,15 @@ QString WatchData::toString() const
 }
 
 
-static bool iNameSorter(const WatchData &d1, const WatchData &d2)
+// Orders the last components of sibling inames.
+static bool iNameLessThan(const QString &name1, const QString &name2)
 {
-    if (d1.level != d2.level)
-        return d1.level < d2.level;
-
-    for (int level = 0; level != d1.level; ++level) {
-        QString name1 = d1.iname.section('.', level, level);
-        QString name2 = d2.iname.section('.', level, level);
-        //MODEL_DEBUG(" SORT: " << name1 << name2 << (name1 < name2));
-
-        if (name1 != name2) {
-            // This formerly used inames. in this case 'lastIndexOf' probably
-            // makes more sense.
-            if (name1.startsWith('[') && name2.startsWith('[')) {
-                return name1.mid(1, name1.indexOf(']') - 1).toInt()
-                     < name2.mid(1, name2.indexOf(']') - 1).toInt();
-                // numbers should be sorted according to their numerical value
-                //int pos = d1.name.lastIndexOf('.');
-                //if (pos != -1 && pos + 1 != d1.name.size() && d1.name.at(pos + 1).isDigit())
-                //    return d1.name.size() < d2.name.size();
-                // fall through
-            }
-            return name1 < name2;
-        }
+    // numbers should be sorted according to their numerical value
+    if (name1.startsWith('[') && name2.startsWith('[')) {
+        return name1.mid(1, name1.indexOf(']') - 1).toInt()
+             < name2.mid(1, name2.indexOf(']') - 1).toInt();
     }
-    return false; 
+    return name1 < name2;
 }
 
 static QString parentName(const QString &iname)
@@ -300,34 +284,41 @@ static QString parentName(const QString &iname)
     return iname.left(pos);
 }
 
+static QString lastName(const QString &iname)
+{
+    return iname.mid(iname.lastIndexOf('.') + 1);
+}
 
-static void insertDataHelper(QList<WatchData> &list, const WatchData &data)
+static void insertDataHelper(QList<WatchData> &list, QHash<QString, int> &index,
+    const WatchData &data)
 {
-    // FIXME: Quadratic algorithm
-    for (int i = list.size(); --i >= 0; ) {
-        if (list.at(i).iname == data.iname) {
-            list[i] = data;
-            return;
-        }
+    const int pos = index.value(data.iname, -1);
+    if (pos != -1) {
+        list[pos] = data;
+        return;
     }
+    index[data.iname] = list.size();
     list.append(data);
 }
 
-static WatchData take(const QString &iname, QList<WatchData> *list)
+static WatchData take(const QString &iname, QList<WatchData> *list,
+    QHash<QString, int> *index)
 {
-    for (int i = list->size(); --i >= 0;) {
-        if (list->at(i).iname == iname) {
-            WatchData res = list->at(i);
-            (*list)[i] = list->back();
-            (void) list->takeLast();
-            return res;
-            //return list->takeAt(i);
-        }
+    const int pos = index->value(iname, -1);
+    if (pos == -1)
+        return WatchData();
+    index->remove(iname);
+    WatchData res = list->at(pos);
+    // Order does not matter, so fill the gap with the last item
+    const int last = list->size() - 1;
+    if (pos != last) {
+        (*list)[pos] = list->at(last);
+        (*index)[list->at(pos).iname] = pos;
     }
-    return WatchData();
+    list->removeLast();
+    return res;
 }
 
-
 static QList<WatchData> initialSet()
 {
     QList<WatchData> result;
@@ -385,9 +376,10 @@ WatchHandler::WatchHandler()
     m_inFetchMore = false;
     m_inChange = false;
 
-    m_completeSet = initialSet();
-    m_incompleteSet.clear();
-    m_displaySet = m_completeSet;
+    m_resetPending = false;
+
+    resetCompleteSet();
+    resetDisplaySet();
 }
 
 bool WatchHandler::setData(const QModelIndex &idx,
@@ -598,30 +590,21 @@ QString WatchHandler::toString() const
         res += m_displaySet.at(i).toString();
         res += '\n';
     }
-#if 0
-    res += "\nOld:\n";
-    for (int i = 0, n = m_oldSet.size(); i != n; ++i) {
-        res += m_oldSet.at(i).toString();
-        res += '\n';
-    }
-#endif
     return res;
 }
 
 WatchData *WatchHandler::findData(const QString &iname)
 {
-    for (int i = m_completeSet.size(); --i >= 0; )
-        if (m_completeSet.at(i).iname == iname)
-            return &m_completeSet[i];
-    return 0;
+    const int pos = m_completeIndex.value(iname, -1);
+    return pos == -1 ? 0 : &m_completeSet[pos];
 }
 
 WatchData WatchHandler::takeData(const QString &iname)
 {
-    WatchData data = take(iname, &m_incompleteSet);
+    WatchData data = take(iname, &m_incompleteSet, &m_incompleteIndex);
     if (data.isValid())
         return data;
-    return take(iname, &m_completeSet);
+    return take(iname, &m_completeSet, &m_completeIndex);
 }
 
 QList<WatchData> WatchHandler::takeCurrentIncompletes()
@@ -629,144 +612,272 @@ QList<WatchData> WatchHandler::takeCurrentIncompletes()
     QList<WatchData> res = m_incompleteSet;
     //MODEL_DEBUG("TAKING INCOMPLETES" << toString());
     m_incompleteSet.clear();
+    m_incompleteIndex.clear();
     return res;
 }
 
-void WatchHandler::rebuildModel()
+void WatchHandler::resetCompleteSet()
 {
-    if (m_inChange) {
-        MODEL_DEBUG("RECREATE MODEL IGNORED, CURRENT SET:\n" << toString());
-        return;
-    }
+    m_completeSet = initialSet();
+    m_completeIndex.clear();
+    for (int i = 0, n = m_completeSet.size(); i != n; ++i)
+        m_completeIndex[m_completeSet.at(i).iname] = i;
+    m_incompleteSet.clear();
+    m_incompleteIndex.clear();
+}
 
-    #ifdef DEBUG_PENDING
-    MODEL_DEBUG("RECREATE MODEL, CURRENT SET:\n" << toString());
-    #endif
+void WatchHandler::resetDisplaySet()
+{
+    m_displaySet = initialSet();
+    m_displayIndex.clear();
+    for (int i = 0, n = m_displaySet.size(); i != n; ++i)
+        m_displayIndex[m_displaySet.at(i).iname] = i;
+    m_freeDisplayNodes.clear();
+}
 
-    QHash<QString, int> oldTopINames;
-    QHash<QString, QString> oldValues;
-    for (int i = 0, n = m_oldSet.size(); i != n; ++i) {
-        WatchData &data = m_oldSet[i];
-        oldValues[data.iname] = data.value;
-        if (data.level == 2)
-            ++oldTopINames[data.iname];
-    }
-    #ifdef DEBUG_PENDING
-    MODEL_DEBUG("OLD VALUES: " << oldValues);
-    #endif
+// Nodes in m_displaySet keep their position for their whole lifetime
+// as the position is used as internal id of the model indexes. Dummy
+// nodes giving the [+] effect and the "<No Locals>" placeholders are
+// not registered in m_displayIndex.
+bool WatchHandler::isDummy(int id) const
+{
+    return m_displayIndex.value(m_displaySet.at(id).iname, -1) != id;
+}
 
-    for (int i = m_completeSet.size(); --i >= 0; ) {
-        WatchData &data = m_completeSet[i];
-        data.level = data.iname.isEmpty() ? 0 : data.iname.count('.') + 1;
-        data.childIndex.clear();
+QModelIndex WatchHandler::modelIndex(int id) const
+{
+    return createIndex(m_displaySet.at(id).row, 0, id);
+}
+
+int WatchHandler::insertDisplayNode(int parentId, int row,
+    const WatchData &data, bool isDummy)
+{
+    if (!m_resetPending)
+        beginInsertRows(modelIndex(parentId), row, row);
+
+    int id;
+    if (m_freeDisplayNodes.isEmpty()) {
+        id = m_displaySet.size();
+        m_displaySet.append(data);
+    } else {
+        id = m_freeDisplayNodes.takeLast();
+        m_displaySet[id] = data;
     }
+    WatchData &node = m_displaySet[id];
+    node.parentIndex = parentId;
+    node.level = m_displaySet.at(parentId).level + 1;
+    node.childIndex.clear();
+    if (!isDummy)
+        m_displayIndex[node.iname] = id;
+
+    m_displaySet[parentId].childIndex.insert(row, id);
+    const QList<int> siblings = m_displaySet.at(parentId).childIndex;
+    for (int i = row, n = siblings.size(); i != n; ++i)
+        m_displaySet[siblings.at(i)].row = i;
+
+    if (!m_resetPending)
+        endInsertRows();
+    return id;
+}
 
-    qSort(m_completeSet.begin(), m_completeSet.end(), &iNameSorter);
+void WatchHandler::removeDisplayNode(int parentId, int row)
+{
+    if (!m_resetPending)
+        beginRemoveRows(modelIndex(parentId), row, row);
 
-    // This helps to decide whether the view has completely changed or not.
-    QHash<QString, int> topINames;
+    releaseDisplayNode(m_displaySet.at(parentId).childIndex.at(row));
+    m_displaySet[parentId].childIndex.removeAt(row);
+    const QList<int> siblings = m_displaySet.at(parentId).childIndex;
+    for (int i = row, n = siblings.size(); i != n; ++i)
+        m_displaySet[siblings.at(i)].row = i;
 
-    QHash<QString, int> iname2idx;
+    if (!m_resetPending)
+        endRemoveRows();
+}
 
-    for (int i = m_completeSet.size(); --i > 0; ) {
-        WatchData &data = m_completeSet[i];
-        data.parentIndex = 0;
-        data.childIndex.clear();
-        iname2idx[data.iname] = i;
-        if (data.level == 2)
-            ++topINames[data.iname];
-    }
-    //qDebug() << "TOPINAMES: " << topINames << "\nOLD: " << oldTopINames;
-
-    for (int i = 1; i < m_completeSet.size(); ++i) {
-        WatchData &data = m_completeSet[i];
-        QString parentIName = parentName(data.iname);
-        data.parentIndex = iname2idx.value(parentIName, 0);
-        WatchData &parent = m_completeSet[data.parentIndex];
-        data.row = parent.childIndex.size();
-        parent.childIndex.append(i);
-    }
+void WatchHandler::releaseDisplayNode(int id)
+{
+    foreach (int child, m_displaySet.at(id).childIndex)
+        releaseDisplayNode(child);
+    const QString iname = m_displaySet.at(id).iname;
+    if (m_displayIndex.value(iname, -1) == id)
+        m_displayIndex.remove(iname);
+    m_displaySet[id] = WatchData();
+    m_freeDisplayNodes.append(id);
+}
 
-    m_oldSet = m_completeSet;
-    m_oldSet += m_incompleteSet;
+void WatchHandler::updateDisplayNode(int id, const WatchData &data)
+{
+    WatchData &node = m_displaySet[id];
+    const bool visibleChange = node.name != data.name
+        || node.value != data.value
+        || node.type != data.type
+        || node.exp != data.exp
+        || node.addr != data.addr
+        || node.valuedisabled != data.valuedisabled
+        || node.changed != data.changed;
+
+    const int parentIndex = node.parentIndex;
+    const int row = node.row;
+    const int level = node.level;
+    const QList<int> childIndex = node.childIndex;
+    node = data;
+    node.parentIndex = parentIndex;
+    node.row = row;
+    node.level = level;
+    node.childIndex = childIndex;
+
+    if (visibleChange && !m_resetPending)
+        emit dataChanged(modelIndex(id), createIndex(row, 2, id));
+}
 
-    for (int i = 0, n = m_completeSet.size(); i != n; ++i) {
-        WatchData &data = m_completeSet[i];
-        data.changed = !data.value.isEmpty()
-            && data.value != oldValues[data.iname]
-            && data.value != strNotInScope;
+// Removes the subtrees of 'id' that are not part of the complete set anymore.
+void WatchHandler::removeObsoleteNodes(int id)
+{
+    for (int row = m_displaySet.at(id).childIndex.size(); --row >= 0; ) {
+        const int child = m_displaySet.at(id).childIndex.at(row);
+        if (isDummy(child))
+            continue;
+        if (m_completeIndex.contains(m_displaySet.at(child).iname))
+            removeObsoleteNodes(child);
+        else
+            removeDisplayNode(id, row);
     }
+}
 
-    emit layoutAboutToBeChanged();
-
-    if (oldTopINames != topINames) {
-        m_displaySet = initialSet();
-        m_expandedINames.clear();
-        emit reset();
+// Brings the display tree in line with the complete set. Values are
+// marked as changed by comparing with the item of the same iname in
+// oldSet.
+void WatchHandler::updateDisplaySet(const QList<WatchData> &oldSet,
+    const QHash<QString, int> &oldIndex)
+{
+    // Parents have to be in place before their children are, so
+    // process the items level by level.
+    QVector<QList<int> > levels;
+    for (int i = 0, n = m_completeSet.size(); i != n; ++i) {
+        const int level = m_completeSet.at(i).iname.count('.') + 1;
+        if (level < 2) // root and top-level items are always there
+            continue;
+        if (levels.size() <= level)
+            levels.resize(level + 1);
+        levels[level].append(i);
     }
 
-    m_displaySet = m_completeSet;
+    for (int level = 2; level < levels.size(); ++level) {
+        foreach (int i, levels.at(level)) {
+            WatchData data = m_completeSet.at(i);
+            const int oldId = oldIndex.value(data.iname, -1);
+            const QString oldValue = oldId == -1 ? QString() : oldSet.at(oldId).value;
+            data.changed = !data.value.isEmpty()
+                && data.value != oldValue
+                && data.value != strNotInScope;
+
+            const int id = m_displayIndex.value(data.iname, -1);
+            if (id != -1) {
+                updateDisplayNode(id, data);
+                continue;
+            }
 
-    #ifdef DEBUG_PENDING
-    MODEL_DEBUG("SET  " << toString());
-    #endif
+            // Items whose parent is not complete yet are not shown.
+            const int parentId = m_displayIndex.value(parentName(data.iname), -1);
+            if (parentId == -1)
+                continue;
+
+            // The dummy item goes away as soon as there is real content.
+            const QList<int> &siblings = m_displaySet.at(parentId).childIndex;
+            if (siblings.size() == 1 && isDummy(siblings.at(0)))
+                removeDisplayNode(parentId, 0);
+
+            const QString name = lastName(data.iname);
+            int from = 0;
+            int to = m_displaySet.at(parentId).childIndex.size();
+            while (from < to) {
+                const int middle = (from + to) / 2;
+                const int sibling = m_displaySet.at(parentId).childIndex.at(middle);
+                if (iNameLessThan(lastName(m_displaySet.at(sibling).iname), name))
+                    from = middle + 1;
+                else
+                    to = middle;
+            }
+            insertDisplayNode(parentId, from, data, false);
+        }
+    }
 
-#if 1
-    // Append dummy item to get the [+] effect
-    for (int i = 0, n = m_displaySet.size(); i != n; ++i) {
-        WatchData &data = m_displaySet[i];
-        if (data.childCount > 0 && data.childIndex.size() == 0) {
+    // Append dummy items to get the [+] effect and to prevent empty views
+    for (int id = 1, n = m_displaySet.size(); id != n; ++id) {
+        if (m_displaySet.at(id).level < 0 || isDummy(id))
+            continue;
+        const WatchData &data = m_displaySet.at(id);
+        const bool isTopLevel = id <= 3;
+        if (isTopLevel || data.childCount > 0) {
+            if (!data.childIndex.isEmpty())
+                continue;
             WatchData dummy;
             dummy.state = 0;
-            dummy.row = 0;
             dummy.iname = data.iname + ".dummy";
-            //dummy.name = data.iname + ".dummy";
-            //dummy.name  = "<loading>";
-            dummy.level = data.level + 1;
-            dummy.parentIndex = i;
             dummy.childCount = 0;
-            data.childIndex.append(m_displaySet.size());
-            m_displaySet.append(dummy); 
+            if (id == 1)
+                dummy.name = "<No Locals>";
+            else if (id == 2)
+                dummy.name = "<No Tooltip>";
+            else if (id == 3)
+                dummy.name = "<No Watchers>";
+            insertDisplayNode(id, 0, dummy, true);
+        } else if (data.childIndex.size() == 1 && isDummy(data.childIndex.at(0))) {
+            removeDisplayNode(id, 0);
         }
     }
-#endif
+}
 
-    // Possibly append dummy items to prevent empty views
-    bool ok = true;
-    QTC_ASSERT(m_displaySet.size() >= 2, ok = false);
-    QTC_ASSERT(m_displaySet.at(1).iname == "local", ok = false);
-    QTC_ASSERT(m_displaySet.at(2).iname == "tooltip", ok = false);
-    QTC_ASSERT(m_displaySet.at(3).iname == "watch", ok = false);
-    if (ok) {
-        for (int i = 1; i <= 3; ++i) {
-            WatchData &data = m_displaySet[i];
-            if (data.childIndex.size() == 0) {
-                WatchData dummy;
-                dummy.state = 0;
-                dummy.row = 0;
-                if (i == 1) {
-                    dummy.iname = "local.dummy";
-                    dummy.name  = "<No Locals>";
-                } else if (i == 2) {
-                    dummy.iname = "tooltip.dummy";
-                    dummy.name  = "<No Tooltip>";
-                } else {
-                    dummy.iname = "watch.dummy";
-                    dummy.name  = "<No Watchers>";
-                }
-                dummy.level = 2;
-                dummy.parentIndex = i;
-                dummy.childCount = 0;
-                data.childIndex.append(m_displaySet.size());
-                m_displaySet.append(dummy); 
-            }
-        }
+void WatchHandler::rebuildModel()
+{
+    if (m_inChange) {
+        MODEL_DEBUG("RECREATE MODEL IGNORED, CURRENT SET:\n" << toString());
+        return;
     }
 
+    #ifdef DEBUG_PENDING
+    MODEL_DEBUG("RECREATE MODEL, CURRENT SET:\n" << toString());
+    #endif
+
+    // This helps to decide whether the view has completely changed or not.
+    bool sameTopINames = true;
+    int topINames = 0;
+    foreach (const WatchData &data, m_completeSet) {
+        if (data.iname.count('.') != 1)
+            continue;
+        ++topINames;
+        const int id = m_displayIndex.value(data.iname, -1);
+        if (id == -1 || m_displaySet.at(id).level != 2)
+            sameTopINames = false;
+    }
+    int oldTopINames = 0;
+    for (int id = 1; id <= 3; ++id) {
+        foreach (int child, m_displaySet.at(id).childIndex)
+            oldTopINames += !isDummy(child);
+    }
+    if (topINames != oldTopINames)
+        sameTopINames = false;
+
     m_inChange = true;
-    //qDebug() << "WATCHHANDLER: RESET ABOUT TO EMIT";
-    emit reset();
-    //qDebug() << "WATCHHANDLER: RESET EMITTED";
+    if (sameTopINames) {
+        // Just tell the views about the differences.
+        for (int id = 1; id <= 3; ++id)
+            removeObsoleteNodes(id);
+        updateDisplaySet(m_displaySet, m_displayIndex);
+    } else {
+        emit layoutAboutToBeChanged();
+        m_expandedINames.clear();
+        const QList<WatchData> oldSet = m_displaySet;
+        const QHash<QString, int> oldIndex = m_displayIndex;
+        m_resetPending = true;
+        resetDisplaySet();
+        updateDisplaySet(oldSet, oldIndex);
+        m_resetPending = false;
+        //qDebug() << "WATCHHANDLER: RESET ABOUT TO EMIT";
+        emit reset();
+        //qDebug() << "WATCHHANDLER: RESET EMITTED";
+    }
     m_inChange = false;
 
     #if DEBUG_MODEL
@@ -783,13 +894,11 @@ void WatchHandler::rebuildModel()
 
 void WatchHandler::cleanup()
 {
-    m_oldSet.clear();
     m_expandedINames.clear();
     m_displayedINames.clear();
 
-    m_incompleteSet.clear();
-    m_completeSet = initialSet();
-    m_displaySet = m_completeSet;
+    resetCompleteSet();
+    resetDisplaySet();
 
 #if 0
     for (EditWindows::ConstIterator it = m_editWindows.begin();
@@ -837,12 +946,8 @@ void WatchHandler::expandChildren(const QModelIndex &idx)
     int index = idx.internalId();
     if (index == 0)
         return;
-    QTC_ASSERT(index >= 0, qDebug() << toString() << index; return);
-    QTC_ASSERT(index < m_completeSet.size(), qDebug() << toString() << index; return);
+    QTC_ASSERT(checkIndex(index), qDebug() << toString() << index; return);
     const WatchData &display = m_displaySet.at(index);
-    QTC_ASSERT(index >= 0, qDebug() << toString() << index; return);
-    QTC_ASSERT(index < m_completeSet.size(), qDebug() << toString() << index; return);
-    const WatchData &complete = m_completeSet.at(index);
     MODEL_DEBUG("\n\nEXPAND" << display.iname);
     if (display.iname.isEmpty()) {
         // This should not happen but the view seems to send spurious
@@ -863,7 +968,7 @@ void WatchHandler::expandChildren(const QModelIndex &idx)
 
     // This is a performance hack and not strictly necessary.
     // Remove it if there are troubles when expanding nodes.
-    if (0 && complete.childCount > 0 && complete.childIndex.size() > 0) {
+    if (0 && display.childCount > 0 && display.childIndex.size() > 0) {
         MODEL_DEBUG("SKIP FETCHING CHILDREN");
         return;
     }
@@ -881,9 +986,9 @@ void WatchHandler::insertData(const WatchData &data)
     //MODEL_DEBUG("INSERTDATA: " << data.toString());
     QTC_ASSERT(data.isValid(), return);
     if (data.isSomethingNeeded())
-        insertDataHelper(m_incompleteSet, data);
+        insertDataHelper(m_incompleteSet, m_incompleteIndex, data);
     else
-        insertDataHelper(m_completeSet, data);
+        insertDataHelper(m_completeSet, m_completeIndex, data);
     //MODEL_DEBUG("INSERT RESULT" << toString());
 }
 
@@ -979,7 +1084,7 @@ void WatchHandler::removeWatchExpression(const QString &exp)
     for (int i = m_completeSet.size(); --i >= 0;) {
         const WatchData & data = m_completeSet.at(i);
         if (data.iname.startsWith("watch.") && data.exp == exp) {
-            m_completeSet.takeAt(i);
+            take(data.iname, &m_completeSet, &m_completeIndex);
             break;
         }
     }
@@ -990,8 +1095,7 @@ void WatchHandler::removeWatchExpression(const QString &exp)
 
 void WatchHandler::reinitializeWatchers()
 {
-    m_completeSet = initialSet();
-    m_incompleteSet.clear();
+    resetCompleteSet();
     reinitializeWatchersHelper();
 }
 
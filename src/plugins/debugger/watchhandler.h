@@ -197,9 +197,23 @@ signals:
 
 private:
     void reinitializeWatchersHelper();
+    void resetCompleteSet();
     WatchData takeData(const QString &iname);
     QString toString() const;
 
+    // Incremental maintenance of the display tree
+    void resetDisplaySet();
+    void updateDisplaySet(const QList<WatchData> &oldSet,
+        const QHash<QString, int> &oldIndex);
+    void removeObsoleteNodes(int id);
+    int insertDisplayNode(int parentId, int row, const WatchData &data,
+        bool isDummy);
+    void removeDisplayNode(int parentId, int row);
+    void releaseDisplayNode(int id);
+    void updateDisplayNode(int id, const WatchData &data);
+    bool isDummy(int id) const;
+    QModelIndex modelIndex(int id) const;
+
     void loadWatchers();
     void saveWatchers();
 
@@ -211,8 +225,12 @@ private:
 
     QList<WatchData> m_incompleteSet;
     QList<WatchData> m_completeSet;
-    QList<WatchData> m_oldSet;
     QList<WatchData> m_displaySet;
+    QHash<QString, int> m_incompleteIndex; // iname -> position in m_incompleteSet
+    QHash<QString, int> m_completeIndex;   // iname -> position in m_completeSet
+    QHash<QString, int> m_displayIndex;    // iname -> node in m_displaySet
+    QList<int> m_freeDisplayNodes;         // released nodes in m_displaySet
+    bool m_resetPending;                   // no row signals while rebuilding
     QStringList m_watchers;
 
     void setDisplayedIName(const QString &iname, bool on);
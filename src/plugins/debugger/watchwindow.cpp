@@ -188,6 +188,14 @@ void WatchWindow::reset()
     resetHelper(model()->index(0, 0));
 }
 
+void WatchWindow::rowsInserted(const QModelIndex &parent, int start, int end)
+{
+    QTreeView::rowsInserted(parent, start, end);
+    // Restore the expansion state of nodes that come back
+    for (int row = start; row <= end; ++row)
+        resetHelper(model()->index(row, 0, parent));
+}
+
 void WatchWindow::setModel(QAbstractItemModel *model)
 {
     QTreeView::setModel(model);
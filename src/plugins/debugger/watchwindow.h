@@ -81,6 +81,7 @@ private:
     void contextMenuEvent(QContextMenuEvent *ev);
     void editItem(const QModelIndex &idx);
     void reset(); /* reimpl */
+    void rowsInserted(const QModelIndex &parent, int start, int end); /* reimpl */
 
     void resetHelper(const QModelIndex &idx);
 
@@ -86,10 +86,13 @@ IQuickOpenFilter::Priority HelpIndexFilter::priority() const
     return Medium;
 }
 
-QList<FilterEntry> HelpIndexFilter::matchesFor(const QString &entry)
+QList<FilterEntry> HelpIndexFilter::matchesFor(QFutureInterface<FilterEntry> &future,
+                                               const QString &entry)
 {
     QList<FilterEntry> entries;
     foreach (const QString &string, m_helpIndex) {
+        if (future.isCanceled())
+            break;
         if (string.contains(entry, Qt::CaseInsensitive)) {
             FilterEntry entry(this, string, QVariant(), m_icon);
             entries.append(entry);
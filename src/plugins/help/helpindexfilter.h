@@ -59,7 +59,9 @@ public:
     QString trName() const;
     QString name() const;
     Priority priority() const;
-    QList<QuickOpen::FilterEntry> matchesFor(const QString &entry);
+    QList<QuickOpen::FilterEntry> matchesFor(QFutureInterface<QuickOpen::FilterEntry> &future,
+                                             const QString &entry);
+    bool isThreadSafe() const { return false; }
     void accept(QuickOpen::FilterEntry selection) const;
     void refresh(QFutureInterface<void> &future);
 
@@ -41,6 +41,8 @@
 #include <QtCore/QTimer>
 #include <QtGui/QTextDocument>
 
+#include <string.h>
+
 using namespace ProjectExplorer;
 
 AbstractProcessStep::AbstractProcessStep(Project *pro)
@@ -145,6 +147,9 @@ void AbstractProcessStep::run(QFutureInterface<bool> & fi)
     }
     processStarted();
 
+    m_stdOutBuffer.clear();
+    m_stdErrorBuffer.clear();
+
     m_timer = new QTimer();
     connect(m_timer, SIGNAL(timeout()), this, SLOT(checkForCancel()), Qt::DirectConnection);
     m_timer->start(500);
@@ -187,30 +192,61 @@ void AbstractProcessStep::processStartupFailed()
 
 void AbstractProcessStep::processReadyReadStdOutput()
 {
-    m_process->setReadChannel(QProcess::StandardOutput);
-    while (m_process->canReadLine()) {
-        QString line = QString::fromLocal8Bit(m_process->readLine()).trimmed();
-        stdOut(line);
-    }
+    m_stdOutBuffer += m_process->readAllStandardOutput();
+    processLines(&m_stdOutBuffer, false, false);
+    flushOutput();
 }
 
 void AbstractProcessStep::stdOut(const QString &line)
 {
-    emit addToOutputWindow(Qt::escape(line));
+    m_pendingLines.append(Qt::escape(line));
 }
 
 void AbstractProcessStep::processReadyReadStdError()
 {
-    m_process->setReadChannel(QProcess::StandardError);
-    while (m_process->canReadLine()) {
-        QString line = QString::fromLocal8Bit(m_process->readLine()).trimmed();
-        stdError(line);
-    }
+    m_stdErrorBuffer += m_process->readAllStandardError();
+    processLines(&m_stdErrorBuffer, true, false);
+    flushOutput();
 }
 
 void AbstractProcessStep::stdError(const QString &line)
 {
-    emit addToOutputWindow(QLatin1String("<font color=\"#ff0000\">") + Qt::escape(line) + QLatin1String("</font>"));
+    m_pendingLines.append(QLatin1String("<font color=\"#ff0000\">") + Qt::escape(line) + QLatin1String("</font>"));
+}
+
+void AbstractProcessStep::flushOutput()
+{
+    if (m_pendingLines.isEmpty())
+        return;
+
+    emit addLinesToOutputWindow(m_pendingLines);
+    m_pendingLines.clear();
+}
+
+// Hands the complete lines of \a buffer to stdOut() or stdError() and keeps
+// the incomplete last one for the next block, unless \a atEnd is set.
+void AbstractProcessStep::processLines(QByteArray *buffer, bool isStdError, bool atEnd)
+{
+    const char *data = buffer->constData();
+    const char *end = data + buffer->size();
+    const char *begin = data;
+
+    while (begin != end) {
+        const char *newline = static_cast<const char *>(memchr(begin, '\n', end - begin));
+        if (!newline && !atEnd)
+            break;
+
+        const char *lineEnd = newline ? newline : end;
+        const QString line = QString::fromLocal8Bit(begin, lineEnd - begin).trimmed();
+        if (isStdError)
+            stdError(line);
+        else
+            stdOut(line);
+
+        begin = newline ? newline + 1 : end;
+    }
+
+    buffer->remove(0, begin - data);
 }
 
 void AbstractProcessStep::checkForCancel()
@@ -225,13 +261,13 @@ void AbstractProcessStep::checkForCancel()
 
 void AbstractProcessStep::slotProcessFinished(int, QProcess::ExitStatus)
 {
-    QString line = QString::fromLocal8Bit(m_process->readAllStandardError()).trimmed();
-    if (!line.isEmpty())
-        stdOut(line);
+    m_stdErrorBuffer += m_process->readAllStandardError();
+    processLines(&m_stdErrorBuffer, true, true);
+
+    m_stdOutBuffer += m_process->readAllStandardOutput();
+    processLines(&m_stdOutBuffer, false, true);
 
-    line = QString::fromLocal8Bit(m_process->readAllStandardOutput()).trimmed();
-    if (!line.isEmpty())
-        stdError(line);
+    flushOutput();
 
     m_eventLoop->exit(0);
 }
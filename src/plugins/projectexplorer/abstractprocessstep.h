@@ -57,6 +57,8 @@ namespace ProjectExplorer {
     Inside YourBuildStep::run() call AbstractProcessStep::run(), which automatically starts the proces
     and by default adds the output on stdOut and stdErr to the OutputWindow.
     If you need to process the process output override stdOut() and/or stdErr.
+    The output is read in blocks and split into lines on the build thread; the lines
+    of one block reach the OutputWindow in a single batch.
     The two functions processStarted() and processFinished() are called after starting/finishing the process.
     By default they add a message to the output window.
 
@@ -120,12 +122,15 @@ protected:
     virtual void processStartupFailed();
     virtual void stdOut(const QString &line);
     virtual void stdError(const QString &line);
+    // Adds the pending lines of stdOut() and stdError() to the output window
+    void flushOutput();
 private slots:
     void processReadyReadStdOutput();
     void processReadyReadStdError();
     void slotProcessFinished(int, QProcess::ExitStatus);
     void checkForCancel();
 private:
+    void processLines(QByteArray *buffer, bool isStdError, bool atEnd);
 
     QTimer *m_timer;
     QFutureInterface<bool> *m_futureInterface;
@@ -136,6 +141,9 @@ private:
     QProcess *m_process;
     QEventLoop *m_eventLoop;
     ProjectExplorer::Environment m_environment;
+    QByteArray m_stdOutBuffer; // incomplete last line of the output
+    QByteArray m_stdErrorBuffer;
+    QStringList m_pendingLines;
 };
 
 } // namespace ProjectExplorer
@@ -56,12 +56,11 @@ AllProjectsFilter::AllProjectsFilter(ProjectExplorerPlugin *pe, ICore *core)
 void AllProjectsFilter::refreshInternally()
 {
     m_files.clear();
-    SessionManager *session = m_projectExplorer->session();
-    if (!session)
-        return;
-    foreach (Project *project, session->projects())
-        m_files += project->files(Project::AllFiles);
-    qSort(m_files);
+    if (SessionManager *session = m_projectExplorer->session()) {
+        foreach (Project *project, session->projects())
+            m_files += project->files(Project::AllFiles);
+        qSort(m_files);
+    }
     generateFileNames();
 }
 
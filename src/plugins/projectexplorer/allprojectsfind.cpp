@@ -101,6 +101,11 @@ QStringList AllProjectsFind::files()
     return files;
 }
 
+const Core::Utils::TrigramIndex *AllProjectsFind::textIndex() const
+{
+    return m_plugin->textIndex();
+}
+
 QWidget *AllProjectsFind::createConfigWidget()
 {
     if (!m_configWidget) {
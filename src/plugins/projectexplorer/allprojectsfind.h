@@ -69,6 +69,7 @@ public:
 
 protected:
     QStringList files();
+    const Core::Utils::TrigramIndex *textIndex() const;
 
 private:
     ProjectExplorerPlugin *m_plugin;
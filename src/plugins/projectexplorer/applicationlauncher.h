@@ -34,6 +34,7 @@
 #ifndef APPLICATIONLAUNCHER_H
 #define APPLICATIONLAUNCHER_H
 
+#include <QtCore/QByteArray>
 #include <QtCore/QObject>
 #include <QtCore/QStringList>
 #include <QtCore/QProcess>
@@ -66,7 +67,8 @@ public:
 
 signals:
     void applicationError(const QString &error);
-    void appendOutput(const QString &line);
+    // one or more lines, separated by '\n'
+    void appendOutput(const QString &lines);
     void processExited(int exitCode);
     void bringToForegroundRequested(qint64 pid);
 
@@ -87,6 +89,7 @@ private:
     QProcess *m_guiProcess;
     ConsoleProcess *m_consoleProcess;
     Mode m_currentMode;
+    QByteArray m_outputBuffer; // the incomplete last line
 
     WinGuiProcess *m_winGuiProcess;
 };
@@ -79,6 +79,7 @@ void ApplicationLauncher::start(Mode mode, const QString &program, const QString
 {
     m_currentMode = mode;
     if (mode == Gui) {
+        m_outputBuffer.clear();
         m_guiProcess->start(program, args);
     } else {
         m_consoleProcess->start(program, args);
@@ -135,13 +136,14 @@ void ApplicationLauncher::guiProcessError()
 
 void ApplicationLauncher::readStandardOutput()
 {
-    m_guiProcess->setReadChannel(QProcess::StandardOutput);
-    while (m_guiProcess->canReadLine()) {
-        QString line = QString::fromLocal8Bit(m_guiProcess->readLine());
-        if (line.endsWith(QLatin1Char('\n')))
-            line.chop(1);
-        emit appendOutput(line);
-    }
+    // Pass on all complete lines at once, a partial line waits for the rest.
+    m_outputBuffer += m_guiProcess->readAllStandardOutput();
+    const int lastNewLine = m_outputBuffer.lastIndexOf('\n');
+    if (lastNewLine == -1)
+        return;
+    const QString lines = QString::fromLocal8Bit(m_outputBuffer.constData(), lastNewLine);
+    m_outputBuffer.remove(0, lastNewLine + 1);
+    emit appendOutput(lines);
 }
 
 void ApplicationLauncher::processStopped()
@@ -151,6 +153,11 @@ void ApplicationLauncher::processStopped()
 
 void ApplicationLauncher::processDone(int exitCode, QProcess::ExitStatus)
 {
+    readStandardOutput();
+    if (!m_outputBuffer.isEmpty()) {
+        emit appendOutput(QString::fromLocal8Bit(m_outputBuffer));
+        m_outputBuffer.clear();
+    }
     emit processExited(exitCode);
 }
 
@@ -116,6 +116,8 @@ void BuildManager::cancel()
                    this, SLOT(addToTaskWindow(QString, int, int, QString)));
         disconnect(m_currentBuildStep, SIGNAL(addToOutputWindow(QString)),
                    this, SLOT(addToOutputWindow(QString)));
+        disconnect(m_currentBuildStep, SIGNAL(addLinesToOutputWindow(QStringList)),
+                   this, SLOT(addLinesToOutputWindow(QStringList)));
         decrementActiveBuildSteps(m_currentBuildStep->project());
 
         m_progressFutureInterface->setProgressValueAndText(m_progress, "Build canceled"); //TODO NBS fix in qtconcurrent
@@ -223,6 +225,11 @@ void BuildManager::addToOutputWindow(const QString &string)
     m_outputWindow->appendText(string);
 }
 
+void BuildManager::addLinesToOutputWindow(const QStringList &lines)
+{
+    m_outputWindow->appendLines(lines);
+}
+
 void BuildManager::nextBuildQueue()
 {
     if (m_canceling)
@@ -232,6 +239,8 @@ void BuildManager::nextBuildQueue()
                 this, SLOT(addToTaskWindow(QString, int, int, QString)));
     disconnect(m_currentBuildStep, SIGNAL(addToOutputWindow(QString)),
                this, SLOT(addToOutputWindow(QString)));
+    disconnect(m_currentBuildStep, SIGNAL(addLinesToOutputWindow(QStringList)),
+               this, SLOT(addLinesToOutputWindow(QStringList)));
 
     ++m_progress;
     const QString &progressText = tr("Finished %1 of %2 build steps").arg(m_progress).arg(m_maxProgress);
@@ -265,6 +274,8 @@ void BuildManager::nextStep()
                 this, SLOT(addToTaskWindow(QString, int, int, QString)));
         connect(m_currentBuildStep, SIGNAL(addToOutputWindow(QString)),
                 this, SLOT(addToOutputWindow(QString)));
+        connect(m_currentBuildStep, SIGNAL(addLinesToOutputWindow(QStringList)),
+                this, SLOT(addLinesToOutputWindow(QStringList)));
 
         bool init = m_currentBuildStep->init(m_currentConfiguration);
         if (!init) {
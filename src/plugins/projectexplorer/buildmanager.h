@@ -99,6 +99,7 @@ signals:
 private slots:
     void addToTaskWindow(const QString &file, int type, int line, const QString &description);
     void addToOutputWindow(const QString &string);
+    void addLinesToOutputWindow(const QStringList &lines);
 
     void nextBuildQueue();
     void emitCancelMessage();
@@ -132,6 +132,8 @@ protected:
 Q_SIGNALS:
     void addToTaskWindow(const QString &filename, int type, int linenumber, const QString &description);
     void addToOutputWindow(const QString &string);
+    // a batch of lines, each of them is added like by addToOutputWindow()
+    void addLinesToOutputWindow(const QStringList &lines);
 
     void displayNameChanged(BuildStep *, const QString &displayName);
 
@@ -81,6 +81,15 @@ void CompileOutputWindow::appendText(const QString &text)
     m_textEdit->append(text);
 }
 
+void CompileOutputWindow::appendLines(const QStringList &lines)
+{
+    // repaint once for the whole batch
+    m_textEdit->setUpdatesEnabled(false);
+    foreach (const QString &line, lines)
+        m_textEdit->append(line);
+    m_textEdit->setUpdatesEnabled(true);
+}
+
 void CompileOutputWindow::clearContents()
 {
     m_textEdit->clear();
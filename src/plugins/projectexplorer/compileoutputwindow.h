@@ -57,6 +57,7 @@ public:
     void clearContents();
     void visibilityChanged(bool visible);
     void appendText(const QString &text);
+    void appendLines(const QStringList &lines);
     bool canFocus();
     bool hasFocus();
     void setFocus();
@@ -62,10 +62,10 @@ CurrentProjectFilter::CurrentProjectFilter(ProjectExplorerPlugin *pe,
 void CurrentProjectFilter::refreshInternally()
 {
     m_files.clear();
-    if (!m_project)
-        return;
-    m_files = m_project->files(Project::AllFiles);
-    qSort(m_files);
+    if (m_project) {
+        m_files = m_project->files(Project::AllFiles);
+        qSort(m_files);
+    }
     generateFileNames();
 }
 
@@ -97,6 +97,11 @@ QStringList CurrentProjectFind::files()
     return files;
 }
 
+const Core::Utils::TrigramIndex *CurrentProjectFind::textIndex() const
+{
+    return m_plugin->textIndex();
+}
+
 QWidget *CurrentProjectFind::createConfigWidget()
 {
     if (!m_configWidget) {
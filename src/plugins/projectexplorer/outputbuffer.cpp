@@ -0,0 +1,295 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "outputbuffer.h"
+
+#include <QtCore/QtAlgorithms>
+
+#include <string.h>
+
+using namespace ProjectExplorer::Internal;
+
+namespace {
+
+enum {
+    MinimumChunkSize = 4 * 1024,
+    MaximumChunkSize = 1024 * 1024
+};
+
+bool isWordCharacter(const QChar &c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
+
+bool isWholeWord(const QString &line, int column, int length)
+{
+    return (column == 0 || !isWordCharacter(line.at(column - 1)))
+            && (column + length == line.length() || !isWordCharacter(line.at(column + length)));
+}
+
+} // anonymous namespace
+
+OutputBuffer::OutputBuffer(int maximumSize)
+    : m_lineCount(0),
+      m_size(0)
+{
+    setMaximumSize(maximumSize);
+}
+
+void OutputBuffer::setMaximumSize(int bytes)
+{
+    m_maximumSize = qMax(int(MinimumChunkSize), bytes);
+
+    // about 16 chunks, so that dropping the oldest one does not empty the window.
+    m_chunkSize = qBound(int(MinimumChunkSize), m_maximumSize / 16, int(MaximumChunkSize));
+    dropOldestChunks();
+}
+
+int OutputBuffer::maximumSize() const
+{
+    return m_maximumSize;
+}
+
+int OutputBuffer::size() const
+{
+    return m_size;
+}
+
+int OutputBuffer::lineCount() const
+{
+    return m_lineCount;
+}
+
+QString OutputBuffer::line(int index) const
+{
+    const int c = chunkForLine(index);
+    if (c == -1)
+        return QString();
+
+    const Chunk &chunk = m_chunks.at(c);
+    const int i = index - chunk.firstLine;
+    const int begin = chunk.lineOffsets.at(i);
+    const int end = (i + 1 < chunk.lineOffsets.size()) ? chunk.lineOffsets.at(i + 1) : chunk.data.size();
+    return QString::fromUtf8(chunk.data.constData() + begin, end - begin - 1); // without the '\n'
+}
+
+int OutputBuffer::append(const QString &text)
+{
+    const QByteArray data = text.toUtf8();
+    const char *begin = data.constData();
+    const char *end = begin + data.size();
+
+    for (;;) {
+        const char *newline = static_cast<const char *>(memchr(begin, '\n', end - begin));
+        const char *lineEnd = newline ? newline : end;
+        if (lineEnd != begin && lineEnd[-1] == '\r')
+            appendLine(begin, lineEnd - begin - 1);
+        else
+            appendLine(begin, lineEnd - begin);
+
+        if (!newline)
+            break;
+        begin = newline + 1;
+    }
+
+    return dropOldestChunks();
+}
+
+void OutputBuffer::appendLine(const char *data, int size)
+{
+    if (m_chunks.isEmpty()
+            || (m_chunks.last().data.size() + size + 1 > m_chunkSize && !m_chunks.last().data.isEmpty())) {
+        Chunk chunk;
+        chunk.firstLine = m_lineCount;
+        chunk.data.reserve(qMax(m_chunkSize, size + 1));
+        m_chunks.append(chunk);
+    }
+
+    Chunk &chunk = m_chunks.last();
+    chunk.lineOffsets.append(chunk.data.size());
+    chunk.data.append(data, size);
+    chunk.data.append('\n');
+
+    ++m_lineCount;
+    m_size += size + 1;
+}
+
+int OutputBuffer::dropOldestChunks()
+{
+    int dropped = 0;
+    while (m_size > m_maximumSize && m_chunks.size() > 1) {
+        const Chunk chunk = m_chunks.takeFirst();
+        dropped += chunk.lineOffsets.size();
+        m_size -= chunk.data.size();
+    }
+
+    if (dropped) {
+        m_lineCount -= dropped;
+        for (int i = 0; i < m_chunks.size(); ++i)
+            m_chunks[i].firstLine -= dropped;
+    }
+    return dropped;
+}
+
+void OutputBuffer::clear()
+{
+    m_chunks.clear();
+    m_lineCount = 0;
+    m_size = 0;
+}
+
+int OutputBuffer::chunkForLine(int line) const
+{
+    if (line < 0 || line >= m_lineCount)
+        return -1;
+
+    // the last chunk whose first line is not after line
+    int first = 0;
+    int count = m_chunks.size();
+    while (count > 0) {
+        const int half = count / 2;
+        const int middle = first + half;
+        if (m_chunks.at(middle).firstLine <= line) {
+            first = middle + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first - 1;
+}
+
+bool OutputBuffer::find(const QString &text, QTextDocument::FindFlags flags,
+                        int *lineNumber, int *column) const
+{
+    if (text.isEmpty() || text.contains(QLatin1Char('\n')) || !m_lineCount)
+        return false;
+
+    *lineNumber = qBound(0, *lineNumber, m_lineCount - 1);
+
+    // A case sensitive search does not need to decode the lines it skips.
+    if (flags & QTextDocument::FindCaseSensitively)
+        return findBytes(text, flags, lineNumber, column);
+
+    return findInLines(text, flags, lineNumber, column);
+}
+
+bool OutputBuffer::findBytes(const QString &text, QTextDocument::FindFlags flags,
+                             int *lineNumber, int *column) const
+{
+    const bool backward = flags & QTextDocument::FindBackward;
+    const QByteArray bytes = text.toUtf8();
+
+    int c = chunkForLine(*lineNumber);
+    const Chunk &startChunk = m_chunks.at(c);
+    int from = startChunk.lineOffsets.at(*lineNumber - startChunk.firstLine)
+            + line(*lineNumber).left(*column).toUtf8().size();
+
+    while (c >= 0 && c < m_chunks.size()) {
+        const Chunk &chunk = m_chunks.at(c);
+
+        // the matches cannot span lines, the text contains no '\n'.
+        int index;
+        if (!backward)
+            index = chunk.data.indexOf(bytes, from);
+        else
+            index = (from == 0) ? -1 : chunk.data.lastIndexOf(bytes, from - 1);
+
+        while (index != -1) {
+            const QVector<int>::const_iterator lineOffset =
+                    qUpperBound(chunk.lineOffsets.constBegin(), chunk.lineOffsets.constEnd(), index) - 1;
+            const int matchLine = chunk.firstLine + (lineOffset - chunk.lineOffsets.constBegin());
+            const int matchColumn = QString::fromUtf8(chunk.data.constData() + *lineOffset,
+                                                      index - *lineOffset).length();
+
+            if (!(flags & QTextDocument::FindWholeWords)
+                    || isWholeWord(line(matchLine), matchColumn, text.length())) {
+                *lineNumber = matchLine;
+                *column = matchColumn;
+                return true;
+            }
+
+            if (!backward)
+                index = chunk.data.indexOf(bytes, index + 1);
+            else
+                index = (index == 0) ? -1 : chunk.data.lastIndexOf(bytes, index - 1);
+        }
+
+        if (!backward) {
+            ++c;
+            from = 0;
+        } else if (--c >= 0) {
+            from = m_chunks.at(c).data.size();
+        }
+    }
+    return false;
+}
+
+bool OutputBuffer::findInLines(const QString &text, QTextDocument::FindFlags flags,
+                               int *lineNumber, int *column) const
+{
+    const bool backward = flags & QTextDocument::FindBackward;
+    const Qt::CaseSensitivity cs = (flags & QTextDocument::FindCaseSensitively)
+            ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    for (int i = *lineNumber; i >= 0 && i < m_lineCount; i += backward ? -1 : 1) {
+        const QString l = line(i);
+
+        // a match starts at or after from, or before it when searching backward.
+        int from;
+        if (i == *lineNumber)
+            from = *column;
+        else
+            from = backward ? l.length() + 1 : 0;
+
+        int index;
+        if (!backward)
+            index = l.indexOf(text, from, cs);
+        else
+            index = (from == 0) ? -1 : l.lastIndexOf(text, from - 1, cs);
+
+        while (index != -1) {
+            if (!(flags & QTextDocument::FindWholeWords) || isWholeWord(l, index, text.length())) {
+                *lineNumber = i;
+                *column = index;
+                return true;
+            }
+
+            if (!backward)
+                index = l.indexOf(text, index + 1, cs);
+            else
+                index = (index == 0) ? -1 : l.lastIndexOf(text, index - 1, cs);
+        }
+    }
+    return false;
+}
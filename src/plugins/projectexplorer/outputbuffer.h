@@ -0,0 +1,107 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtGui/QTextDocument>
+
+namespace ProjectExplorer {
+namespace Internal {
+
+/*
+    The lines of an application output window.
+
+    The lines are kept UTF-8 encoded in chunks of contiguous memory, each
+    with the offsets of its lines, and are decoded only when they are asked
+    for. When the buffer grows beyond its maximum size the oldest chunks are
+    dropped, so the memory used stays bounded however long the application
+    runs.
+*/
+class OutputBuffer
+{
+public:
+    enum {
+        DefaultMaximumSize = 32 * 1024 * 1024 // bytes
+    };
+
+    OutputBuffer(int maximumSize = DefaultMaximumSize);
+
+    void setMaximumSize(int bytes);
+    int maximumSize() const;
+    int size() const;
+
+    int lineCount() const;
+    QString line(int index) const;
+
+    // Appends the lines of \a text, returns how many of the oldest lines
+    // were dropped to stay below the maximum size.
+    int append(const QString &text);
+    void clear();
+
+    // Searches \a text starting at \a lineNumber and \a column, which are
+    // set to the position of the match if there is one.
+    bool find(const QString &text, QTextDocument::FindFlags flags,
+              int *lineNumber, int *column) const;
+
+private:
+    struct Chunk
+    {
+        int firstLine;
+        QByteArray data;          // the lines, each one terminated by '\n'
+        QVector<int> lineOffsets; // the start of each line in data
+    };
+
+    void appendLine(const char *data, int size);
+    int dropOldestChunks();
+    int chunkForLine(int line) const;
+    bool findBytes(const QString &text, QTextDocument::FindFlags flags,
+                   int *lineNumber, int *column) const;
+    bool findInLines(const QString &text, QTextDocument::FindFlags flags,
+                     int *lineNumber, int *column) const;
+
+    QList<Chunk> m_chunks;
+    int m_lineCount;
+    int m_size;
+    int m_maximumSize;
+    int m_chunkSize;
+};
+
+} // namespace Internal
+} // namespace ProjectExplorer
+
+#endif // OUTPUTBUFFER_H
@@ -35,10 +35,15 @@
 #include "projectexplorerconstants.h"
 #include "runconfiguration.h"
 
-#include <find/basetextfind.h>
 #include <aggregation/aggregate.h>
+#include <coreplugin/icore.h>
+#include <extensionsystem/pluginmanager.h>
+#include <utils/qtcassert.h>
 
+#include <QtCore/QSettings>
 #include <QtGui/QIcon>
+#include <QtGui/QKeyEvent>
+#include <QtGui/QLabel>
 #include <QtGui/QScrollBar>
 #include <QtGui/QTextLayout>
 #include <QtGui/QPainter>
@@ -49,6 +54,8 @@
 #include <QtGui/QVBoxLayout>
 #include <QtGui/QTabWidget>
 
+#include <limits.h>
+
 using namespace ProjectExplorer::Internal;
 using namespace ProjectExplorer;
 
@@ -115,8 +122,17 @@ void OutputPane::closeTab(int index)
 }
 
 OutputPane::OutputPane()
-        : m_mainWidget(new QWidget)
-{
+        : m_mainWidget(new QWidget),
+          m_maximumOutputSize(OutputBuffer::DefaultMaximumSize)
+{
+    Core::ICore *core = ExtensionSystem::PluginManager::instance()->getObject<Core::ICore>();
+    if (QSettings *s = core->settings()) {
+        // in megabytes
+        const int megabytes = s->value("ProjectExplorer/Settings/MaximumOutputSize",
+                                       int(OutputBuffer::DefaultMaximumSize) / (1024 * 1024)).toInt();
+        m_maximumOutputSize = qBound(1, megabytes, 1024) * 1024 * 1024;
+    }
+
 //     m_insertLineButton = new QToolButton;
 //     m_insertLineButton->setIcon(QIcon(ProjectExplorer::Constants::ICON_INSERT_LINE));
 //     m_insertLineButton->setText(tr("Insert line"));
@@ -214,9 +230,10 @@ void OutputPane::createNewOutputWindow(RunControl *rc)
     }
     if (!found) {
         OutputWindow *ow = new OutputWindow(m_tabWidget);
+        ow->setMaximumBufferSize(m_maximumOutputSize);
         Aggregation::Aggregate *agg = new Aggregation::Aggregate;
         agg->add(ow);
-        agg->add(new Find::BaseTextFind(ow));
+        agg->add(new OutputWindowFind(ow));
         m_outputWindows.insert(rc, ow);
         m_tabWidget->addTab(ow, rc->runConfiguration()->name());
     }
@@ -288,183 +305,278 @@ int OutputPane::priorityInStatusBar() const
 
 /*******************/
 
+namespace {
+
+enum {
+    FrameInterval = 16 // ms
+};
+
+// Lays out the single line of an output window line.
+QTextLine layoutLine(QTextLayout *textLayout)
+{
+    textLayout->beginLayout();
+    QTextLine line = textLayout->createLine();
+    if (line.isValid())
+        line.setLineWidth(INT_MAX/256);
+    textLayout->endLayout();
+    return line;
+}
+
+} // anonymous namespace
+
 OutputWindow::OutputWindow(QWidget *parent)
-    : QPlainTextEdit(parent)
+    : QAbstractScrollArea(parent),
+      m_scrolledPastLines(0),
+      m_droppedLines(0),
+      m_indicator(new QLabel(this)),
+      m_widthUsed(0),
+      m_blockScroll(false)
 {
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
-    //setCenterOnScroll(false);
-    //setMaximumBlockCount(10000);
     setWindowTitle(tr("Application Output Window"));
     setWindowIcon(QIcon(":/qt4projectmanager/images/window.png"));
     setFrameShape(QFrame::NoFrame);
-}
+    viewport()->setCursor(Qt::IBeamCursor);
 
+    m_indicator->setAutoFillBackground(true);
+    m_indicator->setMargin(2);
+    m_indicator->setToolTip(tr("Lines that scrolled past came in too fast to be painted, they are all "
+                               "kept in the output. Dropped lines exceeded the maximum output size "
+                               "and are gone."));
+    m_indicator->hide();
+}
 
 OutputWindow::~OutputWindow()
 {
 }
 
-void OutputWindow::appendOutput(const QString &out)
+void OutputWindow::setMaximumBufferSize(int bytes)
 {
-    appendPlainText(out);
+    m_buffer.setMaximumSize(bytes);
+    m_selectionStart = m_selectionEnd = Position();
+    updateScrollBars();
+    viewport()->update();
 }
 
-void OutputWindow::insertLine()
+int OutputWindow::maximumBufferSize() const
 {
-    appendPlainText(QString());
+    return m_buffer.maximumSize();
 }
 
-#if 0
-OutputWindow::OutputWindow(QWidget *parent)
-        : QAbstractScrollArea(parent)
+const OutputBuffer &OutputWindow::buffer() const
 {
-    max_lines = 1000;
-    width_used = 0;
-    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
-    same_height = true;
-    block_scroll = false;
-    setWindowTitle(tr("Application Output Window"));
-    setWindowIcon(QIcon(":/qt4projectmanager/images/window.png"));
+    return m_buffer;
 }
 
-void OutputWindow::changed() {
-    int remove = lines.size() - max_lines;
-    if (remove > 0) {
-        selection_start.line -= remove;
-        selection_end.line -= remove;
-        selection_start = qMax(selection_start, Selection());
-        selection_end = qMax(selection_end, Selection());
-        if (remove > verticalScrollBar()->value()) {
-            if (same_height)
-                viewport()->scroll(0, -remove * fontMetrics().lineSpacing());
-            else
-                viewport()->update();
-        } else {
-            block_scroll = true;
-            verticalScrollBar()->setValue(verticalScrollBar()->value() - remove);
-            block_scroll = false;
-        }
-        while (remove--)
-            lines.removeFirst();
-    }
-
-    verticalScrollBar()->setRange(0, lines.size() - 1);
-
+int OutputWindow::lineSpacing() const
+{
+    return fontMetrics().lineSpacing();
 }
 
+int OutputWindow::visibleLineCount() const
+{
+    return qMax(1, viewport()->height() / lineSpacing());
+}
 
-bool OutputWindow::getCursorPos(int *lineNumber, int *position, const QPoint &pos) {
-    if (lines.isEmpty())
-        return false;
-    *lineNumber = verticalScrollBar()->value();
+void OutputWindow::updateScrollBars()
+{
+    const int visibleLines = visibleLineCount();
+    verticalScrollBar()->setRange(0, qMax(0, m_buffer.lineCount() - visibleLines));
+    verticalScrollBar()->setPageStep(visibleLines);
+    horizontalScrollBar()->setRange(0, qMax(0, m_widthUsed - viewport()->width()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+}
 
-    int x = 4 - horizontalScrollBar()->value();
+void OutputWindow::updateLines(int first, int last)
+{
+    const int spacing = lineSpacing();
+    const int top = verticalScrollBar()->value();
+    viewport()->update(QRect(0, (first - top) * spacing,
+                             viewport()->width(), (last - first + 1) * spacing));
+}
 
-    int spacing = fontMetrics().lineSpacing();
-    int leading = fontMetrics().leading();
-    int height = 0;
+void OutputWindow::appendOutput(const QString &out)
+{
+    m_pendingOutput.append(out);
+    if (!m_frameTimer.isActive())
+        m_frameTimer.start(FrameInterval, this);
+}
 
-    QTextLayout textLayout;
-    textLayout.setFont(font());
+void OutputWindow::flushOutput()
+{
+    m_frameTimer.stop();
+    if (m_pendingOutput.isEmpty())
+        return;
 
-    if (same_height && pos.y() > 0) {
-        int skipLines = pos.y() / spacing;
-        height += skipLines * spacing;
-        *lineNumber = qMin(*lineNumber + skipLines, lines.size() - 1);
+    const QString out = m_pendingOutput.join(QString(QLatin1Char('\n')));
+    m_pendingOutput.clear();
+
+    QScrollBar *scrollBar = verticalScrollBar();
+    const bool atBottom = scrollBar->value() == scrollBar->maximum();
+    const int firstNewLine = m_buffer.lineCount();
+    const int dropped = m_buffer.append(out);
+
+    // Following the output only the last page of this frame gets painted.
+    const int added = m_buffer.lineCount() - firstNewLine + dropped;
+    const int scrolledPast = atBottom ? qMax(0, added - visibleLineCount()) : 0;
+    if (scrolledPast || dropped) {
+        m_scrolledPastLines += scrolledPast;
+        m_droppedLines += dropped;
+        updateIndicator();
     }
 
-    same_height = true;
-
-    while ( *lineNumber < lines.size()) {
-        textLayout.setText(lines.at(*lineNumber));
-
-        textLayout.beginLayout();
-        while (1) {
-            QTextLine line = textLayout.createLine();
-            if (!line.isValid())
-                break;
-            line.setLineWidth(INT_MAX/256);
-            height += leading;
-            line.setPosition(QPoint(x, height));
-            height += static_cast<int>(line.height());
-        }
-        textLayout.endLayout();
-        if (height > pos.y()) {
-            *position = textLayout.lineAt(0).xToCursor(pos.x());
-            break;
-        }
-        ++*lineNumber;
+    if (dropped) {
+        // The remaining lines moved up, keep the selection and the view on them.
+        m_selectionStart.line -= dropped;
+        m_selectionEnd.line -= dropped;
+        if (m_selectionStart.line < 0)
+            m_selectionStart = Position();
+        if (m_selectionEnd.line < 0)
+            m_selectionEnd = Position();
+
+        m_blockScroll = true;
+        updateScrollBars();
+        scrollBar->setValue(atBottom ? scrollBar->maximum() : scrollBar->value() - dropped);
+        m_blockScroll = false;
+        viewport()->update();
+    } else {
+        updateScrollBars();
+        if (atBottom)
+            scrollBar->setValue(scrollBar->maximum());
+        updateLines(firstNewLine, m_buffer.lineCount() - 1);
     }
-    return true;
 }
 
-void OutputWindow::setNumberOfLines(int max)
+void OutputWindow::insertLine()
 {
-    max_lines = qMax(1, max);
-    while (lines.size() > max_lines)
-        lines.removeLast();
-    changed();
+    appendOutput(QString());
 }
 
-int OutputWindow::numberOfLines() const
+void OutputWindow::updateIndicator()
 {
-    return max_lines;
+    QStringList counts;
+    if (m_scrolledPastLines)
+        counts.append(tr("%n lines scrolled past", 0, m_scrolledPastLines));
+    if (m_droppedLines)
+        counts.append(tr("%n lines dropped", 0, m_droppedLines));
+    m_indicator->setText(counts.join(QLatin1String(", ")));
+    m_indicator->adjustSize();
+
+    // top right corner of the viewport, the indicator does not scroll with the lines.
+    const QRect viewportGeometry = viewport()->geometry();
+    m_indicator->move(viewportGeometry.right() - m_indicator->width() - 2, viewportGeometry.top() + 2);
+    m_indicator->setVisible(!counts.isEmpty());
 }
 
 bool OutputWindow::hasSelectedText() const
 {
-    return selection_start != selection_end;
+    return m_selectionStart != m_selectionEnd;
 }
 
 void OutputWindow::clearSelection()
 {
-    bool hadSelectedText = hasSelectedText();
-    selection_start = selection_end = Selection();
+    const bool hadSelectedText = hasSelectedText();
+    m_selectionStart = m_selectionEnd = Position();
     if (hadSelectedText)
         viewport()->update();
 }
 
+OutputWindow::Position OutputWindow::selectionStart() const
+{
+    return qMin(m_selectionStart, m_selectionEnd);
+}
+
+OutputWindow::Position OutputWindow::selectionEnd() const
+{
+    return qMax(m_selectionStart, m_selectionEnd);
+}
+
+void OutputWindow::setSelection(const Position &start, const Position &end)
+{
+    m_selectionStart = start;
+    m_selectionEnd = end;
+    viewport()->update();
+}
+
 QString OutputWindow::selectedText() const
 {
-    Selection sel_start = qMin(selection_start, selection_end);
-    Selection sel_end = qMax(selection_start, selection_end);
-    QString text;
+    const Position start = selectionStart();
+    const Position end = selectionEnd();
 
-    if (sel_start.line == sel_end.line) {
-        text += lines.at(sel_start.line).mid(sel_start.pos, sel_end.pos - sel_start.pos);
-    } else {
-        int line = sel_start.line;
-        text += lines.at(line++).mid(sel_start.pos);
+    if (start.line == end.line)
+        return m_buffer.line(start.line).mid(start.column, end.column - start.column);
+
+    QString text = m_buffer.line(start.line).mid(start.column);
+    for (int line = start.line + 1; line < end.line; ++line) {
         text += QLatin1Char('\n');
-        while (line < sel_end.line) {
-            text += lines.at(line++);
-            text += QLatin1Char('\n');
-        }
-        text += lines.at(sel_end.line).left(sel_end.pos);
+        text += m_buffer.line(line);
     }
+    text += QLatin1Char('\n');
+    text += m_buffer.line(end.line).left(end.column);
     return text;
 }
 
-void OutputWindow::appendOutput(const QString &text)
+void OutputWindow::ensureVisible(const Position &position)
 {
-    lines.append(text);
-    if (same_height)
-        viewport()->update(
-            QRect(0, (lines.size() - verticalScrollBar()->value() - 1) * fontMetrics().lineSpacing(),
-                  viewport()->width(), viewport()->height()));
-    else
-        viewport()->update();
+    QScrollBar *scrollBar = verticalScrollBar();
+    const int visibleLines = visibleLineCount();
+    if (position.line < scrollBar->value())
+        scrollBar->setValue(position.line);
+    else if (position.line >= scrollBar->value() + visibleLines)
+        scrollBar->setValue(position.line - visibleLines + 1);
+
+    QTextLayout textLayout(m_buffer.line(position.line), font());
+    const QTextLine line = layoutLine(&textLayout);
+    if (!line.isValid())
+        return;
+    const int widthUsed = qMax(m_widthUsed, 8 + static_cast<int>(line.naturalTextWidth()));
+    if (widthUsed != m_widthUsed) {
+        m_widthUsed = widthUsed;
+        updateScrollBars();
+    }
 
-    changed();
-    int top = lines.size() - (viewport()->height() / fontMetrics().lineSpacing());
-    if (verticalScrollBar()->value() == top - 1)
-        verticalScrollBar()->setValue(top);
+    scrollBar = horizontalScrollBar();
+    const int x = 4 + static_cast<int>(line.cursorToX(position.column));
+    if (x < scrollBar->value())
+        scrollBar->setValue(x - 4);
+    else if (x > scrollBar->value() + viewport()->width() - 4)
+        scrollBar->setValue(x - viewport()->width() + 4);
+}
+
+OutputWindow::Position OutputWindow::positionAt(const QPoint &point) const
+{
+    if (!m_buffer.lineCount())
+        return Position();
+
+    const int y = point.y();
+    int lineNumber = verticalScrollBar()->value() + (y < 0 ? -1 : y / lineSpacing());
+    if (lineNumber < 0)
+        return Position();
+
+    if (lineNumber >= m_buffer.lineCount()) {
+        lineNumber = m_buffer.lineCount() - 1;
+        return Position(lineNumber, m_buffer.line(lineNumber).length());
+    }
+
+    QTextLayout textLayout(m_buffer.line(lineNumber), font());
+    QTextLine line = layoutLine(&textLayout);
+    if (!line.isValid())
+        return Position(lineNumber, 0);
+    line.setPosition(QPointF(4 - horizontalScrollBar()->value(), 0));
+    return Position(lineNumber, line.xToCursor(point.x()));
 }
 
 void OutputWindow::clear()
 {
-    clearSelection();
-    lines.clear();
+    m_frameTimer.stop();
+    m_pendingOutput.clear();
+    m_buffer.clear();
+    m_scrolledPastLines = 0;
+    m_droppedLines = 0;
+    updateIndicator();
+    m_selectionStart = m_selectionEnd = Position();
+    m_widthUsed = 0;
+    updateScrollBars();
     viewport()->update();
 }
 
@@ -476,27 +588,24 @@ void OutputWindow::copy()
 
 void OutputWindow::selectAll()
 {
-    selection_start = Selection();
-    selection_end.line = lines.size() - 1;
-    selection_end.pos = lines.last().length() - 1;
-    viewport()->update();
+    if (!m_buffer.lineCount())
+        return;
+    const int lastLine = m_buffer.lineCount() - 1;
+    setSelection(Position(), Position(lastLine, m_buffer.line(lastLine).length()));
 }
 
 void OutputWindow::scrollContentsBy(int dx, int dy)
 {
-    if (block_scroll)
+    if (m_blockScroll)
         return;
-    if (dx && dy) {
-        viewport()->update();
-    } else if (dx && !dy) {
-        viewport()->scroll(dx, 0);
-    } else {
-        if (same_height) {
-            viewport()->scroll(0, fontMetrics().lineSpacing() * dy);
-        } else {
-            viewport()->update();
-        }
-    }
+    viewport()->scroll(dx, dy * lineSpacing());
+}
+
+void OutputWindow::resizeEvent(QResizeEvent *e)
+{
+    QAbstractScrollArea::resizeEvent(e);
+    updateScrollBars();
+    updateIndicator();
 }
 
 void OutputWindow::keyPressEvent(QKeyEvent *e)
@@ -521,108 +630,71 @@ void OutputWindow::keyPressEvent(QKeyEvent *e)
 
 void OutputWindow::paintEvent(QPaintEvent *e)
 {
-    int lineNumber = verticalScrollBar()->value();
-
-    int x = 4 - horizontalScrollBar()->value();
     QPainter p(viewport());
 
-    int spacing = fontMetrics().lineSpacing();
-    int leading = fontMetrics().leading();
-    int height = 0;
+    const int spacing = lineSpacing();
+    const int top = verticalScrollBar()->value();
+    const int x = 4 - horizontalScrollBar()->value();
 
-    QTextLayout textLayout;
-    textLayout.setFont(font());
+    // Only the lines intersecting the exposed rectangle are decoded and laid out.
+    const int firstLine = top + qMax(0, e->rect().top() / spacing);
+    const int lastLine = qMin(m_buffer.lineCount() - 1, top + e->rect().bottom() / spacing);
 
     QTextCharFormat selectionFormat;
     selectionFormat.setBackground(palette().highlight());
     selectionFormat.setForeground(palette().highlightedText());
 
-    if (e->rect().top() <= 0 && e->rect().bottom() >= viewport()->rect().bottom())
-        width_used = 0; // recalculate
-
-    if (same_height) {
-        int skipLines = e->rect().top() / spacing;
-        height += skipLines * spacing;
-        lineNumber += skipLines;
-    }
-
-    same_height = true;
-
-    Selection sel_start = qMin(selection_start, selection_end);
-    Selection sel_end = qMax(selection_start, selection_end);
-
-    while ( lineNumber < lines.size() && height <= e->rect().bottom()) {
-
-        QString line = lines.at(lineNumber);
-
-        if (line.size() == 1 && line.at(0) == QChar::ParagraphSeparator) {
-            int y = height + spacing/2;
-            p.drawLine(e->rect().left(), y, e->rect().right(), y);
-            height += spacing;
-
+    const Position start = selectionStart();
+    const Position end = selectionEnd();
+    const int widthUsed = m_widthUsed;
+
+    for (int lineNumber = firstLine; lineNumber <= lastLine; ++lineNumber) {
+        const QString text = m_buffer.line(lineNumber);
+        QTextLayout textLayout(text, font());
+        QTextLine line = layoutLine(&textLayout);
+        if (!line.isValid())
+            continue;
+        line.setPosition(QPointF(x, (lineNumber - top) * spacing));
+        m_widthUsed = qMax(m_widthUsed, 8 + static_cast<int>(line.naturalTextWidth()));
+
+        if (start != end && lineNumber >= start.line && lineNumber <= end.line) {
+            QVector<QTextLayout::FormatRange> selection(1);
+            selection[0].start = (lineNumber == start.line) ? start.column : 0;
+            selection[0].length = ((lineNumber == end.line) ? end.column : text.length()) - selection[0].start;
+            selection[0].format = selectionFormat;
+            textLayout.draw(&p, QPoint(0, 0), selection);
         } else {
-            textLayout.setText(line);
-            textLayout.beginLayout();
-            while (1) {
-                QTextLine line = textLayout.createLine();
-                if (!line.isValid())
-                    break;
-                line.setLineWidth(INT_MAX/256);
-                height += leading;
-                line.setPosition(QPoint(x, height));
-                height += static_cast<int>(line.height());
-
-                same_height = same_height && (line.height() + leading) == spacing;
-                width_used = qMax(width_used, 8 + static_cast<int>(line.naturalTextWidth()));
-            }
-            textLayout.endLayout();
-
-            if (lineNumber >= sel_start.line && lineNumber <= sel_end.line) {
-                QVector<QTextLayout::FormatRange> selection(1);
-                selection[0].start = (lineNumber == sel_start.line)? sel_start.pos : 0;
-                selection[0].length = ((lineNumber == sel_end.line) ? sel_end.pos : lines.at(lineNumber).size()) - selection[0].start;
-                selection[0].format = selectionFormat;
-
-                textLayout.draw(&p, QPoint(0, 0), selection);
-            } else {
-                textLayout.draw(&p, QPoint(0, 0));
-            }
+            textLayout.draw(&p, QPoint(0, 0));
         }
-
-
-        ++lineNumber;
     }
 
-    horizontalScrollBar()->setRange(0, qMax(0, width_used - viewport()->width()));
-    if (horizontalScrollBar()->pageStep() != viewport()->width())
-        horizontalScrollBar()->setPageStep(viewport()->width());
-    if (height > viewport()->height())
-        verticalScrollBar()->setPageStep(lineNumber - verticalScrollBar()->value());
-    else if (verticalScrollBar()->pageStep() != viewport()->height() / fontMetrics().lineSpacing())
-        verticalScrollBar()->setPageStep(viewport()->height() / fontMetrics().lineSpacing());
+    if (m_widthUsed != widthUsed)
+        updateScrollBars();
 }
 
 void OutputWindow::mousePressEvent(QMouseEvent *e)
 {
     if (e->button() == Qt::LeftButton) {
         clearSelection();
-        if (getCursorPos(&selection_start.line, &selection_start.pos, e->pos())) {
-            selection_end = selection_start;
-            autoscroll = 0;
-        }
+        m_selectionStart = m_selectionEnd = positionAt(e->pos());
+        m_lastMouseMove = e->pos();
     }
 }
 
 void OutputWindow::timerEvent(QTimerEvent *e)
 {
-    if (e->timerId() == autoscroll_timer.timerId()) {
-        int autoscroll = 0;
-        if (lastMouseMove.y() < 0)
-            autoscroll = -1;
-        else if (lastMouseMove.y() > viewport()->height())
-            autoscroll = 1;
-        if (autoscroll) {
-            verticalScrollBar()->setValue(verticalScrollBar()->value() + autoscroll);
+    if (e->timerId() == m_frameTimer.timerId()) {
+        flushOutput();
+        return;
+    }
+    if (e->timerId() == m_autoScrollTimer.timerId()) {
+        int autoScroll = 0;
+        if (m_lastMouseMove.y() < 0)
+            autoScroll = -1;
+        else if (m_lastMouseMove.y() > viewport()->height())
+            autoScroll = 1;
+        if (autoScroll) {
+            verticalScrollBar()->setValue(verticalScrollBar()->value() + autoScroll);
             OutputWindow::mouseMoveEvent(0);
         }
     }
@@ -632,8 +704,8 @@ void OutputWindow::timerEvent(QTimerEvent *e)
 void OutputWindow::mouseReleaseEvent(QMouseEvent *e)
 {
     if (e->button() == Qt::LeftButton) {
-        autoscroll_timer.stop();
-        if (hasSelectedText() &&  QApplication::clipboard()->supportsSelection())
+        m_autoScrollTimer.stop();
+        if (hasSelectedText() && QApplication::clipboard()->supportsSelection())
             QApplication::clipboard()->setText(selectedText(), QClipboard::Selection);
     }
 }
@@ -641,34 +713,28 @@ void OutputWindow::mouseReleaseEvent(QMouseEvent *e)
 void OutputWindow::mouseMoveEvent(QMouseEvent *e)
 {
     if (e) {
-        lastMouseMove = e->pos();
+        if (!(e->buttons() & Qt::LeftButton))
+            return;
+        m_lastMouseMove = e->pos();
         if (viewport()->rect().contains(e->pos()))
-            autoscroll_timer.stop();
+            m_autoScrollTimer.stop();
         else
-            autoscroll_timer.start(20, this);
+            m_autoScrollTimer.start(20, this);
     }
 
-
-    Selection old = selection_end;
-    if (!getCursorPos(&selection_end.line, &selection_end.pos, lastMouseMove))
-        return;
-    if (same_height) {
-        Selection from = qMin(old, selection_end);
-        Selection to = qMax(old, selection_end);
-        viewport()->update(QRect(0, -1 + (from.line - verticalScrollBar()->value()) * fontMetrics().lineSpacing(),
-                                 viewport()->width(), 2 + (to.line - from.line + 1) * fontMetrics().lineSpacing()));
-    } else {
-        viewport()->update();
-    }
+    const Position old = m_selectionEnd;
+    m_selectionEnd = positionAt(m_lastMouseMove);
+    if (m_selectionEnd != old)
+        updateLines(qMin(old.line, m_selectionEnd.line), qMax(old.line, m_selectionEnd.line));
 }
 
-void OutputWindow::contextMenuEvent(QContextMenuEvent * e)
+void OutputWindow::contextMenuEvent(QContextMenuEvent *e)
 {
     QMenu menu(this);
-    QAction *clearAction = menu.addAction("Clear", this, SLOT(clear()));
-    QAction *copyAction = menu.addAction("Copy", this, SLOT(copy()), QKeySequence::Copy);
-    QAction *selectAllAction = menu.addAction("Select All", this, SLOT(selectAll()), QKeySequence::SelectAll);
-    if (lines.empty()) {
+    QAction *clearAction = menu.addAction(tr("Clear"), this, SLOT(clear()));
+    QAction *copyAction = menu.addAction(tr("Copy"), this, SLOT(copy()), QKeySequence::Copy);
+    QAction *selectAllAction = menu.addAction(tr("Select All"), this, SLOT(selectAll()), QKeySequence::SelectAll);
+    if (!m_buffer.lineCount()) {
         clearAction->setDisabled(true);
         selectAllAction->setDisabled(true);
     }
@@ -678,4 +744,111 @@ void OutputWindow::contextMenuEvent(QContextMenuEvent * e)
     menu.exec(e->globalPos());
 }
 
-#endif // 0
+/*******************/
+
+OutputWindowFind::OutputWindowFind(OutputWindow *outputWindow)
+    : m_outputWindow(outputWindow),
+      m_incrementalStartValid(false)
+{
+}
+
+bool OutputWindowFind::supportsReplace() const
+{
+    return false;
+}
+
+void OutputWindowFind::resetIncrementalSearch()
+{
+    m_incrementalStartValid = false;
+}
+
+void OutputWindowFind::clearResults()
+{
+}
+
+QString OutputWindowFind::currentFindString() const
+{
+    QTC_ASSERT(m_outputWindow, return QString());
+    if (m_outputWindow->selectionStart().line != m_outputWindow->selectionEnd().line)
+        return QString(); // multi line selection
+    return m_outputWindow->selectedText();
+}
+
+QString OutputWindowFind::completedFindString() const
+{
+    QTC_ASSERT(m_outputWindow, return QString());
+    const OutputWindow::Position start = m_outputWindow->selectionStart();
+    const QString line = m_outputWindow->buffer().line(start.line);
+    int end = start.column;
+    while (end < line.length() && (line.at(end).isLetterOrNumber() || line.at(end) == QLatin1Char('_')))
+        ++end;
+    return line.mid(start.column, end - start.column);
+}
+
+bool OutputWindowFind::findIncremental(const QString &txt, QTextDocument::FindFlags findFlags)
+{
+    QTC_ASSERT(m_outputWindow, return false);
+    if (!m_incrementalStartValid) {
+        m_incrementalStart = m_outputWindow->selectionStart();
+        m_incrementalStartValid = true;
+    }
+    findFlags &= ~QTextDocument::FindBackward;
+    return find(txt, findFlags, m_incrementalStart);
+}
+
+bool OutputWindowFind::findStep(const QString &txt, QTextDocument::FindFlags findFlags)
+{
+    QTC_ASSERT(m_outputWindow, return false);
+    const OutputWindow::Position start = (findFlags & QTextDocument::FindBackward)
+            ? m_outputWindow->selectionStart() : m_outputWindow->selectionEnd();
+    const bool found = find(txt, findFlags, start);
+    if (found) {
+        m_incrementalStart = m_outputWindow->selectionStart();
+        m_incrementalStartValid = true;
+    }
+    return found;
+}
+
+bool OutputWindowFind::replaceStep(const QString &, const QString &,
+    QTextDocument::FindFlags)
+{
+    return false;
+}
+
+int OutputWindowFind::replaceAll(const QString &, const QString &,
+    QTextDocument::FindFlags)
+{
+    return 0;
+}
+
+bool OutputWindowFind::find(const QString &txt, QTextDocument::FindFlags findFlags,
+                            OutputWindow::Position start)
+{
+    if (txt.isEmpty()) {
+        m_outputWindow->setSelection(start, start);
+        return true;
+    }
+
+    const OutputBuffer &buffer = m_outputWindow->buffer();
+    int line = start.line;
+    int column = start.column;
+    if (!buffer.find(txt, findFlags, &line, &column)) {
+        // wrap around
+        if ((findFlags & QTextDocument::FindBackward) == 0) {
+            line = 0;
+            column = 0;
+        } else {
+            line = buffer.lineCount() - 1;
+            column = buffer.line(line).length();
+        }
+        if (!buffer.find(txt, findFlags, &line, &column))
+            return false;
+    }
+
+    const OutputWindow::Position matchStart(line, column);
+    const OutputWindow::Position matchEnd(line, column + txt.length());
+    m_outputWindow->setSelection(matchStart, matchEnd);
+    m_outputWindow->ensureVisible(matchEnd);
+    m_outputWindow->ensureVisible(matchStart);
+    return true;
+}
@@ -34,17 +34,21 @@
 #ifndef OUTPUTWINDOW_H
 #define OUTPUTWINDOW_H
 
+#include "outputbuffer.h"
+
 #include <coreplugin/ioutputpane.h>
-#include <texteditor/plaintexteditor.h>
+#include <find/ifindsupport.h>
 
 #include <QtCore/QObject>
 #include <QtCore/QHash>
 #include <QtCore/QBasicTimer>
+#include <QtCore/QPointer>
+#include <QtCore/QStringList>
 #include <QtGui/QAbstractScrollArea>
 #include <QtGui/QToolButton>
-#include <QtGui/QPlainTextEdit>
 
 QT_BEGIN_NAMESPACE
+class QLabel;
 class QTabWidget;
 QT_END_NAMESPACE
 
@@ -97,6 +101,7 @@ private:
     RunControl *runControlForTab(int index) const;
 
     QWidget *m_mainWidget;
+    int m_maximumOutputSize;
     QTabWidget *m_tabWidget;
     QHash<RunControl *, OutputWindow *> m_outputWindows;
 //    QToolButton *m_insertLineButton;
@@ -106,93 +111,120 @@ private:
 
 
 
-class OutputWindow : public QPlainTextEdit
-{
-    Q_OBJECT
-public:
-    OutputWindow(QWidget *parent = 0);
-    ~OutputWindow();
-
-    void appendOutput(const QString &out);
-    void insertLine();
-};
+/*
+    Shows the output of a run control. The lines are kept in an OutputBuffer
+    and only the visible ones are decoded and laid out when painting, so the
+    window stays responsive however much the application prints.
 
-#if 0
-class OutputWindow
-  : public QAbstractScrollArea
+    Appended output is collected and added to the buffer once per frame.
+    An indicator shows how many lines went by too fast to be shown while
+    following the output, and how many were dropped from the buffer.
+*/
+class OutputWindow : public QAbstractScrollArea
 {
     Q_OBJECT
 
-    int max_lines;
-    bool same_height;
-    int width_used;
-    bool block_scroll;
-    QStringList lines;
-    QBasicTimer autoscroll_timer;
-    int autoscroll;
-    QPoint lastMouseMove;
-
-
-    struct Selection {
-        Selection():line(0), pos(0){}
+public:
+    struct Position {
+        Position() : line(0), column(0) {}
+        Position(int l, int c) : line(l), column(c) {}
         int line;
-        int pos;
+        int column;
 
-        bool operator==(const Selection &other) const
-            { return line == other.line && pos == other.pos; }
-        bool operator!=(const Selection &other) const
+        bool operator==(const Position &other) const
+            { return line == other.line && column == other.column; }
+        bool operator!=(const Position &other) const
             { return !(*this == other); }
-        bool operator<(const Selection &other) const
-            { return line < other.line || (line == other.line && pos < other.pos); }
-        bool operator>=(const Selection &other) const
-        { return !(*this < other); }
-        bool operator<=(const Selection &other) const
-            { return line < other.line || (line == other.line && pos == other.pos); }
-        bool operator>(const Selection &other) const
-        { return !(*this <= other); }
+        bool operator<(const Position &other) const
+            { return line < other.line || (line == other.line && column < other.column); }
     };
 
-    Selection selection_start, selection_end;
-    void changed();
-    bool getCursorPos(int *lineNumber, int *position, const QPoint &pos);
-
-public:
     OutputWindow(QWidget *parent = 0);
     ~OutputWindow();
 
-    void setNumberOfLines(int max);
-    int numberOfLines() const;
+    void setMaximumBufferSize(int bytes);
+    int maximumBufferSize() const;
+    const OutputBuffer &buffer() const;
+
+    void appendOutput(const QString &out);
+    void insertLine();
 
     bool hasSelectedText() const;
     void clearSelection();
-
     QString selectedText() const;
-
-    void appendOutput(const QString &out);
-    void insertLine() {
-        appendOutput(QChar(QChar::ParagraphSeparator));
-    }
-
+    Position selectionStart() const;
+    Position selectionEnd() const;
+    void setSelection(const Position &start, const Position &end);
+    void ensureVisible(const Position &position);
 
 public slots:
     void clear();
     void copy();
     void selectAll();
 
-signals:
-    void showPage();
-
 protected:
     void scrollContentsBy(int dx, int dy);
+    void resizeEvent(QResizeEvent *e);
     void keyPressEvent(QKeyEvent *e);
     void paintEvent(QPaintEvent *e);
     void mousePressEvent(QMouseEvent *e);
     void mouseReleaseEvent(QMouseEvent *e);
     void mouseMoveEvent(QMouseEvent *e);
     void timerEvent(QTimerEvent *e);
-    void contextMenuEvent(QContextMenuEvent * e);
+    void contextMenuEvent(QContextMenuEvent *e);
+
+private:
+    void flushOutput();
+    void updateIndicator();
+    void updateScrollBars();
+    void updateLines(int first, int last);
+    int lineSpacing() const;
+    int visibleLineCount() const;
+    Position positionAt(const QPoint &point) const;
+
+    OutputBuffer m_buffer;
+    QStringList m_pendingOutput;
+    QBasicTimer m_frameTimer;
+    int m_scrolledPastLines;
+    int m_droppedLines;
+    QLabel *m_indicator;
+    int m_widthUsed;
+    bool m_blockScroll;
+    Position m_selectionStart; // the anchor, not necessarily before m_selectionEnd
+    Position m_selectionEnd;
+    QBasicTimer m_autoScrollTimer;
+    QPoint m_lastMouseMove;
+};
+
+class OutputWindowFind : public Find::IFindSupport
+{
+    Q_OBJECT
+
+public:
+    OutputWindowFind(OutputWindow *outputWindow);
+
+    bool supportsReplace() const;
+    void resetIncrementalSearch();
+    void clearResults();
+    QString currentFindString() const;
+    QString completedFindString() const;
+
+    bool findIncremental(const QString &txt, QTextDocument::FindFlags findFlags);
+    bool findStep(const QString &txt, QTextDocument::FindFlags findFlags);
+    bool replaceStep(const QString &before, const QString &after,
+        QTextDocument::FindFlags findFlags);
+    int replaceAll(const QString &before, const QString &after,
+        QTextDocument::FindFlags findFlags);
+
+private:
+    bool find(const QString &txt, QTextDocument::FindFlags findFlags,
+              OutputWindow::Position start);
+
+    QPointer<OutputWindow> m_outputWindow;
+    OutputWindow::Position m_incrementalStart;
+    bool m_incrementalStartValid;
 };
-#endif // 0
+
 } // namespace Internal
 } // namespace ProjectExplorer
 
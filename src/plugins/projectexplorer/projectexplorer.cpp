@@ -51,6 +51,7 @@
 #include "projectexplorer.h"
 #include "projectexplorerconstants.h"
 #include "projectfilewizardextension.h"
+#include "projecttextindexer.h"
 #include "projecttreewidget.h"
 #include "projectwindow.h"
 #include "removefiledialog.h"
@@ -135,6 +136,7 @@ ProjectExplorerPlugin::ProjectExplorerPlugin()
       m_runConfigurationActionGroup(0),
       m_currentProject(0),
       m_currentNode(0),
+      m_textIndexer(0),
       m_delayedRunConfiguration(0),
       m_debuggingRunControl(0)
 {
@@ -594,8 +596,11 @@ bool ProjectExplorerPlugin::initialize(const QStringList & /*arguments*/, QStrin
     addAutoReleasedObject(new ProjectTreeWidgetFactory(m_core));
     addAutoReleasedObject(new FolderNavigationWidgetFactory(m_core));
 
-    if (QSettings *s = m_core->settings())
+    if (QSettings *s = m_core->settings()) {
         m_recentProjects = s->value("ProjectExplorer/RecentProjects/Files", QStringList()).toStringList();
+        if (s->value("ProjectExplorer/Settings/UseTextIndex", true).toBool())
+            m_textIndexer = new ProjectTextIndexer(this, m_core);
+    }
     for (QStringList::iterator it = m_recentProjects.begin(); it != m_recentProjects.end(); ) {
         if (QFileInfo(*it).isFile()) {
             ++it;
@@ -741,6 +746,8 @@ void ProjectExplorerPlugin::extensionsInitialized()
 
 void ProjectExplorerPlugin::shutdown()
 {
+    if (m_textIndexer)
+        m_textIndexer->shutdown();
     m_session->clear();
 //    m_proWindow->saveConfigChanges();
 }
@@ -909,6 +916,11 @@ void ProjectExplorerPlugin::setCurrentNode(Node *node)
     setCurrent(m_session->projectForNode(node), QString(), node);
 }
 
+const Core::Utils::TrigramIndex *ProjectExplorerPlugin::textIndex() const
+{
+    return m_textIndexer ? m_textIndexer->index() : 0;
+}
+
 SessionManager *ProjectExplorerPlugin::session() const
 {
     return m_session;
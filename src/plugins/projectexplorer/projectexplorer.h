@@ -60,6 +60,9 @@ class IFileFactory;
 namespace Internal {
     class WelcomeMode;
 }
+namespace Utils {
+    class TrigramIndex;
+}
 }
 
 namespace ProjectExplorer {
@@ -76,6 +79,7 @@ class ApplicationOutput;
 class OutputPane;
 class ProjectWindow;
 class ProjectFileFactory;
+class ProjectTextIndexer;
 
 } // namespace Internal
 
@@ -110,6 +114,9 @@ public:
 
     void showContextMenu(const QPoint &globalPos, Node *node);
 
+    // Trigram index over the files of all projects, 0 if disabled.
+    const Core::Utils::TrigramIndex *textIndex() const;
+
     //PluginInterface
     bool initialize(const QStringList &arguments, QString *error_message);
     void extensionsInitialized();
@@ -249,6 +256,7 @@ private:
     QList<Internal::ProjectFileFactory*> m_fileFactories;
     QStringList m_profileMimeTypes;
     Internal::OutputPane *m_outputPane;
+    Internal::ProjectTextIndexer *m_textIndexer;
 
     QStringList m_recentProjects;
     static const int m_maxRecentProjects = 7;
@@ -12,6 +12,7 @@ HEADERS += projectexplorer.h \
     compileoutputwindow.h \
     taskwindow.h \
     outputwindow.h \
+    outputbuffer.h \
     persistentsettings.h \
     projectfilewizardextension.h \
     session.h \
@@ -25,6 +26,7 @@ HEADERS += projectexplorer.h \
     currentprojectfilter.h \
     scriptwrappers.h \
     allprojectsfind.h \
+    projecttextindexer.h \
     buildstep.h \
     buildconfiguration.h \
     environment.h \
@@ -59,6 +61,7 @@ SOURCES += projectexplorer.cpp \
     compileoutputwindow.cpp \
     taskwindow.cpp \
     outputwindow.cpp \
+    outputbuffer.cpp \
     persistentsettings.cpp \
     projectfilewizardextension.cpp \
     session.cpp \
@@ -67,6 +70,7 @@ SOURCES += projectexplorer.cpp \
     currentprojectfilter.cpp \
     scriptwrappers.cpp \
     allprojectsfind.cpp \
+    projecttextindexer.cpp \
     project.cpp \
     pluginfilefactory.cpp \
     buildstep.cpp \
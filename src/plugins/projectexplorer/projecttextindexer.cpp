@@ -0,0 +1,204 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "projecttextindexer.h"
+#include "projectexplorer.h"
+#include "project.h"
+#include "session.h"
+
+#include <coreplugin/icore.h>
+#include <coreplugin/ifile.h>
+#include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/editormanager/ieditor.h>
+#include <qtconcurrent/runextensions.h>
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QSettings>
+
+using namespace ProjectExplorer;
+using namespace ProjectExplorer::Internal;
+using Core::Utils::TrigramIndex;
+
+namespace {
+
+// Reports the files that were modified too recently to be indexed for good.
+void indexFiles(QFutureInterface<QString> &future, TrigramIndex *index, QStringList files)
+{
+    foreach (const QString &fileName, index->outdatedFiles(files)) {
+        if (future.isCanceled())
+            break;
+        if (! index->updateFile(fileName))
+            future.reportResult(fileName);
+    }
+}
+
+} // anonymous namespace
+
+ProjectTextIndexer::ProjectTextIndexer(ProjectExplorerPlugin *plugin, Core::ICore *core)
+    : QObject(plugin),
+      m_plugin(plugin),
+      m_core(core),
+      m_projectFilesChanged(false)
+{
+    m_index.load(cacheFileName());
+
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(1000);
+    connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(update()));
+    connect(&m_watcher, SIGNAL(finished()), this, SLOT(indexingFinished()));
+    connect(&m_directoryWatcher, SIGNAL(directoryChanged(QString)),
+            this, SLOT(directoryChanged(QString)));
+
+    connect(m_plugin, SIGNAL(fileListChanged()), this, SLOT(projectFilesChanged()));
+    connect(m_core->editorManager(), SIGNAL(editorOpened(Core::IEditor*)),
+            this, SLOT(editorOpened(Core::IEditor*)));
+}
+
+ProjectTextIndexer::~ProjectTextIndexer()
+{
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+}
+
+const TrigramIndex *ProjectTextIndexer::index() const
+{
+    return &m_index;
+}
+
+void ProjectTextIndexer::shutdown()
+{
+    m_updateTimer.stop();
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+
+    // files that were not indexed yet are simply outdated next time
+    m_index.save(cacheFileName());
+}
+
+void ProjectTextIndexer::projectFilesChanged()
+{
+    m_projectFilesChanged = true;
+    m_updateTimer.start();
+}
+
+void ProjectTextIndexer::editorOpened(Core::IEditor *editor)
+{
+    if (Core::IFile *file = editor->file())
+        connect(file, SIGNAL(changed()), this, SLOT(fileChanged()));
+}
+
+void ProjectTextIndexer::fileChanged()
+{
+    // changed() is also emitted when a file was saved
+    Core::IFile *file = qobject_cast<Core::IFile *>(sender());
+    if (! file || file->isModified())
+        return;
+
+    queueFile(file->fileName());
+}
+
+void ProjectTextIndexer::directoryChanged(const QString &directory)
+{
+    // Watching the directories keeps the number of watches low. The files
+    // that did not change are skipped by their modification time and size.
+    foreach (const QString &fileName, m_filesInDirectory.value(directory))
+        queueFile(fileName);
+}
+
+void ProjectTextIndexer::queueFile(const QString &fileName)
+{
+    if (! m_projectFiles.contains(fileName) || m_changedFiles.contains(fileName))
+        return;
+
+    m_changedFiles.insert(fileName);
+    m_updateTimer.start();
+}
+
+void ProjectTextIndexer::indexingFinished()
+{
+    if (m_watcher.isCanceled())
+        return;
+
+    foreach (const QString &fileName, m_watcher.future().results())
+        queueFile(fileName);
+}
+
+void ProjectTextIndexer::update()
+{
+    if (m_watcher.isRunning()) {
+        m_updateTimer.start();
+        return;
+    }
+
+    QStringList files;
+    if (m_projectFilesChanged) {
+        m_projectFilesChanged = false;
+        foreach (Project *project, m_plugin->session()->projects())
+            files += project->files(Project::AllFiles);
+        files.removeDuplicates();
+        updateWatchedDirectories(files.toSet());
+        m_index.retainFiles(files);
+    } else {
+        files = m_changedFiles.toList();
+    }
+    m_changedFiles.clear();
+
+    if (! files.isEmpty())
+        m_watcher.setFuture(QtConcurrent::run<QString, TrigramIndex *, QStringList>(indexFiles, &m_index, files));
+}
+
+void ProjectTextIndexer::updateWatchedDirectories(const QSet<QString> &projectFiles)
+{
+    QHash<QString, QStringList> filesInDirectory;
+    foreach (const QString &fileName, projectFiles)
+        filesInDirectory[QFileInfo(fileName).path()].append(fileName);
+
+    const QSet<QString> oldDirectories = m_filesInDirectory.keys().toSet();
+    const QSet<QString> newDirectories = filesInDirectory.keys().toSet();
+    const QStringList removed = (oldDirectories - newDirectories).toList();
+    const QStringList added = (newDirectories - oldDirectories).toList();
+
+    m_projectFiles = projectFiles;
+    m_filesInDirectory = filesInDirectory;
+
+    if (! removed.isEmpty())
+        m_directoryWatcher.removePaths(removed);
+    if (! added.isEmpty())
+        m_directoryWatcher.addPaths(added);
+}
+
+QString ProjectTextIndexer::cacheFileName() const
+{
+    const QString configDir = QFileInfo(m_core->settings()->fileName()).path();
+    return configDir + QLatin1String("/qtcreator/projectindex.cache");
+}
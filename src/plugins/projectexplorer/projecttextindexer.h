@@ -0,0 +1,103 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#ifndef PROJECTTEXTINDEXER_H
+#define PROJECTTEXTINDEXER_H
+
+#include <utils/trigramindex.h>
+
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+
+namespace Core {
+class ICore;
+class IEditor;
+}
+
+namespace ProjectExplorer {
+
+class ProjectExplorerPlugin;
+
+namespace Internal {
+
+// Keeps a trigram index over the files of all open projects up to date in
+// the background. Files are (re-)indexed when the project file lists
+// change, when an editor saves them and when their directory changes on
+// disk; the index is kept on disk between sessions.
+class ProjectTextIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    ProjectTextIndexer(ProjectExplorerPlugin *plugin, Core::ICore *core);
+    ~ProjectTextIndexer();
+
+    const Core::Utils::TrigramIndex *index() const;
+
+    // Stops indexing and writes the index to disk.
+    void shutdown();
+
+private slots:
+    void projectFilesChanged();
+    void editorOpened(Core::IEditor *editor);
+    void fileChanged();
+    void directoryChanged(const QString &directory);
+    void indexingFinished();
+    void update();
+
+private:
+    void queueFile(const QString &fileName);
+    void updateWatchedDirectories(const QSet<QString> &projectFiles);
+    QString cacheFileName() const;
+
+    ProjectExplorerPlugin *m_plugin;
+    Core::ICore *m_core;
+    Core::Utils::TrigramIndex m_index;
+    QFutureWatcher<QString> m_watcher;
+    QFileSystemWatcher m_directoryWatcher;
+    QTimer m_updateTimer;
+    QSet<QString> m_projectFiles;
+    QHash<QString, QStringList> m_filesInDirectory;
+    QSet<QString> m_changedFiles;
+    bool m_projectFilesChanged;
+};
+
+} // namespace Internal
+} // namespace ProjectExplorer
+
+#endif // PROJECTTEXTINDEXER_H
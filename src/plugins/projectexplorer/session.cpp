@@ -855,7 +855,7 @@ Project *SessionManager::projectForFile(const QString &fileName) const
 bool SessionManager::projectContainsFile(Project *p, const QString &fileName) const
 {
     if (!m_projectFileCache.contains(p))
-        m_projectFileCache.insert(p, p->files(Project::AllFiles));
+        m_projectFileCache.insert(p, p->files(Project::AllFiles).toSet());
 
     return m_projectFileCache.value(p).contains(fileName);
 }
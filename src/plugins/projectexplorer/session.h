@@ -43,6 +43,7 @@
 #include <QtCore/QAbstractItemModel>
 #include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 
@@ -201,7 +202,7 @@ private:
     QString m_sessionName;
 
     mutable
-    QHash<Project *, QStringList> m_projectFileCache;
+    QHash<Project *, QSet<QString> > m_projectFileCache;
 };
 
 } // namespace ProjectExplorer
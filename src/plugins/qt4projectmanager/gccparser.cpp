@@ -38,21 +38,174 @@
 
 using namespace Qt4ProjectManager;
 
-GccParser::GccParser()
+// The matchers below are hand written, they are run on every line of the
+// build output and QRegExp is much too slow for that.
+
+namespace {
+
+typedef ProjectExplorer::BuildParserInterface::PatternType PatternType;
+
+// Returns the position after the digits starting at \a pos, or \a pos if there are none.
+int skipDigits(const QString &line, int pos)
+{
+    while (pos < line.length() && line.at(pos).isDigit())
+        ++pos;
+    return pos;
+}
+
+// file:line:[column:] [warning: |error: ]description
+// The file name is at least two characters long, contains no parentheses
+// and does not end with a digit.
+bool matchMessage(const QString &line, QString *file, int *lineNumber,
+                  PatternType *type, QString *description)
+{
+    int paren = 0;
+    while (paren < line.length() && line.at(paren) != QLatin1Char('(') && line.at(paren) != QLatin1Char(')'))
+        ++paren;
+
+    for (int colon = line.indexOf(QLatin1Char(':')); colon != -1 && colon < paren;
+         colon = line.indexOf(QLatin1Char(':'), colon + 1)) {
+        if (colon < 2 || line.at(colon - 1).isDigit())
+            continue;
+
+        // line number, then any number of column numbers
+        int pos = colon + 1;
+        int digitsEnd = skipDigits(line, pos);
+        if (digitsEnd == pos || digitsEnd >= line.length() || line.at(digitsEnd) != QLatin1Char(':'))
+            continue;
+
+        const int lineEnd = digitsEnd;
+        pos = digitsEnd + 1;
+        for (;;) {
+            digitsEnd = skipDigits(line, pos);
+            if (digitsEnd == pos || digitsEnd >= line.length() || line.at(digitsEnd) != QLatin1Char(':'))
+                break;
+            pos = digitsEnd + 1;
+        }
+
+        // a blank and a description that is not empty
+        if (pos + 1 >= line.length() || !line.at(pos).isSpace())
+            continue;
+
+        *file = line.left(colon);
+        *lineNumber = line.mid(colon + 1, lineEnd - colon - 1).toInt();
+        *type = ProjectExplorer::BuildParserInterface::Unknown;
+        *description = line.mid(pos + 1);
+
+        const QString rest = *description;
+        int descriptionStart = -1;
+        if (rest.startsWith(QLatin1String("warning:"))) {
+            *type = ProjectExplorer::BuildParserInterface::Warning;
+            descriptionStart = 8;
+        } else if (rest.startsWith(QLatin1String("error:"))) {
+            *type = ProjectExplorer::BuildParserInterface::Error;
+            descriptionStart = 6;
+        }
+        if (descriptionStart != -1 && descriptionStart + 1 < rest.length()
+                && rest.at(descriptionStart).isSpace()) {
+            *description = rest.mid(descriptionStart + 1);
+        } else {
+            *type = ProjectExplorer::BuildParserInterface::Unknown;
+        }
+        return true;
+    }
+    return false;
+}
+
+// ...from file:line, or ...from file:line:
+// The file name may start with a drive letter.
+bool matchIncludedFrom(const QString &line, QString *file, int *lineNumber)
+{
+    const int length = line.length();
+    if (length < 2)
+        return false;
+
+    const QChar last = line.at(length - 1);
+    if (last != QLatin1Char(',') && last != QLatin1Char(':'))
+        return false;
+
+    int digitsBegin = length - 1;
+    while (digitsBegin > 0 && line.at(digitsBegin - 1).isDigit())
+        --digitsBegin;
+    if (digitsBegin == length - 1 || digitsBegin == 0 || line.at(digitsBegin - 1) != QLatin1Char(':'))
+        return false;
+
+    // the file name contains no colons, except after a drive letter
+    const int colon = digitsBegin - 1;
+    for (int from = line.indexOf(QLatin1String("from"));
+         from != -1 && from + 5 < colon;
+         from = line.indexOf(QLatin1String("from"), from + 1)) {
+        if (!line.at(from + 4).isSpace())
+            continue;
+
+        int fileBegin = from + 5;
+        if (fileBegin + 2 < colon && line.at(fileBegin).isLetter()
+                && line.at(fileBegin + 1) == QLatin1Char(':'))
+            fileBegin += 2;
+        if (line.indexOf(QLatin1Char(':'), fileBegin) != colon)
+            continue;
+
+        *file = line.mid(from + 5, colon - from - 5);
+        *lineNumber = line.mid(digitsBegin, length - 1 - digitsBegin).toInt();
+        return true;
+    }
+    return false;
+}
+
+// object(section): description
+bool matchLinker(const QString &line, QString *file, QString *description)
+{
+    int blank = 0;
+    while (blank < line.length() && !line.at(blank).isSpace())
+        ++blank;
+
+    // "):" ends the first word and a description follows
+    if (blank < 4 || blank + 1 >= line.length()
+            || line.at(blank - 1) != QLatin1Char(':') || line.at(blank - 2) != QLatin1Char(')'))
+        return false;
+
+    const int paren = line.indexOf(QLatin1Char('('));
+    if (paren < 1 || paren > blank - 4)
+        return false;
+
+    *file = line.left(paren);
+    *description = line.mid(blank + 1);
+    return true;
+}
+
+// make[4]: Entering directory `/home/kkoehne/dev/ide-explorer/src/plugins/qtscripteditor'
+bool matchMakeDirectory(const QString &line, QString *action, QString *directory)
 {
-    m_regExp.setPattern("^([^\\(\\)]+[^\\d]):(\\d+):(\\d+:)*(\\s(warning|error):)?\\s(.+)$");
-    m_regExp.setMinimal(true);
+    if (!line.startsWith(QLatin1String("make")))
+        return false;
+
+    static const QLatin1String directoryText(" directory ");
+    for (int colon = line.indexOf(QLatin1String(": "), 4); colon != -1;
+         colon = line.indexOf(QLatin1String(": "), colon + 1)) {
+        const int wordBegin = colon + 2;
+        int wordEnd = wordBegin;
+        while (wordEnd < line.length()
+               && (line.at(wordEnd).isLetterOrNumber() || line.at(wordEnd) == QLatin1Char('_')))
+            ++wordEnd;
+        if (wordEnd == wordBegin || line.mid(wordEnd, 11) != directoryText)
+            continue;
 
-    m_regExpIncluded.setPattern("^.*from\\s([^:]+):(\\d+)(,|:)$");
-    m_regExpIncluded.setMinimal(true);
+        // the directory is quoted
+        const int directoryBegin = wordEnd + 11 + 1;
+        if (directoryBegin + 2 > line.length())
+            continue;
 
-    m_regExpLinker.setPattern("^(\\S+)\\(\\S+\\):\\s(.+)$");
-    m_regExpLinker.setMinimal(true);
+        *action = line.mid(wordBegin, wordEnd - wordBegin);
+        *directory = line.mid(directoryBegin, line.length() - directoryBegin - 1);
+        return true;
+    }
+    return false;
+}
 
-    //make[4]: Entering directory `/home/kkoehne/dev/ide-explorer/src/plugins/qtscripteditor'
-    m_makeDir.setPattern("^make.*: (\\w+) directory .(.+).$");
-    m_makeDir.setMinimal(true);
+} // anonymous namespace
 
+GccParser::GccParser()
+{
     m_linkIndent = false;
 }
 
@@ -65,48 +218,40 @@ void GccParser::stdOutput(const QString & line)
 {
     QString lne = line.trimmed();
 
-    if (m_makeDir.indexIn(lne) > -1) {
-        if (m_makeDir.cap(1) == "Leaving")
-                emit leaveDirectory(m_makeDir.cap(2));
-            else
-                emit enterDirectory(m_makeDir.cap(2));
+    QString action;
+    QString directory;
+    if (matchMakeDirectory(lne, &action, &directory)) {
+        if (action == QLatin1String("Leaving"))
+            emit leaveDirectory(directory);
+        else
+            emit enterDirectory(directory);
     }
 }
 
 void GccParser::stdError(const QString & line)
 {
     QString lne = line.trimmed();
-    if (m_regExp.indexIn(lne) > -1) {
-        ProjectExplorer::BuildParserInterface::PatternType type;
-        if (m_regExp.cap(5) == "warning")
-            type = ProjectExplorer::BuildParserInterface::Warning;
-        else if (m_regExp.cap(5) == "error")
-            type = ProjectExplorer::BuildParserInterface::Error;
-        else
-            type = ProjectExplorer::BuildParserInterface::Unknown;
 
-        QString description =  m_regExp.cap(6);
+    QString file;
+    int lineNumber;
+    PatternType type;
+    QString description;
+
+    if (matchMessage(lne, &file, &lineNumber, &type, &description)) {
         if (m_linkIndent)
             description.prepend(QLatin1String("-> "));
 
-        //qDebug()<<m_regExp.cap(1)<<m_regExp.cap(2)<<m_regExp.cap(3)<<m_regExp.cap(4);
-
-        emit addToTaskWindow(
-            m_regExp.cap(1), //filename
-            type,
-            m_regExp.cap(2).toInt(), //line number
-            description);
+        emit addToTaskWindow(file, type, lineNumber, description);
 
-    } else if (m_regExpIncluded.indexIn(lne) > -1) {
+    } else if (matchIncludedFrom(lne, &file, &lineNumber)) {
         emit addToTaskWindow(
-            m_regExpIncluded.cap(1), //filename
+            file,
             ProjectExplorer::BuildParserInterface::Unknown,
-            m_regExpIncluded.cap(2).toInt(), //linenumber
+            lineNumber,
             lne //description
             );
-    } else if (m_regExpLinker.indexIn(lne) > -1) {
-        ProjectExplorer::BuildParserInterface::PatternType type = ProjectExplorer::BuildParserInterface::Error;
-        QString description = m_regExpLinker.cap(2);
+    } else if (matchLinker(lne, &file, &description)) {
+        type = ProjectExplorer::BuildParserInterface::Error;
         if (lne.endsWith(QLatin1Char(':'))) {
             m_linkIndent = true;
         } else if (m_linkIndent) {
@@ -114,7 +259,7 @@ void GccParser::stdError(const QString & line)
             type = ProjectExplorer::BuildParserInterface::Unknown;
         }
         emit addToTaskWindow(
-            m_regExpLinker.cap(1), //filename
+            file,
             type,
             -1, //linenumber
             description);
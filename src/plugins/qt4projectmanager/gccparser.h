@@ -36,8 +36,6 @@
 
 #include <projectexplorer/ProjectExplorerInterfaces>
 
-#include <QtCore/QRegExp>
-
 namespace Qt4ProjectManager {
 
 class GccParser : public ProjectExplorer::BuildParserInterface
@@ -50,10 +48,6 @@ public:
     virtual void stdOutput(const QString & line);
     virtual void stdError(const QString & line);
 private:
-    QRegExp m_regExp;
-    QRegExp m_regExpIncluded;
-    QRegExp m_regExpLinker;
-    QRegExp m_makeDir;
     bool m_linkIndent;
 };
 
@@ -32,8 +32,9 @@
 ***************************************************************************/
 
 #include "gccpreprocessor.h"
+#include "toolchainprobecache.h"
 
-#include <QProcess>
+#include <QBuffer>
 #include <QString>
 #include <QFile>
 #include <QtDebug>
@@ -56,73 +57,84 @@ void GCCPreprocessor::setGcc(const QString &gcc)
     m_systemHeaderPaths.clear();;
 }
 
+bool GCCPreprocessor::isProbed()
+{
+    QStringList macroArguments;
+    macroArguments << QLatin1String("-xc++")
+                   << QLatin1String("-E")
+                   << QLatin1String("-dM")
+                   << QLatin1String("-");
+
+    QStringList headerPathArguments;
+    headerPathArguments << QLatin1String("-xc++")
+                        << QLatin1String("-E")
+                        << QLatin1String("-v")
+                        << QLatin1String("-");
+
+    // both probes are started before waiting for either
+    ToolchainProbeCache *cache = ToolchainProbeCache::instance();
+    ToolchainProbeCache::Output macros;
+    ToolchainProbeCache::Output headerPaths;
+    const bool haveMacros = cache->output(m_gcc, macroArguments, &macros);
+    const bool haveHeaderPaths = cache->output(m_gcc, headerPathArguments, &headerPaths);
+    if (!haveMacros || !haveHeaderPaths)
+        return false;
+
+    m_predefinedMacros = macros.standardOutput;
+    m_systemHeaderPaths.clear();
+    // gcc prints the search list on stderr
+    parseSystemHeaderPaths(headerPaths.standardError + headerPaths.standardOutput);
+    return true;
+}
+
 QByteArray GCCPreprocessor::predefinedMacros()
 {
-    if (m_predefinedMacros.isEmpty()) {
-        QStringList arguments;
-        arguments << QLatin1String("-xc++")
-                  << QLatin1String("-E")
-                  << QLatin1String("-dM")
-                  << QLatin1String("-");
-
-        QProcess cpp;
-        cpp.start(m_gcc, arguments);
-        cpp.closeWriteChannel();
-        cpp.waitForFinished();
-        m_predefinedMacros = cpp.readAllStandardOutput();
-    }
     return m_predefinedMacros;
 }
 
 QList<HeaderPath> GCCPreprocessor::systemHeaderPaths()
 {
-    if (m_systemHeaderPaths.isEmpty()) {
-        QStringList arguments;
-        arguments << QLatin1String("-xc++")
-                  << QLatin1String("-E")
-                  << QLatin1String("-v")
-                  << QLatin1String("-");
-
-        QProcess cpp;
-        cpp.setReadChannelMode(QProcess::MergedChannels);
-        cpp.start(m_gcc, arguments);
-        cpp.closeWriteChannel();
-        cpp.waitForFinished();
-
-        QByteArray line;
+    return m_systemHeaderPaths;
+}
+
+void GCCPreprocessor::parseSystemHeaderPaths(const QByteArray &output)
+{
+    QBuffer cpp;
+    cpp.setData(output);
+    cpp.open(QIODevice::ReadOnly);
+
+    QByteArray line;
+    while (cpp.canReadLine()) {
+        line = cpp.readLine();
+        if (line.startsWith("#include"))
+            break;
+    }
+
+    if (! line.isEmpty() && line.startsWith("#include")) {
+        HeaderPath::Kind kind = HeaderPath::UserHeaderPath;
         while (cpp.canReadLine()) {
             line = cpp.readLine();
-            if (line.startsWith("#include"))
-                break;
-        }
+            if (line.startsWith("#include")) {
+                kind = HeaderPath::GlobalHeaderPath;
+            } else if (! line.isEmpty() && QChar(line.at(0)).isSpace()) {
+                HeaderPath::Kind thisHeaderKind = kind;
+
+                line = line.trimmed();
+                if (line.endsWith('\n'))
+                    line.chop(1);
 
-        if (! line.isEmpty() && line.startsWith("#include")) {
-            HeaderPath::Kind kind = HeaderPath::UserHeaderPath;
-            while (cpp.canReadLine()) {
-                line = cpp.readLine();
-                if (line.startsWith("#include")) {
-                    kind = HeaderPath::GlobalHeaderPath;
-                } else if (! line.isEmpty() && QChar(line.at(0)).isSpace()) {
-                    HeaderPath::Kind thisHeaderKind = kind;
-
-                    line = line.trimmed();
-                    if (line.endsWith('\n'))
-                        line.chop(1);
-
-                    int index = line.indexOf(" (framework directory)");
-                    if (index != -1) {
-                        line = line.left(index);
-                        thisHeaderKind = HeaderPath::FrameworkHeaderPath;
-                    }
-
-                    m_systemHeaderPaths.append(HeaderPath(QFile::decodeName(line), thisHeaderKind));
-                } else if (line.startsWith("End of search list.")) {
-                    break;
-                } else {
-                    qWarning() << "ignore line:" << line;
+                int index = line.indexOf(" (framework directory)");
+                if (index != -1) {
+                    line = line.left(index);
+                    thisHeaderKind = HeaderPath::FrameworkHeaderPath;
                 }
+
+                m_systemHeaderPaths.append(HeaderPath(QFile::decodeName(line), thisHeaderKind));
+            } else if (line.startsWith("End of search list.")) {
+                break;
+            } else {
+                qWarning() << "ignore line:" << line;
             }
         }
     }
-    return m_systemHeaderPaths;
 }
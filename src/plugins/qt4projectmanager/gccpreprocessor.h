@@ -48,10 +48,16 @@ public:
     ~GCCPreprocessor();
 
     void setGcc(const QString &gcc);
+
+    // Returns whether the compiler was probed. If not, the probes run in the
+    // background and ToolchainProbeCache::probeFinished() is emitted when done.
+    bool isProbed();
     QByteArray predefinedMacros();
     QList<HeaderPath> systemHeaderPaths();
 
 private:
+    void parseSystemHeaderPaths(const QByteArray &output);
+
     QString m_gcc;
     QByteArray m_predefinedMacros;
     QList<HeaderPath> m_systemHeaderPaths;
@@ -0,0 +1,142 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "profilecache.h"
+#include "directorywatcher.h"
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+
+using namespace Qt4ProjectManager::Internal;
+
+ProFileCache::ProFileCache(QObject *parent)
+    : QObject(parent),
+      m_fileWatcher(new FileWatcher(this))
+{
+    connect(m_fileWatcher, SIGNAL(fileChanged(QString)),
+            this, SLOT(invalidate(QString)));
+}
+
+ProFileCache::~ProFileCache()
+{
+    // all readers are gone by now
+    qDeleteAll(m_refCounts.keys());
+    foreach (const Entry &entry, m_entries) {
+        if (!m_refCounts.contains(entry.proFile))
+            delete entry.proFile;
+    }
+}
+
+ProFile *ProFileCache::proFile(const QString &fileName)
+{
+    QMutexLocker locker(&m_mutex);
+    QHash<QString, Entry>::const_iterator it = m_entries.constFind(fileName);
+    if (it == m_entries.constEnd())
+        return 0;
+
+    const QFileInfo fi(fileName);
+    if (fi.lastModified() != it.value().lastModified || fi.size() != it.value().size) {
+        remove(fileName);
+        return 0;
+    }
+
+    ProFile *pro = it.value().proFile;
+    ++m_refCounts[pro];
+    return pro;
+}
+
+void ProFileCache::insert(ProFile *proFile)
+{
+    const QString fileName = proFile->fileName();
+    const QFileInfo fi(fileName);
+    Entry entry;
+    entry.proFile = proFile;
+    entry.lastModified = fi.lastModified();
+    entry.size = fi.size();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        remove(fileName);
+        m_entries.insert(fileName, entry);
+        ++m_refCounts[proFile];
+    }
+
+    // the file watcher lives in the GUI thread
+    if (QThread::currentThread() == thread())
+        watchFile(fileName);
+    else
+        QMetaObject::invokeMethod(this, "watchFile", Qt::QueuedConnection, Q_ARG(QString, fileName));
+}
+
+void ProFileCache::release(ProFile *proFile)
+{
+    QMutexLocker locker(&m_mutex);
+    QHash<ProFile *, int>::iterator it = m_refCounts.find(proFile);
+    if (it == m_refCounts.end())
+        return;
+    if (--it.value() > 0)
+        return;
+    m_refCounts.erase(it);
+
+    // delete outdated files once the last reader is done with them
+    QHash<QString, Entry>::const_iterator entry = m_entries.constFind(proFile->fileName());
+    if (entry == m_entries.constEnd() || entry.value().proFile != proFile)
+        delete proFile;
+}
+
+void ProFileCache::invalidate(const QString &fileName)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        remove(fileName);
+    }
+    if (m_fileWatcher->files().contains(fileName))
+        m_fileWatcher->removeFile(fileName);
+}
+
+void ProFileCache::watchFile(const QString &fileName)
+{
+    m_fileWatcher->addFile(fileName);
+}
+
+void ProFileCache::remove(const QString &fileName)
+{
+    QHash<QString, Entry>::iterator it = m_entries.find(fileName);
+    if (it == m_entries.end())
+        return;
+    ProFile *pro = it.value().proFile;
+    m_entries.erase(it);
+    if (!m_refCounts.contains(pro))
+        delete pro;
+}
@@ -35,15 +35,63 @@
 #define PROFILECACHE_H
 
 #include "proitems.h"
-#include <QString>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QString>
 
 namespace Qt4ProjectManager {
 namespace Internal {
 
-class ProFileCache {
+class FileWatcher;
+
+/*
+  Parsed .pro, .pri and .prf files, shared by all ProFileReaders.
+
+  A file is parsed again if its modification time or size changed, or
+  if the FileWatcher reported a change. Readers take a reference on the
+  ProFiles they get and release it when they are done, so an outdated
+  ProFile lives as long as a reader still uses it.
+
+  The ProFiles are read-only; a reader that edits the parse tree must not
+  use the cache.
+*/
+class ProFileCache : public QObject
+{
+    Q_OBJECT
+
 public:
-    ProFile *proFile(const QString &arg)
-    { return new ProFile(arg); }
+    explicit ProFileCache(QObject *parent = 0);
+    ~ProFileCache();
+
+    // Returns the up to date ProFile of fileName with a reference taken, or 0.
+    ProFile *proFile(const QString &fileName);
+    // Adds a freshly parsed ProFile, with a reference taken for the caller.
+    void insert(ProFile *proFile);
+    void release(ProFile *proFile);
+
+public slots:
+    void invalidate(const QString &fileName);
+
+private slots:
+    void watchFile(const QString &fileName);
+
+private:
+    struct Entry
+    {
+        ProFile *proFile;
+        QDateTime lastModified;
+        qint64 size;
+    };
+
+    void remove(const QString &fileName);
+
+    QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    QHash<ProFile *, int> m_refCounts;
+    FileWatcher *m_fileWatcher;
 };
 
 } // namespace Internal
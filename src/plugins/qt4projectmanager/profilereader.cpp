@@ -32,6 +32,7 @@
 ***************************************************************************/
 
 #include "profilereader.h"
+#include "profilecache.h"
 
 #include <QtCore/QDir>
 #include <QtCore/QDebug>
@@ -40,13 +41,24 @@ using namespace Qt4ProjectManager;
 using namespace Qt4ProjectManager::Internal;
 
 ProFileReader::ProFileReader()
+    : m_cache(0)
 {
 }
 
 ProFileReader::~ProFileReader()
 {
-    foreach (ProFile *pf, m_proFiles)
-        delete pf;
+    foreach (ProFile *pf, m_proFiles) {
+        if (m_cache)
+            m_cache->release(pf);
+        else
+            delete pf;
+    }
+}
+
+void ProFileReader::setProFileCache(ProFileCache *cache)
+{
+    Q_ASSERT(m_proFiles.isEmpty());
+    m_cache = cache;
 }
 
 void ProFileReader::setQtVersion(QtVersion *qtVersion) {
@@ -60,13 +72,10 @@ void ProFileReader::setQtVersion(QtVersion *qtVersion) {
 
 bool ProFileReader::readProFile(const QString &fileName)
 {
-    //disable caching -> list of include files is not updated otherwise
     QString fn = QFileInfo(fileName).filePath();
-    ProFile *pro = new ProFile(fn);
-    if (!queryProFile(pro)) {
-        delete pro;
+    ProFile *pro = parseFile(fn);
+    if (!pro)
         return false;
-    }
     m_includeFiles.insert(fn, pro);
     m_proFiles.append(pro);
     return accept(pro);
@@ -75,7 +84,7 @@ bool ProFileReader::readProFile(const QString &fileName)
 ProFile *ProFileReader::parsedProFile(const QString &fileName)
 {
     QString fn =  QFileInfo(fileName).filePath();
-    ProFile *pro = ProFileEvaluator::parsedProFile(fn);
+    ProFile *pro = parseFile(fn);
     if (pro) {
         m_includeFiles.insert(fn, pro);
         m_proFiles.append(pro);
@@ -83,6 +92,23 @@ ProFile *ProFileReader::parsedProFile(const QString &fileName)
     return pro;
 }
 
+ProFile *ProFileReader::parseFile(const QString &fileName)
+{
+    if (m_cache) {
+        if (ProFile *pro = m_cache->proFile(fileName))
+            return pro;
+    }
+
+    ProFile *pro = new ProFile(fileName);
+    if (!queryProFile(pro)) {
+        delete pro;
+        return 0;
+    }
+    if (m_cache)
+        m_cache->insert(pro);
+    return pro;
+}
+
 void ProFileReader::releaseParsedProFile(ProFile *)
 {
     return;
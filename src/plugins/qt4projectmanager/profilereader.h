@@ -43,6 +43,7 @@
 namespace Qt4ProjectManager {
 namespace Internal {
 
+class ProFileCache;
 
 class ProFileReader : public QObject, public ProFileEvaluator
 {
@@ -53,6 +54,8 @@ public:
     ~ProFileReader();
 
     void setQtVersion(QtVersion *qtVersion);
+    // The parsed files are shared through the cache, if set.
+    void setProFileCache(ProFileCache *cache);
     bool readProFile(const QString &fileName);
     QList<ProFile*> includeFiles() const;
 
@@ -68,6 +71,7 @@ signals:
     void errorFound(const QString &error);
 
 private:
+    ProFile *parseFile(const QString &fileName);
     virtual ProFile *parsedProFile(const QString &fileName);
     virtual void releaseParsedProFile(ProFile *proFile);
     virtual void logMessage(const QString &msg);
@@ -77,6 +81,7 @@ private:
 private:
     QMap<QString, ProFile *> m_includeFiles;
     QList<ProFile *> m_proFiles;
+    ProFileCache *m_cache;
 };
 
 } // namespace Internal
@@ -51,6 +51,7 @@
 #include <cpptools/cppmodelmanagerinterface.h>
 
 #include <utils/qtcassert.h>
+#include <qtconcurrent/runextensions.h>
 
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
@@ -75,6 +76,11 @@ namespace {
     {
         return f1->fileName() < f2->fileName();
     }
+
+    void evaluateProFile(QFutureInterface<bool> &future, ProFileReader *reader, QString fileName)
+    {
+        future.reportResult(reader->readProFile(fileName));
+    }
 }
 
 /*!
@@ -326,6 +332,8 @@ void Qt4PriFileNode::changeFiles(const FileType fileType,
         return;
 
     ProFileReader *reader = m_qt4ProFileNode->createProFileReader();
+    // the parsed file is edited below, so it must not be shared
+    reader->setProFileCache(0);
     if (!reader->readProFile(m_qt4ProFileNode->path())) {
         m_project->proFileParseError(tr("Error while parsing file %1. Giving up.").arg(m_projectFilePath));
         delete reader;
@@ -499,7 +507,9 @@ Qt4ProFileNode::Qt4ProFileNode(Qt4Project *project,
           // own stuff
           m_projectType(InvalidProject),
           m_isQBuildProject(false),
-          m_dirWatcher(new DirectoryWatcher(this))
+          m_dirWatcher(new DirectoryWatcher(this)),
+          m_evaluatingReader(0),
+          m_updatePending(false)
 {
     if (parent)
         setParent(parent);
@@ -515,11 +525,17 @@ Qt4ProFileNode::Qt4ProFileNode(Qt4Project *project,
             this, SLOT(update()));
     connect(&m_updateTimer, SIGNAL(timeout()),
             this, SLOT(update()));
+    connect(&m_evaluateWatcher, SIGNAL(finished()),
+            this, SLOT(evaluationDone()));
 }
 
 Qt4ProFileNode::~Qt4ProFileNode()
 {
-
+    if (m_evaluatingReader) {
+        m_evaluateWatcher.waitForFinished();
+        delete m_evaluatingReader;
+        m_project->evaluationFinished();
+    }
 }
 
 bool Qt4ProFileNode::hasTargets() const
@@ -542,16 +558,46 @@ void Qt4ProFileNode::scheduleUpdate()
     m_updateTimer.start();
 }
 
+/*
+  Starts evaluating the .pro file in a worker thread. Sub projects are
+  evaluated when this evaluation is done, concurrently with each other.
+  */
 void Qt4ProFileNode::update()
 {
-    ProFileReader *reader = createProFileReader();
-    if (!reader->readProFile(m_projectFilePath)) {
+    // an update requested while evaluating starts when the evaluation is done
+    if (m_evaluatingReader) {
+        m_updatePending = true;
+        return;
+    }
+
+    m_evaluatingReader = createProFileReader();
+    m_project->evaluationStarted();
+    m_evaluateWatcher.setFuture(QtConcurrent::run(evaluateProFile, m_evaluatingReader,
+                                                  m_projectFilePath));
+}
+
+void Qt4ProFileNode::evaluationDone()
+{
+    ProFileReader *reader = m_evaluatingReader;
+    m_evaluatingReader = 0;
+
+    if (m_evaluateWatcher.result()) {
+        applyEvaluation(reader);
+    } else {
         m_project->proFileParseError(tr("Error while parsing file %1. Giving up.").arg(m_projectFilePath));
-        delete reader;
         invalidate();
-        return;
     }
+    delete reader;
 
+    if (m_updatePending) {
+        m_updatePending = false;
+        update();
+    }
+    m_project->evaluationFinished();
+}
+
+void Qt4ProFileNode::applyEvaluation(ProFileReader *reader)
+{
     if (debug)
         qDebug() << "Qt4ProFileNode - updating files for file " << m_projectFilePath;
 
@@ -694,8 +740,6 @@ void Qt4ProFileNode::update()
     foreach (NodesWatcher *watcher, watchers())
         if (Qt4NodesWatcher *qt4Watcher = qobject_cast<Qt4NodesWatcher*>(watcher))
             emit qt4Watcher->proFileUpdated(this);
-
-    delete reader;
 }
 
 void Qt4ProFileNode::fileChanged(const QString &filePath)
@@ -816,6 +860,7 @@ void Qt4ProFileNode::updateGeneratedFiles()
 ProFileReader *Qt4PriFileNode::createProFileReader() const
 {
     ProFileReader *reader = new ProFileReader();
+    reader->setProFileCache(m_project->qt4ProjectManager()->proFileCache());
     connect(reader, SIGNAL(errorFound(const QString &)),
             m_project, SLOT(proFileParseError(const QString &)));
 
@@ -36,6 +36,7 @@
 
 #include <projectexplorer/projectnodes.h>
 
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QHash>
 #include <QtCore/QStringList>
 #include <QtCore/QTimer>
@@ -186,8 +187,10 @@ public slots:
 private slots:
     void fileChanged(const QString &filePath);
     void updateGeneratedFiles();
+    void evaluationDone();
 
 private:
+    void applyEvaluation(ProFileReader *reader);
     Qt4ProFileNode *createSubProFileNode(const QString &path);
 
     QStringList uiDirPaths(ProFileReader *reader) const;
@@ -206,6 +209,12 @@ private:
     QTimer m_updateTimer;
 
     DirectoryWatcher *m_dirWatcher;
+
+    // the .pro file is evaluated in a worker thread
+    QFutureWatcher<bool> m_evaluateWatcher;
+    ProFileReader *m_evaluatingReader;
+    bool m_updatePending;
+
     friend class Qt4NodeHierarchy;
 };
 
@@ -47,13 +47,17 @@
 #include "qt4projectmanagerconstants.h"
 #include "projectloadwizard.h"
 #include "gdbmacrosbuildstep.h"
+#include "toolchainprobecache.h"
 
 #include <coreplugin/messagemanager.h>
 #include <coreplugin/coreconstants.h>
+#include <coreplugin/icore.h>
+#include <coreplugin/progressmanager/progressmanagerinterface.h>
 #include <cpptools/cppmodelmanagerinterface.h>
 #include <projectexplorer/nodesvisitor.h>
 #include <projectexplorer/project.h>
 #include <projectexplorer/customexecutablerunconfiguration.h>
+#include <utils/qtcassert.h>
 
 #include <QtGui/QFileDialog>
 #include <QtCore/QDir>
@@ -69,16 +73,48 @@ enum { debug = 0 };
 namespace Qt4ProjectManager {
 namespace Internal {
 
-// Qt4ProjectFiles: Struct for (Cached) lists of files in a project
+// Qt4ProjectFiles: Struct for the files of a project. It is kept up to date
+// from the signals of the node tree, every path is counted as often as there
+// are nodes for it, since the same file can be part of several .pro files.
 struct Qt4ProjectFiles {
-    void clear();
-    bool equals(const Qt4ProjectFiles &f) const;
+    Qt4ProjectFiles() : changed(false) {}
 
-    QStringList files[ProjectExplorer::FileTypeSize];
-    QStringList generatedFiles[ProjectExplorer::FileTypeSize];
-    QStringList proFiles;
+    void clear();
+    void addFile(FileNode *fileNode);
+    void removeFile(FileNode *fileNode);
+    void addProFile(const QString &path);
+    void removeProFile(const QString &path);
+    bool contains(const QString &path, bool includeGenerated) const;
+    QStringList fileList(bool includeGenerated) const;
+
+    QHash<QString, int> files[ProjectExplorer::FileTypeSize];
+    QHash<QString, int> generatedFiles[ProjectExplorer::FileTypeSize];
+    QHash<QString, int> proFiles;
+
+    // Set whenever a path is added or removed.
+    bool changed;
+
+    // The lists handed out by Qt4Project::files(), rebuilt after changes.
+    mutable QStringList allFiles;
+    mutable QStringList nonGeneratedFiles;
 };
 
+static bool addPath(QHash<QString, int> &paths, const QString &path)
+{
+    return ++paths[path] == 1;
+}
+
+static bool removePath(QHash<QString, int> &paths, const QString &path)
+{
+    QHash<QString, int>::iterator it = paths.find(path);
+    if (it == paths.end())
+        return false;
+    if (--it.value())
+        return false;
+    paths.erase(it);
+    return true;
+}
+
 void Qt4ProjectFiles::clear()
 {
     for (int i = 0; i < FileTypeSize; ++i) {
@@ -86,82 +122,131 @@ void Qt4ProjectFiles::clear()
         generatedFiles[i].clear();
     }
     proFiles.clear();
+    allFiles.clear();
+    nonGeneratedFiles.clear();
+    changed = true;
 }
 
-bool Qt4ProjectFiles::equals(const Qt4ProjectFiles &f) const
+void Qt4ProjectFiles::addFile(FileNode *fileNode)
 {
-    for (int i = 0; i < FileTypeSize; ++i)
-        if (files[i] != f.files[i] || generatedFiles[i] != f.generatedFiles[i])
-            return false;
-    if (proFiles != f.proFiles)
-        return false;
-    return true;
+    const int type = fileNode->fileType();
+    QHash<QString, int> &paths = fileNode->isGenerated() ? generatedFiles[type] : files[type];
+    if (addPath(paths, fileNode->path())) {
+        allFiles.clear();
+        nonGeneratedFiles.clear();
+        changed = true;
+    }
+}
+
+void Qt4ProjectFiles::removeFile(FileNode *fileNode)
+{
+    const int type = fileNode->fileType();
+    QHash<QString, int> &paths = fileNode->isGenerated() ? generatedFiles[type] : files[type];
+    if (removePath(paths, fileNode->path())) {
+        allFiles.clear();
+        nonGeneratedFiles.clear();
+        changed = true;
+    }
 }
 
-inline bool operator==(const Qt4ProjectFiles &f1, const Qt4ProjectFiles &f2)
-{       return f1.equals(f2); }
+void Qt4ProjectFiles::addProFile(const QString &path)
+{
+    if (addPath(proFiles, path))
+        changed = true;
+}
+
+void Qt4ProjectFiles::removeProFile(const QString &path)
+{
+    if (removePath(proFiles, path))
+        changed = true;
+}
+
+bool Qt4ProjectFiles::contains(const QString &path, bool includeGenerated) const
+{
+    for (int i = 0; i < FileTypeSize; ++i) {
+        if (files[i].contains(path))
+            return true;
+        if (includeGenerated && generatedFiles[i].contains(path))
+            return true;
+    }
+    return false;
+}
 
-inline bool operator!=(const Qt4ProjectFiles &f1, const Qt4ProjectFiles &f2)
-{       return !f1.equals(f2); }
+QStringList Qt4ProjectFiles::fileList(bool includeGenerated) const
+{
+    QStringList &list = includeGenerated ? allFiles : nonGeneratedFiles;
+    if (list.isEmpty()) {
+        for (int i = 0; i < FileTypeSize; ++i) {
+            list += files[i].keys();
+            if (includeGenerated)
+                list += generatedFiles[i].keys();
+        }
+    }
+    return list;
+}
 
 QDebug operator<<(QDebug d, const  Qt4ProjectFiles &f)
 {
     QDebug nsp = d.nospace();
-    nsp << "Qt4ProjectFiles: proFiles=" <<  f.proFiles << '\n';
+    nsp << "Qt4ProjectFiles: proFiles=" <<  f.proFiles.keys() << '\n';
     for (int i = 0; i < FileTypeSize; ++i)
-        nsp << "Type " << i << " files=" << f.files[i] <<  " generated=" << f.generatedFiles[i] << '\n';
+        nsp << "Type " << i << " files=" << f.files[i].keys() <<  " generated=" << f.generatedFiles[i].keys() << '\n';
     return d;
 }
 
-// A visitor to collect all files of a project in a Qt4ProjectFiles struct
+// A visitor to add or remove all files below a node to/from a Qt4ProjectFiles struct
+
 class ProjectFilesVisitor : public ProjectExplorer::NodesVisitor
 {
     Q_DISABLE_COPY(ProjectFilesVisitor)
-    ProjectFilesVisitor(Qt4ProjectFiles *files);
+    ProjectFilesVisitor(Qt4ProjectFiles *files, bool remove);
 public:
 
-    static void findProjectFiles(Qt4ProFileNode *rootNode, Qt4ProjectFiles *files);
+    static void addProjectFiles(FolderNode *folderNode, Qt4ProjectFiles *files);
+    static void removeProjectFiles(FolderNode *folderNode, Qt4ProjectFiles *files);
 
     void visitProjectNode(ProjectNode *projectNode);
     void visitFolderNode(FolderNode *folderNode);
 
 private:
     Qt4ProjectFiles *m_files;
+    bool m_remove;
 };
 
-ProjectFilesVisitor::ProjectFilesVisitor(Qt4ProjectFiles *files) :
-    m_files(files)
+ProjectFilesVisitor::ProjectFilesVisitor(Qt4ProjectFiles *files, bool remove) :
+    m_files(files),
+    m_remove(remove)
 {
 }
 
-void ProjectFilesVisitor::findProjectFiles(Qt4ProFileNode *rootNode, Qt4ProjectFiles *files)
+void ProjectFilesVisitor::addProjectFiles(FolderNode *folderNode, Qt4ProjectFiles *files)
 {
-    files->clear();
-    ProjectFilesVisitor visitor(files);
-    rootNode->accept(&visitor);
-    for (int i = 0; i < FileTypeSize; ++i) {
-        qSort(files->files[i]);
-        qSort(files->generatedFiles[i]);
-    }
-    qSort(files->proFiles);
+    ProjectFilesVisitor visitor(files, false);
+    folderNode->accept(&visitor);
+}
+
+void ProjectFilesVisitor::removeProjectFiles(FolderNode *folderNode, Qt4ProjectFiles *files)
+{
+    ProjectFilesVisitor visitor(files, true);
+    folderNode->accept(&visitor);
 }
 
 void ProjectFilesVisitor::visitProjectNode(ProjectNode *projectNode)
 {
-    const QString path = projectNode->path();
-    if (!m_files->proFiles.contains(path))
-        m_files->proFiles.append(path);
+    if (m_remove)
+        m_files->removeProFile(projectNode->path());
+    else
+        m_files->addProFile(projectNode->path());
     visitFolderNode(projectNode);
 }
 
 void ProjectFilesVisitor::visitFolderNode(FolderNode *folderNode)
 {
     foreach (FileNode *fileNode, folderNode->fileNodes()) {
-        const QString path = fileNode->path();
-        const int type = fileNode->fileType();
-        QStringList &targetList = fileNode->isGenerated() ? m_files->generatedFiles[type] : m_files->files[type];
-        if (!targetList.contains(path))
-            targetList.push_back(path);
+        if (m_remove)
+            m_files->removeFile(fileNode);
+        else
+            m_files->addFile(fileNode);
     }
 }
 
@@ -235,10 +320,24 @@ Qt4Project::Qt4Project(Qt4Manager *manager, const QString& fileName) :
     m_nodesWatcher(new Internal::Qt4NodesWatcher(this)),
     m_fileInfo(new Qt4ProjectFile(this, fileName, this)),
     m_isApplication(true),
+    m_evaluationFuture(0),
+    m_pendingEvaluations(0),
+    m_finishedEvaluations(0),
+    m_setupRunConfigurationsPending(false),
     m_projectFiles(new Qt4ProjectFiles)
 {
     m_manager->registerProject(this);
     m_rootProjectNode->registerWatcher(m_nodesWatcher);
+    ProjectFilesVisitor::addProjectFiles(m_rootProjectNode, m_projectFiles);
+    m_projectFiles->changed = false;
+    connect(m_nodesWatcher, SIGNAL(foldersAboutToBeAdded(FolderNode *, const QList<FolderNode*> &)),
+            this, SLOT(addFolderNodeFiles(FolderNode *, const QList<FolderNode*> &)));
+    connect(m_nodesWatcher, SIGNAL(foldersAboutToBeRemoved(FolderNode *, const QList<FolderNode*> &)),
+            this, SLOT(removeFolderNodeFiles(FolderNode *, const QList<FolderNode*> &)));
+    connect(m_nodesWatcher, SIGNAL(filesAboutToBeAdded(FolderNode *, const QList<FileNode*> &)),
+            this, SLOT(addFileNodes(FolderNode *, const QList<FileNode*> &)));
+    connect(m_nodesWatcher, SIGNAL(filesAboutToBeRemoved(FolderNode *, const QList<FileNode*> &)),
+            this, SLOT(removeFileNodes(FolderNode *, const QList<FileNode*> &)));
     connect(m_nodesWatcher, SIGNAL(foldersAdded()), this, SLOT(updateFileList()));
     connect(m_nodesWatcher, SIGNAL(foldersRemoved()), this, SLOT(updateFileList()));
     connect(m_nodesWatcher, SIGNAL(filesAdded()), this, SLOT(updateFileList()));
@@ -254,10 +353,15 @@ Qt4Project::Qt4Project(Qt4Manager *manager, const QString& fileName) :
     m_updateCodeModelTimer.setSingleShot(true);
     m_updateCodeModelTimer.setInterval(20);
     connect(&m_updateCodeModelTimer, SIGNAL(timeout()), this, SLOT(updateCodeModel()));
+    connect(ToolchainProbeCache::instance(), SIGNAL(probeFinished()),
+            this, SLOT(scheduleUpdateCodeModel()));
 }
 
 Qt4Project::~Qt4Project()
 {
+    // the nodes wait for their evaluations and report back to the project
+    m_setupRunConfigurationsPending = false;
+    delete m_rootProjectNode;
     m_manager->unregisterProject(this);
     delete m_projectFiles;
 }
@@ -279,12 +383,36 @@ void Qt4Project::qtVersionsChanged()
     }
 }
 
+void Qt4Project::addFolderNodeFiles(FolderNode *, const QList<FolderNode*> &folderNodes)
+{
+    foreach (FolderNode *folderNode, folderNodes)
+        ProjectFilesVisitor::addProjectFiles(folderNode, m_projectFiles);
+}
+
+void Qt4Project::removeFolderNodeFiles(FolderNode *, const QList<FolderNode*> &folderNodes)
+{
+    foreach (FolderNode *folderNode, folderNodes)
+        ProjectFilesVisitor::removeProjectFiles(folderNode, m_projectFiles);
+}
+
+void Qt4Project::addFileNodes(FolderNode *, const QList<FileNode*> &fileNodes)
+{
+    foreach (FileNode *fileNode, fileNodes)
+        m_projectFiles->addFile(fileNode);
+}
+
+void Qt4Project::removeFileNodes(FolderNode *, const QList<FileNode*> &fileNodes)
+{
+    foreach (FileNode *fileNode, fileNodes)
+        m_projectFiles->removeFile(fileNode);
+}
+
+// The node tree has changed, the files have been updated by the
+// signals announcing the changes already.
 void Qt4Project::updateFileList()
 {
-    Qt4ProjectFiles newFiles;
-    ProjectFilesVisitor::findProjectFiles(m_rootProjectNode, &newFiles);
-    if (newFiles != *m_projectFiles) {
-        *m_projectFiles = newFiles;
+    if (m_projectFiles->changed) {
+        m_projectFiles->changed = false;
         emit fileListChanged();
         if (debug)
             qDebug() << Q_FUNC_INFO << *m_projectFiles;
@@ -302,8 +430,13 @@ void Qt4Project::restoreSettingsImpl(PersistentSettingsReader &settingsReader)
     foreach (const QString &bc, buildConfigurations())
         qtVersionId(bc);
 
+    // the run configurations are set up once the whole tree is evaluated
+    m_setupRunConfigurationsPending = true;
     update();
+}
 
+void Qt4Project::setupRunConfigurations()
+{
     // restored old runconfigurations
     if (runConfigurations().isEmpty()) {
         // Oha no runConfigurations, add some
@@ -343,6 +476,39 @@ void Qt4Project::restoreSettingsImpl(PersistentSettingsReader &settingsReader)
 
 }
 
+void Qt4Project::evaluationStarted()
+{
+    if (!m_pendingEvaluations) {
+        m_finishedEvaluations = 0;
+        m_evaluationFuture = new QFutureInterface<void>;
+        m_manager->core()->progressManager()->addTask(m_evaluationFuture->future(),
+                                                      tr("Evaluating"),
+                                                      QLatin1String(Constants::PROFILE_EVALUATE),
+                                                      Core::ProgressManagerInterface::CloseOnSuccess);
+        m_evaluationFuture->reportStarted();
+    }
+    ++m_pendingEvaluations;
+    m_evaluationFuture->setProgressRange(0, m_finishedEvaluations + m_pendingEvaluations);
+}
+
+void Qt4Project::evaluationFinished()
+{
+    QTC_ASSERT(m_pendingEvaluations > 0, return);
+    ++m_finishedEvaluations;
+    m_evaluationFuture->setProgressValue(m_finishedEvaluations);
+    if (--m_pendingEvaluations)
+        return;
+
+    m_evaluationFuture->reportFinished();
+    delete m_evaluationFuture;
+    m_evaluationFuture = 0;
+
+    if (m_setupRunConfigurationsPending) {
+        m_setupRunConfigurationsPending = false;
+        setupRunConfigurations();
+    }
+}
+
 void Qt4Project::saveSettingsImpl(ProjectExplorer::PersistentSettingsWriter &writer)
 {
     Project::saveSettingsImpl(writer);
@@ -399,6 +565,9 @@ void Qt4Project::updateCodeModel()
         QString qmake_cxx = list.isEmpty() ? QString::null : list.first();
         qmake_cxx = environment(activeBuildConfiguration()).searchInPath(qmake_cxx);
         m_preproc.setGcc(qmake_cxx);
+        // updated again when the compiler was probed
+        if (! m_preproc.isProbed())
+            return;
         predefinedMacros = m_preproc.predefinedMacros();
         foreach (HeaderPath headerPath, m_preproc.systemHeaderPaths()) {
             if (headerPath.kind() == HeaderPath::FrameworkHeaderPath)
@@ -478,10 +647,11 @@ void Qt4Project::updateCodeModel()
     allIncludePaths.append(qtVersion(activeBuildConfiguration())->mkspecPath());
 
     QStringList files;
-    files += m_projectFiles->files[HeaderType];
-    files += m_projectFiles->generatedFiles[HeaderType];
-    files += m_projectFiles->files[SourceType];
-    files += m_projectFiles->generatedFiles[SourceType];
+    files += m_projectFiles->files[HeaderType].keys();
+    files += m_projectFiles->generatedFiles[HeaderType].keys();
+    files += m_projectFiles->files[SourceType].keys();
+    files += m_projectFiles->generatedFiles[SourceType].keys();
+    qSort(files); // the order of the hashes depends on their history
 
     CppTools::CppModelManagerInterface::ProjectInfo pinfo = modelmanager->projectInfo(this);
 
@@ -497,8 +667,8 @@ void Qt4Project::updateCodeModel()
         pinfo.frameworkPaths = allFrameworkPaths;
         pinfo.sourceFiles = files;
 
-        modelmanager->updateProjectInfo(pinfo);
-        modelmanager->updateSourceFiles(pinfo.sourceFiles);
+        // reindexes only what is affected by the changes
+        modelmanager->updateProjectSources(pinfo);
     }
 }
 
@@ -516,6 +686,7 @@ void Qt4Project::update()
 ProFileReader *Qt4Project::createProFileReader() const
 {
     ProFileReader *reader = new ProFileReader();
+    reader->setProFileCache(m_manager->proFileCache());
     connect(reader, SIGNAL(errorFound(const QString&)),
             this, SLOT(proFileParseError(const QString&)));
     QtVersion *version = qtVersion(activeBuildConfiguration());
@@ -560,13 +731,7 @@ Core::IFile *Qt4Project::file() const
 
 QStringList Qt4Project::files(FilesMode fileMode) const
 {
-    QStringList files;
-    for (int i = 0; i < FileTypeSize; ++i) {
-        files += m_projectFiles->files[i];
-        if (fileMode == AllFiles)
-            files += m_projectFiles->generatedFiles[i];
-    }
-    return files;
+    return m_projectFiles->fileList(fileMode == AllFiles);
 }
 
 QList<Core::IFile *> Qt4Project::dependencies()
@@ -935,7 +1100,7 @@ void Qt4Project::findProFile(const QString& fileName, Qt4ProFileNode *root, QLis
 
 void Qt4Project::notifyChanged(const QString &name)
 {
-    if (files(Qt4Project::ExcludeGeneratedFiles).contains(name)) {
+    if (m_projectFiles->contains(name, false)) {
         QList<Qt4ProFileNode *> list;
         findProFile(name, rootProjectNode(), list);
         foreach(Qt4ProFileNode *node, list)
@@ -44,6 +44,7 @@
 #include <projectexplorer/applicationrunconfiguration.h>
 #include <projectexplorer/projectnodes.h>
 
+#include <QtCore/QFutureInterface>
 #include <QtCore/QObject>
 #include <QtCore/QList>
 #include <QtCore/QStringList>
@@ -182,6 +183,10 @@ public:
 
     void notifyChanged(const QString &name);
 
+    // called by the Qt4ProFileNodes around evaluating their .pro file
+    void evaluationStarted();
+    void evaluationFinished();
+
 public slots:
     void update();
     void proFileParseError(const QString &errorMessage);
@@ -192,6 +197,10 @@ private slots:
     void defaultQtVersionChanged();
     void qtVersionsChanged();
     void updateFileList();
+    void addFolderNodeFiles(FolderNode *, const QList<FolderNode*> &);
+    void removeFolderNodeFiles(FolderNode *, const QList<FolderNode*> &);
+    void addFileNodes(FolderNode *, const QList<FileNode*> &);
+    void removeFileNodes(FolderNode *, const QList<FileNode*> &);
 
     void foldersAboutToBeAdded(FolderNode *, const QList<FolderNode*> &);
     void checkForNewApplicationProjects();
@@ -214,6 +223,7 @@ private:
     ProjectExplorer::ProjectExplorerPlugin *projectExplorer() const;
 
     void addDefaultBuild();
+    void setupRunConfigurations();
 
     static QString qmakeVarName(ProjectExplorer::FileType type);
 
@@ -224,11 +234,16 @@ private:
     Qt4ProjectFile *m_fileInfo;
     bool m_isApplication;
 
+    QFutureInterface<void> *m_evaluationFuture;
+    int m_pendingEvaluations;
+    int m_finishedEvaluations;
+    bool m_setupRunConfigurationsPending;
+
     // Current configuration
     QString m_oldQtIncludePath;
     QString m_oldQtLibsPath;
 
-    // cached lists of all of files
+    // all files of the project, kept up to date from the node tree
     Internal::Qt4ProjectFiles *m_projectFiles;
 
     QTimer m_updateCodeModelTimer;
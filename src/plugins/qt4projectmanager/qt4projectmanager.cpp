@@ -38,6 +38,7 @@
 #include "qt4nodes.h"
 #include "qt4project.h"
 #include "profilereader.h"
+#include "profilecache.h"
 #include "qtversionmanager.h"
 #include "qmakestep.h"
 
@@ -80,7 +81,8 @@ Qt4Manager::Qt4Manager(Qt4ProjectManagerPlugin *plugin, Core::ICore *core) :
     m_core(core),
     m_projectExplorer(0),
     m_contextProject(0),
-    m_languageID(0)
+    m_languageID(0),
+    m_proFileCache(new ProFileCache(this))
 {
     m_languageID = m_core->uniqueIDManager()->
         uniqueIdentifier(ProjectExplorer::Constants::LANG_CXX);
@@ -102,6 +104,7 @@ void Qt4Manager::unregisterProject(Qt4Project *project)
 
 void Qt4Manager::notifyChanged(const QString &name)
 {
+    m_proFileCache->invalidate(name);
     foreach (Qt4Project *pro, m_projects)
         pro->notifyChanged(name);
 }
@@ -206,6 +209,11 @@ QtVersionManager *Qt4Manager::versionManager() const
     return m_plugin->versionManager();
 }
 
+ProFileCache *Qt4Manager::proFileCache() const
+{
+    return m_proFileCache;
+}
+
 void Qt4Manager::runQMake()
 {
     runQMake(m_projectExplorer->currentProject());
@@ -57,6 +57,7 @@ namespace Qt4ProjectManager {
 
 namespace Internal {
 class Qt4Builder;
+class ProFileCache;
 class ProFileEditor;
 class Qt4ProjectManagerPlugin;
 class QtVersionManager;
@@ -97,6 +98,7 @@ public:
     ProjectExplorer::Project *contextProject() const;
 
     Internal::QtVersionManager *versionManager() const;
+    Internal::ProFileCache *proFileCache() const;
 
     // Return the id string of a file
     static QString fileTypeId(ProjectExplorer::FileType type);
@@ -118,7 +120,7 @@ private:
     ProjectExplorer::Project *m_contextProject;
 
     int m_languageID;
-
+    Internal::ProFileCache *m_proFileCache;
 };
 
 } // namespace Qt4ProjectManager
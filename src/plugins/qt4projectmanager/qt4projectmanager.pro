@@ -40,6 +40,7 @@ HEADERS = qt4projectmanagerplugin.h \
     speinfo.h \
     headerpath.h \
     gccpreprocessor.h \
+    toolchainprobecache.h \
     qt4buildconfigwidget.h \
     qt4buildenvironmentwidget.h \
     projectloadwizard.h \
@@ -55,6 +56,7 @@ SOURCES = qt4projectmanagerplugin.cpp \
     profilehighlighter.cpp \
     profileeditorfactory.cpp \
     profilereader.cpp \
+    profilecache.cpp \
     wizards/qtprojectparameters.cpp \
     wizards/guiappwizard.cpp \
     wizards/consoleappwizard.cpp \
@@ -79,6 +81,7 @@ SOURCES = qt4projectmanagerplugin.cpp \
     qt4runconfiguration.cpp \
     speinfo.cpp \
     gccpreprocessor.cpp \
+    toolchainprobecache.cpp \
     qt4buildconfigwidget.cpp \
     qt4buildenvironmentwidget.cpp \
     projectloadwizard.cpp \
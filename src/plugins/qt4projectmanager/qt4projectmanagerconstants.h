@@ -82,6 +82,9 @@ const char * const QT4RUNSTEP = "trolltech.qt4projectmanager.qt4runstep";
 const char * const BUILD_PARSER_MSVC    = "BuildParser.MSVC";
 const char * const BUILD_PARSER_GCC     = "BuildParser.Gcc";
 
+// tasks
+const char * const PROFILE_EVALUATE     = "Qt4ProjectManager.ProFileEvaluate";
+
 // views
 const char * const VIEW_DETAILED        = "Qt4.View.Detailed";
 const char * const VIEW_PROFILESONLY    = "Qt4.View.ProjectHierarchy";
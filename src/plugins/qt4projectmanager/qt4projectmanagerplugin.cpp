@@ -47,6 +47,7 @@
 #include "qt4runconfiguration.h"
 #include "profilereader.h"
 #include "gdbmacrosbuildstep.h"
+#include "toolchainprobecache.h"
 
 #include <projectexplorer/project.h>
 #include <projectexplorer/projectnodes.h>
@@ -55,6 +56,8 @@
 #include <coreplugin/actionmanager/actionmanagerinterface.h>
 #include <texteditor/texteditoractionhandler.h>
 
+#include <QtCore/QFileInfo>
+#include <QtCore/QSettings>
 #include <QtCore/qplugin.h>
 #include <QtGui/QMenu>
 #include <QDebug>
@@ -128,6 +131,10 @@ bool Qt4ProjectManagerPlugin::initialize(const QStringList & /*arguments*/, QStr
     addAutoReleasedObject(new GccParserFactory);
     addAutoReleasedObject(new MsvcParserFactory);
 
+    // the compilers and qmakes probed in the previous sessions
+    new ToolchainProbeCache(QFileInfo(m_core->settings()->fileName()).path()
+                            + QLatin1String("/qtcreator/toolchainprobes.cache"), this);
+
     m_qtVersionManager = new QtVersionManager;
     addObject(m_qtVersionManager);
 
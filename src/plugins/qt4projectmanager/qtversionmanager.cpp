@@ -36,13 +36,13 @@
 #include "qt4projectmanagerconstants.h"
 #include "msvcenvironment.h"
 #include "cesdkhandler.h"
+#include "toolchainprobecache.h"
 
 #include <coreplugin/coreconstants.h>
 #include <help/helpplugin.h>
 #include <utils/qtcassert.h>
 
 #include <QtCore/QDebug>
-#include <QtCore/QProcess>
 #include <QtCore/QSettings>
 #include <QtCore/QStringRef>
 #include <QtCore/QTime>
@@ -316,11 +316,9 @@ QStringList QtVersionManager::possibleQMakeCommands()
 
 QString QtVersionManager::qtVersionForQMake(const QString &qmakePath)
 {
-    QProcess qmake;
-    qmake.start(qmakePath, QStringList()<<"--version");
-    if (!qmake.waitForFinished())
-        return false;
-    QString output = qmake.readAllStandardOutput();
+    const ToolchainProbeCache::Output version =
+            ToolchainProbeCache::instance()->waitForOutput(qmakePath, QStringList()<<"--version", 30000);
+    QString output = version.standardOutput;
     QRegExp regexp("(QMake version|Qmake version:)[\\s]*([\\d.]*)");
     regexp.indexIn(output);
     if (regexp.cap(2).startsWith("2.")) {
@@ -968,17 +966,16 @@ void QtVersion::updateVersionInfo() const
              << "QT_INSTALL_PREFIX";
         QStringList args = QStringList() << QString("-query")
                            << variables.join(" -query ").split(" ", QString::SkipEmptyParts);
-        QProcess process;
-        process.start(qmake.absoluteFilePath(), args, QIODevice::ReadOnly);
-        if (process.waitForFinished(2000)) {
-            QByteArray output = process.readAllStandardOutput();
-            QTextStream stream(&output);
-            while (!stream.atEnd()) {
-                QString line = stream.readLine();
-                int index = line.indexOf(":");
-                if (index != -1)
-                    m_versionInfo.insert(line.left(index), QDir::fromNativeSeparators(line.mid(index+1)));
-            }
+        // qmake is only run if its output is not cached from a previous run
+        const ToolchainProbeCache::Output query =
+                ToolchainProbeCache::instance()->waitForOutput(qmake.absoluteFilePath(), args, 2000);
+        QByteArray output = query.standardOutput;
+        QTextStream stream(&output);
+        while (!stream.atEnd()) {
+            QString line = stream.readLine();
+            int index = line.indexOf(":");
+            if (index != -1)
+                m_versionInfo.insert(line.left(index), QDir::fromNativeSeparators(line.mid(index+1)));
         }
 
         if (m_versionInfo.contains("QT_INSTALL_DATA"))
@@ -0,0 +1,231 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "toolchainprobecache.h"
+
+#include <utils/qtcassert.h>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QProcess>
+
+using namespace Qt4ProjectManager::Internal;
+
+enum {
+    CacheMagic = 0x54435052,
+    CacheVersion = 1
+};
+
+ToolchainProbeCache *ToolchainProbeCache::m_instance = 0;
+
+// Only the output of probes that ran to completion may be kept, a compiler
+// that crashed or failed to start may well succeed the next time.
+static bool probeSucceeded(const QProcess &process)
+{
+    return process.error() == QProcess::UnknownError
+            && process.exitStatus() == QProcess::NormalExit
+            && process.exitCode() == 0;
+}
+
+ToolchainProbeCache::ToolchainProbeCache(const QString &cacheFileName, QObject *parent)
+    : QObject(parent),
+      m_cacheFileName(cacheFileName)
+{
+    QTC_ASSERT(!m_instance, return);
+    m_instance = this;
+    load();
+}
+
+ToolchainProbeCache::~ToolchainProbeCache()
+{
+    foreach (QProcess *process, m_running.keys()) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished();
+        delete process;
+    }
+    m_instance = 0;
+}
+
+ToolchainProbeCache *ToolchainProbeCache::instance()
+{
+    return m_instance;
+}
+
+bool ToolchainProbeCache::output(const QString &program, const QStringList &arguments, Output *output)
+{
+    const QString k = key(program, arguments);
+    if (lookup(k, program, output))
+        return true;
+
+    const QStringList command = QStringList() << program << arguments;
+    foreach (const QStringList &runningCommand, m_running) {
+        if (runningCommand == command)
+            return false;
+    }
+
+    QProcess *process = new QProcess(this);
+    m_running.insert(process, command);
+    connect(process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(processFinished()));
+    connect(process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(processFinished()));
+    process->start(program, arguments);
+    process->closeWriteChannel();
+    return false;
+}
+
+ToolchainProbeCache::Output ToolchainProbeCache::waitForOutput(const QString &program,
+                                                               const QStringList &arguments,
+                                                               int msecs)
+{
+    const QString k = key(program, arguments);
+    Output output;
+    if (lookup(k, program, &output))
+        return output;
+
+    QProcess process;
+    process.start(program, arguments);
+    process.closeWriteChannel();
+    if (!process.waitForFinished(msecs))
+        return output;
+    output.standardOutput = process.readAllStandardOutput();
+    output.standardError = process.readAllStandardError();
+    if (probeSucceeded(process))
+        insert(k, program, output);
+    return output;
+}
+
+void ToolchainProbeCache::processFinished()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    // error() and finished() may both be emitted for the same process
+    if (!process || !m_running.contains(process) || process->state() != QProcess::NotRunning)
+        return;
+
+    QStringList arguments = m_running.take(process);
+    const QString program = arguments.takeFirst();
+    process->deleteLater();
+
+    Output output;
+    output.standardOutput = process->readAllStandardOutput();
+    output.standardError = process->readAllStandardError();
+    // failed probes are not retried before the next session, or they would
+    // be restarted as soon as probeFinished() is handled
+    if (probeSucceeded(*process))
+        insert(key(program, arguments), program, output);
+    else
+        m_failedProbes.insert(key(program, arguments), output);
+    emit probeFinished();
+}
+
+QString ToolchainProbeCache::key(const QString &program, const QStringList &arguments)
+{
+    return (QStringList() << program << arguments).join(QLatin1String("\n"));
+}
+
+bool ToolchainProbeCache::lookup(const QString &key, const QString &program, Output *output) const
+{
+    QHash<QString, Entry>::const_iterator it = m_entries.constFind(key);
+    if (it == m_entries.constEnd()) {
+        QHash<QString, Output>::const_iterator failed = m_failedProbes.constFind(key);
+        if (failed == m_failedProbes.constEnd())
+            return false;
+        *output = failed.value();
+        return true;
+    }
+
+    // the compiler was updated
+    const QFileInfo fi(program);
+    if (fi.lastModified() != it.value().lastModified || fi.size() != it.value().size)
+        return false;
+
+    *output = it.value().output;
+    return true;
+}
+
+void ToolchainProbeCache::insert(const QString &key, const QString &program, const Output &output)
+{
+    const QFileInfo fi(program);
+    Entry entry;
+    entry.output = output;
+    entry.lastModified = fi.lastModified();
+    entry.size = fi.size();
+    m_entries.insert(key, entry);
+    save();
+}
+
+void ToolchainProbeCache::load()
+{
+    QFile file(m_cacheFileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_4);
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (magic != CacheMagic || version != CacheVersion)
+        return;
+
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString key;
+        Entry entry;
+        in >> key >> entry.lastModified >> entry.size
+           >> entry.output.standardOutput >> entry.output.standardError;
+        if (in.status() == QDataStream::Ok)
+            m_entries.insert(key, entry);
+    }
+}
+
+void ToolchainProbeCache::save() const
+{
+    QDir().mkpath(QFileInfo(m_cacheFileName).path());
+    const QString tempFileName = m_cacheFileName + QLatin1String(".tmp");
+    QFile file(tempFileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_4);
+    out << quint32(CacheMagic) << quint32(CacheVersion) << quint32(m_entries.size());
+    QHash<QString, Entry>::const_iterator it = m_entries.constBegin();
+    for (; it != m_entries.constEnd(); ++it) {
+        out << it.key() << it.value().lastModified << it.value().size
+            << it.value().output.standardOutput << it.value().output.standardError;
+    }
+    file.close();
+
+    QFile::remove(m_cacheFileName);
+    QFile::rename(tempFileName, m_cacheFileName);
+}
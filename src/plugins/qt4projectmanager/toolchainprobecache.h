@@ -0,0 +1,112 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#ifndef TOOLCHAINPROBECACHE_H
+#define TOOLCHAINPROBECACHE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+
+QT_BEGIN_NAMESPACE
+class QProcess;
+QT_END_NAMESPACE
+
+namespace Qt4ProjectManager {
+namespace Internal {
+
+/*
+  Remembers the output of running compilers and qmake with a set of
+  arguments, e.g. the predefined macros of a compiler.
+
+  The output is stored on disk and used again as long as the program has
+  the same modification time and size. Unknown output is probed in the
+  background; probeFinished() is emitted once it is known. The output of
+  probes that crash, fail to start or exit with an error is only used for
+  the current session and never stored.
+*/
+class ToolchainProbeCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Output
+    {
+        QByteArray standardOutput;
+        QByteArray standardError;
+    };
+
+    ToolchainProbeCache(const QString &cacheFileName, QObject *parent = 0);
+    ~ToolchainProbeCache();
+
+    static ToolchainProbeCache *instance();
+
+    // Returns whether the output is known. If not, it is probed in the background.
+    bool output(const QString &program, const QStringList &arguments, Output *output);
+    // Returns the output, running the program right away if it is not known.
+    Output waitForOutput(const QString &program, const QStringList &arguments, int msecs);
+
+signals:
+    void probeFinished();
+
+private slots:
+    void processFinished();
+
+private:
+    struct Entry
+    {
+        Output output;
+        QDateTime lastModified;
+        qint64 size;
+    };
+
+    static QString key(const QString &program, const QStringList &arguments);
+    bool lookup(const QString &key, const QString &program, Output *output) const;
+    void insert(const QString &key, const QString &program, const Output &output);
+    void load();
+    void save() const;
+
+    QString m_cacheFileName;
+    QHash<QString, Entry> m_entries;
+    QHash<QString, Output> m_failedProbes;
+    QHash<QProcess *, QStringList> m_running; // the program and its arguments
+
+    static ToolchainProbeCache *m_instance;
+};
+
+} // namespace Internal
+} // namespace Qt4ProjectManager
+
+#endif // TOOLCHAINPROBECACHE_H
@@ -40,6 +40,11 @@
 using namespace Core;
 using namespace QuickOpen;
 
+enum {
+    // The best matches shown for an entry
+    MaxResults = 1000
+};
+
 BaseFileFilter::BaseFileFilter(ICore *core)
         : m_core(core),
           m_files(QStringList()),
@@ -48,43 +53,36 @@ BaseFileFilter::BaseFileFilter(ICore *core)
 {
 }
 
-QList<FilterEntry> BaseFileFilter::matchesFor(const QString &origEntry)
+QList<FilterEntry> BaseFileFilter::matchesFor(QFutureInterface<FilterEntry> &future,
+                                              const QString &origEntry)
 {
     QList<FilterEntry> value;
-    QString entry = trimWildcards(origEntry);
-    QStringMatcher matcher(entry, Qt::CaseInsensitive);
-    const QRegExp regexp("*"+entry+"*", Qt::CaseInsensitive, QRegExp::Wildcard);
-    if (!regexp.isValid())
+    const QString entry = trimWildcards(origEntry);
+    QMutexLocker locker(&m_searchLock);
+
+    // Names matching a longer entry are among those matching the previous one.
+    const bool narrow = !m_previousEntry.isEmpty() && !m_forceNewSearchList
+            && NameIndex::narrows(m_previousEntry, entry);
+    QVector<int> matching;
+    const QVector<NameIndex::Match> matches =
+            m_nameIndex.match(entry, MaxResults, narrow ? &m_previousMatches : 0, &matching,
+                              &future);
+
+    // the matches of a canceled search are incomplete, the next one can't narrow them.
+    if (future.isCanceled())
         return value;
-    bool hasWildcard = (entry.contains('*') || entry.contains('?'));
-    QStringList searchListPaths;
-    QStringList searchListNames;
-    if (!m_previousEntry.isEmpty() && !m_forceNewSearchList && entry.contains(m_previousEntry)) {
-        searchListPaths = m_previousResultPaths;
-        searchListNames = m_previousResultNames;
-    } else {
-        searchListPaths = m_files;
-        searchListNames = m_fileNames;
-    }
-    m_previousResultPaths.clear();
-    m_previousResultNames.clear();
+
+    m_previousMatches = matching;
     m_forceNewSearchList = false;
     m_previousEntry = entry;
-    QStringListIterator paths(searchListPaths);
-    QStringListIterator names(searchListNames);
-    while (paths.hasNext() && names.hasNext()) {
-        QString path = paths.next();
-        QString name = names.next();
-        if ((hasWildcard && regexp.exactMatch(name))
-                || (!hasWildcard && matcher.indexIn(name) != -1)) {
-            QFileInfo fi(path);
-            FilterEntry entry(this, fi.fileName(), path);
-            entry.extraInfo = QDir::toNativeSeparators(fi.path());
-            entry.resolveFileIcon = true;
-            value.append(entry);
-            m_previousResultPaths.append(path);
-            m_previousResultNames.append(name);
-        }
+
+    foreach (const NameIndex::Match &match, matches) {
+        const QString &path = m_searchFiles.at(match.index);
+        const QString &name = m_searchFileNames.at(match.index);
+        FilterEntry entry(this, name, path);
+        entry.extraInfo = QDir::toNativeSeparators(path.left(qMax(0, path.size() - name.size() - 1)));
+        entry.resolveFileIcon = true;
+        value.append(entry);
     }
     return value;
 }
@@ -102,5 +100,12 @@ void BaseFileFilter::generateFileNames()
         QFileInfo fi(fileName);
         m_fileNames.append(fi.fileName());
     }
+    NameIndex nameIndex;
+    nameIndex.setNames(m_fileNames);
+
+    QMutexLocker locker(&m_searchLock);
+    m_searchFiles = m_files;
+    m_searchFileNames = m_fileNames;
+    m_nameIndex = nameIndex;
     m_forceNewSearchList = true;
 }
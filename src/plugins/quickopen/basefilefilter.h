@@ -36,12 +36,14 @@
 
 #include "quickopen_global.h"
 #include "iquickopenfilter.h"
+#include "nameindex.h"
 
 #include <coreplugin/icore.h>
 
 #include <QtCore/QString>
 #include <QtCore/QList>
 #include <QtCore/QByteArray>
+#include <QtCore/QMutex>
 #include <QtGui/QWidget>
 
 namespace QuickOpen {
@@ -52,17 +54,25 @@ class QUICKOPEN_EXPORT BaseFileFilter : public QuickOpen::IQuickOpenFilter
 
 public:
     BaseFileFilter(Core::ICore *core);
-    QList<QuickOpen::FilterEntry> matchesFor(const QString &entry);
+    QList<QuickOpen::FilterEntry> matchesFor(QFutureInterface<QuickOpen::FilterEntry> &future,
+                                             const QString &entry);
     void accept(QuickOpen::FilterEntry selection) const;
 
 protected:
+    // Publishes m_files to matchesFor(), which can run on another thread.
     void generateFileNames();
 
     Core::ICore *m_core;
     QStringList m_files;
     QStringList m_fileNames;
-    QStringList m_previousResultPaths;
-    QStringList m_previousResultNames;
+
+private:
+    // What matchesFor() works on, guarded by m_searchLock.
+    QMutex m_searchLock;
+    QStringList m_searchFiles;
+    QStringList m_searchFileNames;
+    NameIndex m_nameIndex;
+    QVector<int> m_previousMatches;
     bool m_forceNewSearchList;
     QString m_previousEntry;
 };
@@ -34,7 +34,6 @@
 #include "directoryfilter.h"
 
 #include <QtCore/QDir>
-#include <QtCore/QStack>
 #include <QtGui/QDirModel>
 #include <QtGui/QCompleter>
 #include <QtGui/QFileDialog>
@@ -51,6 +50,7 @@ DirectoryFilter::DirectoryFilter(ICore *core)
           m_filters(QStringList() << "*.h" << "*.cpp" << "*.ui" << "*.qrc")
 {
     setIncludedByDefault(true);
+    m_crawler.setIgnoredDirectories(Core::Utils::DirectoryCrawler::defaultIgnoredDirectories());
 }
 
 QByteArray DirectoryFilter::saveState() const
@@ -187,73 +187,28 @@ void DirectoryFilter::refresh(QFutureInterface<void> &future)
 {
     const int MAX = 360;
     future.setProgressRange(0, MAX);
-    if (m_directories.count() < 1) {
+    QStringList directories;
+    {
+        QMutexLocker locker(&m_lock);
+        directories = m_directories;
+        m_crawler.setNameFilters(m_filters);
+    }
+    if (directories.isEmpty()) {
         QMutexLocker locker(&m_lock);
         m_files.clear();
         generateFileNames();
         future.setProgressValueAndText(MAX, tr("%1 filter update: 0 files").arg(m_name));
         return;
     }
-    int progress = 0;
-    int MAX_PER = MAX;
-    QStringList files;
-    QStack<QDir> dirs;
-    QStack<int> progressValues;
-    QStack<bool> processedValues;
-    { // initialize
-        QMutexLocker locker(&m_lock);
-        MAX_PER = MAX/m_directories.count();
-        foreach (const QString &directoryEntry, m_directories) {
-            if (!directoryEntry.isEmpty()) {
-                dirs.push(QDir(directoryEntry));
-                progressValues.push(MAX_PER);
-                processedValues.push(false);
-            }
-        }
-    }
-    while (!dirs.isEmpty() && !future.isCanceled()) {
-        if (future.isProgressUpdateNeeded()) {
-            future.setProgressValueAndText(progress, tr("%1 filter update: %2 files").arg(m_name).arg(files.size()));
-        }
-        QDir dir = dirs.pop();
-        int dirProgressMax = progressValues.pop();
-        bool processed = processedValues.pop();
-        if (dir.exists()) {
-            QStringList subDirs;
-            if (!processed) {
-                subDirs = dir.entryList(QDir::Dirs|QDir::Hidden|QDir::NoDotAndDotDot,
-                    QDir::Name|QDir::IgnoreCase|QDir::LocaleAware);
-            }
-            if (subDirs.isEmpty()) {
-                QStringList fileEntries = dir.entryList(m_filters,
-                    QDir::Files|QDir::Hidden,
-                    QDir::Name|QDir::IgnoreCase|QDir::LocaleAware);
-                foreach (const QString &file, fileEntries)
-                    files.append(dir.path()+"/"+file);
-                progress += dirProgressMax;
-            } else {
-                int subProgress = dirProgressMax/(subDirs.size()+1);
-                int selfProgress = subProgress + dirProgressMax%(subDirs.size()+1);
-                dirs.push(dir);
-                progressValues.push(selfProgress);
-                processedValues.push(true);
-                foreach (const QString &directory, subDirs) {
-                    dirs.push(QDir(dir.path()+"/"+directory));
-                    progressValues.push(subProgress);
-                    processedValues.push(false);
-                }
-            }
-        } else {
-            progress += dirProgressMax;
-        }
-    }
+
+    const QStringList files = m_crawler.files(directories, &future);
 
     if (!future.isCanceled()) {
         QMutexLocker locker(&m_lock);
         m_files = files;
         generateFileNames();
-        future.setProgressValue(MAX);
+        future.setProgressValueAndText(MAX, tr("%1 filter update: %2 files").arg(m_name).arg(files.size()));
     } else {
-        future.setProgressValueAndText(progress, tr("%1 filter update: canceled").arg(m_name));
+        future.setProgressValueAndText(0, tr("%1 filter update: canceled").arg(m_name));
     }
 }
@@ -46,6 +46,7 @@
 #include <QtGui/QDialog>
 
 #include <coreplugin/icore.h>
+#include <utils/directorycrawler.h>
 #include <qtconcurrent/QtConcurrentTools>
 
 namespace QuickOpen {
@@ -80,6 +81,8 @@ private:
     QDialog *m_dialog;
     Ui::DirectoryFilterOptions m_ui;
     mutable QMutex m_lock;
+    // Remembers the directories between refreshes, only changed ones are read again
+    Core::Utils::DirectoryCrawler m_crawler;
 };
 
 } // namespace Internal
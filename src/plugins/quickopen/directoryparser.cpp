@@ -39,6 +39,7 @@ using namespace QuickOpen::Internal;
 DirectoryParser::DirectoryParser(QObject *parent)
 	: QThread(parent)
 {
+    m_crawler.setIncludeHidden(false);
 }
 
 DirectoryParser::~DirectoryParser()
@@ -76,30 +77,8 @@ QSet<QString> DirectoryParser::files() const
 
 void DirectoryParser::run()
 {
-    m_files.clear();
-    m_runFiles.clear();
-    foreach (QString s, m_dirs) {
-        if (s.isEmpty())
-            continue;
-        QDir dir(s);
-        if (dir.exists()) {
-            m_runFilters = m_filters;
-            m_runBlackList = m_blackList;
-            collectFiles(dir);
-        }
-    }
-    m_files = m_runFiles;
+    m_crawler.setNameFilters(m_filters);
+    m_crawler.setIgnoredDirectories(m_blackList.toList());
+    m_files = m_crawler.files(m_dirs).toSet();
     emit directoriesParsed();
 }
-
-void DirectoryParser::collectFiles(const QDir &dir)
-{
-    QString dirName = dir.absolutePath() + QLatin1String("/");
-    foreach (QString f, dir.entryList(m_runFilters, QDir::Files)) {
-        m_runFiles.insert(dirName + f);
-    }
-    foreach (QString d, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
-        if (!m_runBlackList.contains(d))
-            collectFiles(dir.absolutePath() + QDir::separator() + d);
-    }
-}
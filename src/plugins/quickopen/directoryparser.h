@@ -38,6 +38,8 @@
 #include <QtCore/QDir>
 #include <QtCore/QSet>
 
+#include <utils/directorycrawler.h>
+
 namespace QuickOpen {
 namespace Internal {
 
@@ -60,16 +62,13 @@ signals:
 
 private:
     void run();
-    void collectFiles(const QDir &dir);
 
     QStringList m_dirs;
     QSet<QString> m_files;
 
-    QSet<QString> m_runFiles;
     QStringList m_filters;
-    QStringList m_runFilters;
     QSet<QString> m_blackList;
-    QSet<QString> m_runBlackList;
+    Core::Utils::DirectoryCrawler m_crawler;
 };
 
 } // namespace Internal
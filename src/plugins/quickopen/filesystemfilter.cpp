@@ -47,7 +47,8 @@ FileSystemFilter::FileSystemFilter(EditorManager *editorManager, QuickOpenToolWi
     setIncludedByDefault(false);
 }
 
-QList<FilterEntry> FileSystemFilter::matchesFor(const QString &entry)
+QList<FilterEntry> FileSystemFilter::matchesFor(QFutureInterface<FilterEntry> &future,
+                                                const QString &entry)
 {
     QList<FilterEntry> value;
     QFileInfo entryInfo(entry);
@@ -77,6 +78,8 @@ QList<FilterEntry> FileSystemFilter::matchesFor(const QString &entry)
     QStringList files = dirInfo.entryList(fileFilter,
                                       QDir::Name|QDir::IgnoreCase|QDir::LocaleAware);
     foreach (const QString &dir, dirs) {
+        if (future.isCanceled())
+            break;
         if (dir != "." && (name.isEmpty() || dir.startsWith(name, Qt::CaseInsensitive))) {
             FilterEntry entry(this, dir, directory + "/" + dir);
             entry.resolveFileIcon = true;
@@ -84,6 +87,8 @@ QList<FilterEntry> FileSystemFilter::matchesFor(const QString &entry)
         }
     }
     foreach (const QString &file, files) {
+        if (future.isCanceled())
+            break;
         if (name.isEmpty() || file.startsWith(name, Qt::CaseInsensitive)) {
             const QString fullPath = directory + "/" + file;
             FilterEntry entry(this, file, fullPath);
@@ -59,7 +59,9 @@ public:
     QString trName() const { return tr("Files in file system"); }
     QString name() const { return "Files in file system"; }
     QuickOpen::IQuickOpenFilter::Priority priority() const { return QuickOpen::IQuickOpenFilter::Medium; }
-    QList<QuickOpen::FilterEntry> matchesFor(const QString &entry);
+    QList<QuickOpen::FilterEntry> matchesFor(QFutureInterface<QuickOpen::FilterEntry> &future,
+                                             const QString &entry);
+    bool isThreadSafe() const { return false; }
     void accept(QuickOpen::FilterEntry selection) const;
     QByteArray saveState() const;
     bool restoreState(const QByteArray &state);
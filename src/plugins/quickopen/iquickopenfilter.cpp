@@ -59,6 +59,11 @@ void IQuickOpenFilter::setShortcutString(const QString &shortcut)
     m_shortcut = shortcut;
 }
 
+bool IQuickOpenFilter::isThreadSafe() const
+{
+    return true;
+}
+
 QByteArray IQuickOpenFilter::saveState() const
 {
     QByteArray value;
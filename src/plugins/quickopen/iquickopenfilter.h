@@ -99,8 +99,16 @@ public:
     /* String to type to use this filter exclusively. */
     QString shortcutString() const;
 
-    /* List of matches for the given user entry. */
-    virtual QList<FilterEntry> matchesFor(const QString &entry) = 0;
+    /* List of matches for the given user entry. Long running filters should
+     * check future.isCanceled() while matching and return early. */
+    virtual QList<FilterEntry> matchesFor(QFutureInterface<FilterEntry> &future,
+                                          const QString &entry) = 0;
+
+    /* Whether matchesFor() may be called from a thread other than the GUI thread.
+     * It is never called for two entries at the same time. Filters that access
+     * GUI objects, or data that is changed on the GUI thread without locking,
+     * have to return false. The default implementation returns true. */
+    virtual bool isThreadSafe() const;
 
     /* User has selected the given entry that belongs to this filter. */
     virtual void accept(FilterEntry selection) const = 0;
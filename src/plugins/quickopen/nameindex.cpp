@@ -0,0 +1,347 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "nameindex.h"
+
+#include <QtCore/QList>
+#include <QtCore/QThread>
+#include <QtCore/QtConcurrentMap>
+
+#include <algorithm>
+
+#include <string.h>
+
+using namespace QuickOpen;
+
+enum {
+    // Lists longer than this are matched on all cores
+    ParallelThreshold = 100000,
+
+    ScoreMatch = 16,
+    BonusWordStart = 8,
+    BonusConsecutive = 4,
+    BonusFirstCharacter = 8,
+    PenaltyGapStart = 3,
+    PenaltyGapExtension = 1
+};
+
+namespace {
+
+// Orders matches best first: by score, then shorter names, then index.
+bool isBetter(const NameIndex::Match &a, const NameIndex::Match &b)
+{
+    if (a.score != b.score)
+        return a.score > b.score;
+    if (a.length != b.length)
+        return a.length < b.length;
+    return a.index < b.index;
+}
+
+// Keeps the best maxResults matches in a heap with the worst on top.
+void addMatch(QVector<NameIndex::Match> *best, const NameIndex::Match &match, int maxResults)
+{
+    if (best->size() < maxResults) {
+        best->append(match);
+        std::push_heap(best->begin(), best->end(), isBetter);
+    } else if (isBetter(match, best->first())) {
+        std::pop_heap(best->begin(), best->end(), isBetter);
+        best->last() = match;
+        std::push_heap(best->begin(), best->end(), isBetter);
+    }
+}
+
+inline bool isSeparator(QChar c)
+{
+    return c == QLatin1Char('/') || c == QLatin1Char('\\') || c == QLatin1Char('_')
+            || c == QLatin1Char('-') || c == QLatin1Char('.') || c == QLatin1Char(' ')
+            || c == QLatin1Char(':');
+}
+
+// Returns the length of the UTF-8 sequence at pos, cut short at size.
+inline int characterLength(const char *data, int pos, int size)
+{
+    const uchar lead = data[pos];
+    const int length = lead < 0xc0 ? 1 : lead < 0xe0 ? 2 : lead < 0xf0 ? 3 : 4;
+    return qMin(length, size - pos);
+}
+
+// Returns the start of the UTF-8 sequence before pos.
+inline int previousCharacter(const char *data, int pos)
+{
+    do {
+        --pos;
+    } while (pos > 0 && (uchar(data[pos]) & 0xc0) == 0x80);
+    return pos;
+}
+
+// Returns whether the pattern character p matches the character c; '?'
+// matches any character, whatever the length of its sequence.
+inline bool matchesCharacter(const char *p, int pLength, const char *c, int cLength)
+{
+    return *p == '?' || (pLength == cLength && ! memcmp(p, c, cLength));
+}
+
+QByteArray normalizedPattern(const QString &entry)
+{
+    QString pattern = entry.toLower();
+    pattern.remove(QLatin1Char('*'));
+    return pattern.toUtf8();
+}
+
+struct ChunkResult
+{
+    QVector<NameIndex::Match> best;
+    QVector<int> matching;
+};
+
+} // anonymous namespace
+
+namespace QuickOpen {
+
+// Matches the names or candidates from begin to end.
+class NameIndexChunk
+{
+public:
+    ChunkResult run() const
+    {
+        ChunkResult result;
+        for (int i = begin; i < end; ++i) {
+            if (future && ((i - begin) & 1023) == 0 && future->isCanceled())
+                break;
+
+            NameIndex::Match match;
+            match.index = candidates ? candidates->at(i) : i;
+            match.score = index->score(match.index, pattern);
+            if (match.score < 0)
+                continue;
+            match.length = index->m_offsets.at(match.index + 1) - index->m_offsets.at(match.index);
+            addMatch(&result.best, match, maxResults);
+            if (collectMatching)
+                result.matching.append(match.index);
+        }
+        return result;
+    }
+
+    const NameIndex *index;
+    QByteArray pattern;
+    int maxResults;
+    const QVector<int> *candidates;
+    const QFutureInterfaceBase *future;
+    bool collectMatching;
+    int begin;
+    int end;
+};
+
+} // namespace QuickOpen
+
+NameIndex::NameIndex()
+{
+    m_offsets.append(0);
+}
+
+void NameIndex::setNames(const QStringList &names)
+{
+    m_names.clear();
+    m_wordStarts.clear();
+    m_offsets.clear();
+    m_offsets.reserve(names.size() + 1);
+    m_offsets.append(0);
+
+    foreach (const QString &name, names) {
+        const QString lower = name.toLower();
+        const QByteArray utf8 = lower.toUtf8();
+        QByteArray wordStarts(utf8.size(), 0);
+
+        // Mark the bytes of characters that follow a separator or start
+        // a camel case hump.
+        int pos = 0;
+        for (int i = 0; i < lower.size() && lower.size() == name.size(); ++i) {
+            const QChar c = name.at(i);
+            const bool wordStart = i == 0 || isSeparator(name.at(i - 1))
+                    || (c.isUpper() && name.at(i - 1).isLower());
+            if (wordStart && pos < wordStarts.size())
+                wordStarts[pos] = 1;
+
+            const ushort u = lower.at(i).unicode();
+            if (u < 0x80)
+                pos += 1;
+            else if (u < 0x800)
+                pos += 2;
+            else if (QChar(u).isHighSurrogate())
+                pos += 4;
+            else if (! QChar(u).isLowSurrogate())
+                pos += 3;
+        }
+        if (pos != utf8.size()) {
+            wordStarts.fill(0);
+            if (! wordStarts.isEmpty())
+                wordStarts[0] = 1;
+        }
+
+        m_names += utf8;
+        m_wordStarts += wordStarts;
+        m_offsets.append(m_names.size());
+    }
+}
+
+int NameIndex::count() const
+{
+    return m_offsets.size() - 1;
+}
+
+// Returns -1 if the name at index does not match pattern. Otherwise
+// scores the shortest window of the name that contains the pattern.
+int NameIndex::score(int index, const QByteArray &pattern) const
+{
+    const char *name = m_names.constData() + m_offsets.at(index);
+    const char *wordStarts = m_wordStarts.constData() + m_offsets.at(index);
+    const int length = m_offsets.at(index + 1) - m_offsets.at(index);
+    const char *p = pattern.constData();
+    const int patternLength = pattern.size();
+
+    if (! patternLength)
+        return 0;
+
+    // find where the first match ends
+    int matched = 0;
+    int end = 0;
+    while (end < length && matched < patternLength) {
+        const int n = characterLength(name, end, length);
+        const int m = characterLength(p, matched, patternLength);
+        if (matchesCharacter(p + matched, m, name + end, n))
+            matched += m;
+        end += n;
+    }
+    if (matched < patternLength)
+        return -1;
+
+    // and walk back to the last possible start
+    int start = end;
+    while (matched > 0) {
+        start = previousCharacter(name, start);
+        const int previous = previousCharacter(p, matched);
+        if (matchesCharacter(p + previous, matched - previous,
+                             name + start, characterLength(name, start, length)))
+            matched = previous;
+    }
+
+    int score = 0;
+    bool consecutive = false;
+    for (int i = start; i < end && matched < patternLength; ) {
+        const int n = characterLength(name, i, length);
+        const int m = characterLength(p, matched, patternLength);
+        if (matchesCharacter(p + matched, m, name + i, n)) {
+            score += ScoreMatch;
+            if (wordStarts[i])
+                score += BonusWordStart;
+            if (consecutive)
+                score += BonusConsecutive;
+            if (i == 0)
+                score += BonusFirstCharacter;
+            consecutive = true;
+            matched += m;
+        } else {
+            score -= consecutive ? PenaltyGapStart : PenaltyGapExtension;
+            consecutive = false;
+        }
+        i += n;
+    }
+    return qMax(score, 0);
+}
+
+QVector<NameIndex::Match> NameIndex::match(const QString &entry, int maxResults,
+                                           const QVector<int> *candidates,
+                                           QVector<int> *matching,
+                                           const QFutureInterfaceBase *future) const
+{
+    NameIndexChunk chunk;
+    chunk.index = this;
+    chunk.pattern = normalizedPattern(entry);
+    chunk.maxResults = maxResults;
+    chunk.candidates = candidates;
+    chunk.future = future;
+    chunk.collectMatching = matching != 0;
+
+    const int total = candidates ? candidates->size() : count();
+    const int chunkCount = (total > ParallelThreshold) ? QThread::idealThreadCount() : 1;
+
+    // The chunks are split up front and the calling thread matches them
+    // too, it usually is a pool thread itself and must not wait for others.
+    QList<NameIndexChunk> chunks;
+    for (int i = 0; i < chunkCount; ++i) {
+        chunk.begin = qint64(total) * i / chunkCount;
+        chunk.end = qint64(total) * (i + 1) / chunkCount;
+        chunks.append(chunk);
+    }
+    const QList<ChunkResult> results = (chunkCount == 1)
+            ? QList<ChunkResult>() << chunk.run()
+            : QtConcurrent::blockingMapped<QList<ChunkResult> >(chunks, &NameIndexChunk::run);
+
+    // the results are in chunk order, so the matching indexes stay sorted
+    ChunkResult result = results.first();
+    for (int i = 1; i < results.size(); ++i) {
+        const ChunkResult &other = results.at(i);
+        foreach (const Match &match, other.best)
+            addMatch(&result.best, match, maxResults);
+        if (matching)
+            result.matching += other.matching;
+    }
+
+    if (matching)
+        *matching = result.matching;
+    std::sort(result.best.begin(), result.best.end(), isBetter);
+    return result.best;
+}
+
+bool NameIndex::narrows(const QString &previousEntry, const QString &entry)
+{
+    const QByteArray previous = normalizedPattern(previousEntry);
+    const QByteArray current = normalizedPattern(entry);
+
+    // every character of previous has to be matched by entry in order
+    int pos = 0;
+    for (int i = 0; i < previous.size(); ) {
+        const int m = characterLength(previous.constData(), i, previous.size());
+        int n = 0;
+        for (; pos < current.size(); pos += n) {
+            n = characterLength(current.constData(), pos, current.size());
+            if (matchesCharacter(previous.constData() + i, m, current.constData() + pos, n))
+                break;
+        }
+        if (pos == current.size())
+            return false;
+        pos += n;
+        i += m;
+    }
+    return true;
+}
@@ -0,0 +1,94 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include "quickopen_global.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+namespace QuickOpen {
+
+/* NameIndex: Fuzzy matches a user entry against a large list of names.
+ *
+ * The names are kept lower case and UTF-8 encoded in one buffer, with
+ * the offsets of each name and a mark for the bytes that start a word.
+ * A name matches if it contains the characters of the entry in order;
+ * '?' matches any character. Matches are scored like fzf does: matched
+ * characters at word starts and runs of consecutive characters score
+ * higher, gaps lower. */
+
+class QUICKOPEN_EXPORT NameIndex
+{
+public:
+    struct Match
+    {
+        int index;
+        int score;
+        int length;
+    };
+
+    NameIndex();
+
+    void setNames(const QStringList &names);
+    int count() const;
+
+    // Returns the best maxResults matches for entry, best first. Only the
+    // names in candidates are looked at, if given. All names that match
+    // are stored in matching, if given. Once future is canceled, matching
+    // stops and the results are incomplete.
+    QVector<Match> match(const QString &entry, int maxResults,
+                         const QVector<int> *candidates = 0,
+                         QVector<int> *matching = 0,
+                         const QFutureInterfaceBase *future = 0) const;
+
+    // Returns whether all names matching entry also match previousEntry.
+    static bool narrows(const QString &previousEntry, const QString &entry);
+
+private:
+    friend class NameIndexChunk;
+
+    int score(int index, const QByteArray &pattern) const;
+
+    QByteArray m_names;
+    QByteArray m_wordStarts;
+    QVector<int> m_offsets;
+};
+
+} // namespace QuickOpen
+
+#endif // NAMEINDEX_H
@@ -50,7 +50,8 @@ OpenDocumentsFilter::OpenDocumentsFilter(EditorManager *editorManager) :
     setIncludedByDefault(true);
 }
 
-QList<FilterEntry> OpenDocumentsFilter::matchesFor(const QString &entry)
+QList<FilterEntry> OpenDocumentsFilter::matchesFor(QFutureInterface<FilterEntry> &future,
+                                                   const QString &entry)
 {
     QList<FilterEntry> value;
     const QChar asterisk = QLatin1Char('*');
@@ -61,6 +62,8 @@ QList<FilterEntry> OpenDocumentsFilter::matchesFor(const QString &entry)
     if (!regexp.isValid())
         return value;
     foreach (IEditor *editor, m_editors) {
+        if (future.isCanceled())
+            break;
         QString fileName = editor->file()->fileName();
         if (regexp.exactMatch(editor->displayName())) {
             QString visibleName;
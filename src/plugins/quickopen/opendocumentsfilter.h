@@ -57,7 +57,9 @@ public:
     QString trName() const { return tr("Open documents"); }
     QString name() const { return "Open documents"; }
     QuickOpen::IQuickOpenFilter::Priority priority() const { return QuickOpen::IQuickOpenFilter::Medium; }
-    QList<QuickOpen::FilterEntry> matchesFor(const QString &entry);
+    QList<QuickOpen::FilterEntry> matchesFor(QFutureInterface<QuickOpen::FilterEntry> &future,
+                                             const QString &entry);
+    bool isThreadSafe() const { return false; }
     void accept(QuickOpen::FilterEntry selection) const;
     void refresh(QFutureInterface<void> &future);
 
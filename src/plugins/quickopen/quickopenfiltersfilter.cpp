@@ -67,8 +67,10 @@ IQuickOpenFilter::Priority QuickOpenFiltersFilter::priority() const
     return High;
 }
 
-QList<FilterEntry> QuickOpenFiltersFilter::matchesFor(const QString &entry)
+QList<FilterEntry> QuickOpenFiltersFilter::matchesFor(QFutureInterface<FilterEntry> &future,
+                                                      const QString &entry)
 {
+    Q_UNUSED(future);
     QList<FilterEntry> entries;
     if (entry.isEmpty()) {
         foreach (IQuickOpenFilter *filter, m_plugin->filter()) {
@@ -52,12 +52,14 @@ QT_END_NAMESPACE
 #include <coreplugin/fileiconprovider.h>
 #include <utils/fancylineedit.h>
 #include <utils/qtcassert.h>
+#include <qtconcurrent/runextensions.h>
 
 #include <QtCore/QFileInfo>
 #include <QtCore/QFile>
 #include <QtCore/QTimer>
 #include <QtCore/QRegExp>
 #include <QtCore/QSettings>
+#include <QtCore/QVector>
 #include <QtCore/QDebug>
 #include <QtGui/QAction>
 #include <QtGui/QApplication>
@@ -92,11 +94,13 @@ public:
     int columnCount(const QModelIndex &parent = QModelIndex()) const;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
 
-    void setEntries(const QList<FilterEntry> &entries);
+    void clear();
+    void addEntries(const QList<FilterEntry> &entries, int rank);
     //void setDisplayCount(int count);
 
 private:
     mutable QList<FilterEntry> mEntries;
+    QList<int> mRanks;
     //int mDisplayCount;
 };
 
@@ -174,11 +178,32 @@ QVariant QuickOpenModel::data(const QModelIndex &index, int role) const
     return QVariant();
 }
 
-void QuickOpenModel::setEntries(const QList<FilterEntry> &entries)
+void QuickOpenModel::clear()
 {
-    mEntries = entries;
+    mEntries.clear();
+    mRanks.clear();
     reset();
 }
+
+/*!
+ * Inserts the entries after all entries of the same or a better (lower) rank.
+ */
+void QuickOpenModel::addEntries(const QList<FilterEntry> &entries, int rank)
+{
+    if (entries.isEmpty())
+        return;
+
+    int row = mRanks.size();
+    while (row > 0 && mRanks.at(row - 1) > rank)
+        --row;
+
+    beginInsertRows(QModelIndex(), row, row + entries.size() - 1);
+    for (int i = 0; i < entries.size(); ++i) {
+        mEntries.insert(row + i, entries.at(i));
+        mRanks.insert(row + i, rank);
+    }
+    endInsertRows();
+}
 #if 0
 void QuickOpenModel::setDisplayCount(int count)
 {
@@ -252,6 +277,36 @@ void CompletionList::updatePreferredSize()
 
 // =========== QuickOpenToolWindow ===========
 
+namespace {
+
+/*!
+ * Runs the thread safe filters of a query, reporting the entries of each
+ * filter as one batch.
+ */
+void runFilters(QFutureInterface<FilterEntry> &future,
+                QList<IQuickOpenFilter *> filters,
+                QString searchText,
+                QSet<FilterEntry> alreadyAdded,
+                bool checkDuplicates)
+{
+    foreach (IQuickOpenFilter *filter, filters) {
+        if (future.isCanceled())
+            break;
+        QVector<FilterEntry> entries;
+        foreach (const FilterEntry &entry, filter->matchesFor(future, searchText)) {
+            if (checkDuplicates && alreadyAdded.contains(entry))
+                continue;
+            entries.append(entry);
+            if (checkDuplicates)
+                alreadyAdded.insert(entry);
+        }
+        if (!entries.isEmpty())
+            future.reportResults(entries);
+    }
+}
+
+} // anonymous namespace
+
 QuickOpenToolWindow::QuickOpenToolWindow(QuickOpenPlugin *qop) :
      m_quickOpenPlugin(qop),
      m_quickOpenModel(new QuickOpenModel(this)),
@@ -259,7 +314,9 @@ QuickOpenToolWindow::QuickOpenToolWindow(QuickOpenPlugin *qop) :
      m_filterMenu(new QMenu(this)),
      m_refreshAction(new QAction(tr("Refresh"), this)),
      m_configureAction(new QAction(tr("Configure..."), this)),
-     m_fileLineEdit(new Core::Utils::FancyLineEdit)
+     m_fileLineEdit(new Core::Utils::FancyLineEdit),
+     m_entriesWatcher(new QFutureWatcher<FilterEntry>(this)),
+     m_updateRequested(false)
 {
     // Explcitly hide the completion list popup.
     m_completionList->hide();
@@ -303,6 +360,17 @@ QuickOpenToolWindow::QuickOpenToolWindow(QuickOpenPlugin *qop) :
         this, SLOT(textEdited(const QString&)));
     connect(m_completionList, SIGNAL(activated(QModelIndex)),
             this, SLOT(acceptCurrentEntry()));
+    connect(m_entriesWatcher, SIGNAL(resultsReadyAt(int,int)),
+            this, SLOT(addEntries(int,int)));
+    connect(m_entriesWatcher, SIGNAL(finished()),
+            this, SLOT(queryFinished()));
+}
+
+QuickOpenToolWindow::~QuickOpenToolWindow()
+{
+    // the filters must not be queried after they are deleted
+    m_entriesWatcher->cancel();
+    m_entriesWatcher->waitForFinished();
 }
 
 bool QuickOpenToolWindow::isShowingTypeHereMessage() const
@@ -403,29 +471,87 @@ QList<IQuickOpenFilter*> QuickOpenToolWindow::filtersFor(const QString &text, QS
 
 void QuickOpenToolWindow::updateCompletionList(const QString &text)
 {
+    // A filter is never queried twice at the same time, so a stale query
+    // is canceled and the new one started when it returned.
+    if (m_entriesWatcher->isRunning()) {
+        m_entriesWatcher->cancel();
+        m_updateRequested = true;
+        m_requestedText = text;
+        return;
+    }
+
     QString searchText;
     const QList<IQuickOpenFilter*> filters = filtersFor(text, searchText);
     QSet<FilterEntry> alreadyAdded;
     const bool checkDuplicates = (filters.size() > 1);
-    QList<FilterEntry> entries;
-    foreach (IQuickOpenFilter *filter, filters) {
-        foreach (const FilterEntry &entry, filter->matchesFor(searchText)) {
+    QList<IQuickOpenFilter*> threadSafeFilters;
+    QFutureInterface<FilterEntry> guiThreadFuture; // never canceled
+    m_filterRanks.clear();
+    m_quickOpenModel->clear();
+
+    // The filters are ranked by their position in the list. Filters that
+    // are not thread safe are queried right here, the others in the background.
+    for (int rank = 0; rank < filters.size(); ++rank) {
+        IQuickOpenFilter *filter = filters.at(rank);
+        if (filter->isThreadSafe()) {
+            threadSafeFilters.append(filter);
+            m_filterRanks.insert(filter, rank);
+            continue;
+        }
+        QList<FilterEntry> entries;
+        foreach (const FilterEntry &entry, filter->matchesFor(guiThreadFuture, searchText)) {
             if (checkDuplicates && alreadyAdded.contains(entry))
                 continue;
             entries.append(entry);
             if (checkDuplicates)
                 alreadyAdded.insert(entry);
         }
+        m_quickOpenModel->addEntries(entries, rank);
     }
-    m_quickOpenModel->setEntries(entries);
-    if (m_quickOpenModel->rowCount() > 0) {
-        m_completionList->setCurrentIndex(m_quickOpenModel->index(0, 0));
+    selectFirstEntry();
+
+    if (!threadSafeFilters.isEmpty()) {
+        m_entriesWatcher->setFuture(QtConcurrent::run(runFilters, threadSafeFilters, searchText,
+                                                      alreadyAdded, checkDuplicates));
     }
 #if 0
     m_completionList->updatePreferredSize();
 #endif
 }
 
+void QuickOpenToolWindow::addEntries(int begin, int end)
+{
+    // results come in batches of one filter
+    const bool firstSelected = m_completionList->currentIndex().row() <= 0;
+    QList<FilterEntry> entries;
+    for (int i = begin; i < end; ++i) {
+        const FilterEntry entry = m_entriesWatcher->resultAt(i);
+        if (!entries.isEmpty() && entries.last().filter != entry.filter) {
+            m_quickOpenModel->addEntries(entries, m_filterRanks.value(entries.last().filter));
+            entries.clear();
+        }
+        entries.append(entry);
+    }
+    if (!entries.isEmpty())
+        m_quickOpenModel->addEntries(entries, m_filterRanks.value(entries.last().filter));
+    if (firstSelected)
+        selectFirstEntry();
+}
+
+void QuickOpenToolWindow::queryFinished()
+{
+    if (m_updateRequested) {
+        m_updateRequested = false;
+        updateCompletionList(m_requestedText);
+    }
+}
+
+void QuickOpenToolWindow::selectFirstEntry()
+{
+    if (m_quickOpenModel->rowCount() > 0)
+        m_completionList->setCurrentIndex(m_quickOpenModel->index(0, 0));
+}
+
 void QuickOpenToolWindow::acceptCurrentEntry()
 {
     if (!m_completionList->isVisible())
@@ -37,6 +37,8 @@
 #include "quickopenplugin.h"
 
 #include <QtCore/QEvent>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QHash>
 #include <QtGui/QWidget>
 
 QT_BEGIN_NAMESPACE
@@ -65,6 +67,7 @@ class QuickOpenToolWindow
 
 public:
     QuickOpenToolWindow(QuickOpenPlugin *qop);
+    ~QuickOpenToolWindow();
 
     void updateFilterList();
 
@@ -75,6 +78,8 @@ private slots:
     void acceptCurrentEntry();
     void filterSelected();
     void showConfigureDialog();
+    void addEntries(int begin, int end);
+    void queryFinished();
 
 private:
     bool eventFilter(QObject *obj, QEvent *event);
@@ -85,6 +90,7 @@ private:
     bool isShowingTypeHereMessage() const;
     void showCompletionList();
     void updateCompletionList(const QString &text);
+    void selectFirstEntry();
     QList<IQuickOpenFilter*> filtersFor(const QString &text, QString &searchText);
 
     QuickOpenPlugin *m_quickOpenPlugin;
@@ -95,6 +101,11 @@ private:
     QAction *m_refreshAction;
     QAction *m_configureAction;
     Core::Utils::FancyLineEdit *m_fileLineEdit;
+
+    QFutureWatcher<FilterEntry> *m_entriesWatcher;
+    QHash<IQuickOpenFilter*, int> m_filterRanks;
+    bool m_updateRequested;
+    QString m_requestedText;
 };
 
 } // namespace Internal
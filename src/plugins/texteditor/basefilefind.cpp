@@ -92,9 +92,9 @@ void BaseFileFind::findAll(const QString &txt, QTextDocument::FindFlags findFlag
     m_resultWindow->clearContents();
     m_resultWindow->popup(true);
     if (m_useRegExp)
-        m_watcher.setFuture(Core::Utils::findInFilesRegExp(txt, files(), findFlags));
+        m_watcher.setFuture(Core::Utils::findInFilesRegExp(txt, files(), findFlags, textIndex()));
     else
-        m_watcher.setFuture(Core::Utils::findInFiles(txt, files(), findFlags));
+        m_watcher.setFuture(Core::Utils::findInFiles(txt, files(), findFlags, textIndex()));
     Core::FutureProgress *progress = m_core->progressManager()->addTask(m_watcher.future(),
                                                                         "Search",
                                                                         Constants::TASK_SEARCH);
@@ -102,6 +102,11 @@ void BaseFileFind::findAll(const QString &txt, QTextDocument::FindFlags findFlag
     connect(progress, SIGNAL(clicked()), m_resultWindow, SLOT(popup()));
 }
 
+const Core::Utils::TrigramIndex *BaseFileFind::textIndex() const
+{
+    return 0;
+}
+
 void BaseFileFind::displayResult(int index) {
     Core::Utils::FileSearchResult result = m_watcher.future().resultAt(index);
     ResultWindowItem *item = m_resultWindow->addResult(result.fileName,
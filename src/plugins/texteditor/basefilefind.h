@@ -62,6 +62,7 @@ public:
 
 protected:
     virtual QStringList files() = 0;
+    virtual const Core::Utils::TrigramIndex *textIndex() const;
     void writeCommonSettings(QSettings *settings);
     void readCommonSettings(QSettings *settings, const QString &defaultFilter);
     QWidget *createPatternWidget();
@@ -34,7 +34,6 @@
 #include "findinfiles.h"
 
 #include <QtDebug>
-#include <QtCore/QDirIterator>
 #include <QtGui/QPushButton>
 #include <QtGui/QFileDialog>
 #include <QtGui/QVBoxLayout>
@@ -47,6 +46,9 @@ FindInFiles::FindInFiles(Core::ICore *core, SearchResultWindow *resultWindow)
     m_configWidget(0),
     m_directory(0)
 {
+    m_crawler.setIncludeHidden(false);
+    m_crawler.setReadableOnly(true);
+    m_crawler.setIgnoredDirectories(Core::Utils::DirectoryCrawler::defaultIgnoredDirectories());
 }
 
 QString FindInFiles::name() const
@@ -67,16 +69,8 @@ void FindInFiles::findAll(const QString &txt, QTextDocument::FindFlags findFlags
 
 QStringList FindInFiles::files()
 {
-    QStringList fileList;
-    QDirIterator it(m_directory->currentText(),
-                    fileNameFilters(),
-                    QDir::Files|QDir::Readable,
-                    QDirIterator::Subdirectories);
-    while (it.hasNext()) {
-        it.next();
-        fileList << it.filePath();
-    }
-    return fileList;
+    m_crawler.setNameFilters(fileNameFilters());
+    return m_crawler.files(QStringList(m_directory->currentText()));
 }
 
 QWidget *FindInFiles::createConfigWidget()
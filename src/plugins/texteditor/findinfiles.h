@@ -39,6 +39,7 @@
 #include <coreplugin/icore.h>
 #include <find/ifindfilter.h>
 #include <find/searchresultwindow.h>
+#include <utils/directorycrawler.h>
 
 #include <QtCore/QPointer>
 #include <QtGui/QLabel>
@@ -76,6 +77,7 @@ private:
     QString m_directorySetting;
     QPointer<QWidget> m_configWidget;
     QPointer<QComboBox> m_directory;
+    Core::Utils::DirectoryCrawler m_crawler;
 };
 
 } // namespace Internal
@@ -51,8 +51,10 @@ LineNumberFilter::LineNumberFilter(EditorManager *editorManager, QObject *parent
     setIncludedByDefault(true);
 }
 
-QList<FilterEntry> LineNumberFilter::matchesFor(const QString &entry)
+QList<FilterEntry> LineNumberFilter::matchesFor(QFutureInterface<FilterEntry> &future,
+                                                const QString &entry)
 {
+    Q_UNUSED(future);
     bool ok;
     QList<FilterEntry> value;
     int line = entry.toInt(&ok);
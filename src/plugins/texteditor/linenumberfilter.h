@@ -61,7 +61,9 @@ public:
     QString trName() const { return tr("Line in current document"); }
     QString name() const { return "Line in current document"; }
     QuickOpen::IQuickOpenFilter::Priority priority() const { return QuickOpen::IQuickOpenFilter::High; }
-    QList<QuickOpen::FilterEntry> matchesFor(const QString &entry);
+    QList<QuickOpen::FilterEntry> matchesFor(QFutureInterface<QuickOpen::FilterEntry> &future,
+                                             const QString &entry);
+    bool isThreadSafe() const { return false; }
     void accept(QuickOpen::FilterEntry selection) const;
     void refresh(QFutureInterface<void> &) {}
 
@@ -43,6 +43,9 @@ private slots:
     void while_condition_statement();
     void for_statement();
     void cpp_initializer_or_function_declaration();
+
+    // declarations
+    void skip_function_bodies();
 };
 
 void tst_AST::simple_name()
@@ -294,5 +297,35 @@ void tst_AST::cpp_initializer_or_function_declaration()
 }
 
 
+void tst_AST::skip_function_bodies()
+{
+    const QByteArray source("# 1 \"<stdin>\"\n"
+                            "void a()\n"
+                            "{ int x; }\n"
+                            "void b()\n"
+                            "{ int y; }\n");
+
+    StringLiteral *fileId = control.findOrInsertFileName("<stdin>");
+    QSharedPointer<TranslationUnit> unit(new TranslationUnit(&control, fileId));
+    unit->setSource(source.constData(), source.length());
+    unit->setSkipFunctionBody(true);
+    unit->setActiveLines(4, 4);
+    unit->parse();
+
+    AST *ast = unit->ast();
+    QVERIFY(ast != 0);
+    QVERIFY(ast->asTranslationUnit() != 0);
+
+    DeclarationAST *first = ast->asTranslationUnit()->declarations;
+    QVERIFY(first != 0);
+    QVERIFY(first->asFunctionDefinition() != 0);
+    QVERIFY(first->asFunctionDefinition()->function_body == 0);
+
+    DeclarationAST *second = first->next;
+    QVERIFY(second != 0);
+    QVERIFY(second->asFunctionDefinition() != 0);
+    QVERIFY(second->asFunctionDefinition()->function_body != 0);
+}
+
 QTEST_APPLESS_MAIN(tst_AST)
 #include "tst_ast.moc"
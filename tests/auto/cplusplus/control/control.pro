@@ -0,0 +1,5 @@
+load(qttest_p4)
+include(../shared/shared.pri)
+QT = core
+
+SOURCES += tst_control.cpp
@@ -0,0 +1,150 @@
+
+#include <QtTest>
+#include <QtDebug>
+
+#include <Control.h>
+#include <TranslationUnit.h>
+#include <AST.h>
+#include <Semantic.h>
+#include <Scope.h>
+#include <Symbols.h>
+#include <CoreTypes.h>
+#include <Names.h>
+#include <Literals.h>
+#include <DiagnosticClient.h>
+
+CPLUSPLUS_USE_NAMESPACE
+
+// Set CPLUSPLUS_BENCHMARK_SOURCE to a preprocessed file (e.g. the output of
+// "g++ -E" on <QtGui>) to benchmark with real code instead of generated code.
+static QByteArray benchmarkSource()
+{
+    const QByteArray fileName = qgetenv("CPLUSPLUS_BENCHMARK_SOURCE");
+    if (! fileName.isEmpty()) {
+        QFile file(QString::fromLocal8Bit(fileName));
+        if (file.open(QFile::ReadOnly))
+            return file.readAll();
+    }
+
+    QByteArray source;
+    for (int i = 0; i < 5000; ++i) {
+        const QByteArray n = QByteArray::number(i);
+        source += "namespace N" + QByteArray::number(i % 50) + " {\n"
+                  "class C" + n + ";\n"
+                  "template <typename T> class L" + QByteArray::number(i % 100) + ";\n"
+                  "const C" + n + " *f" + n + "(const C" + n + " &c, L<int> *l, "
+                  "N" + QByteArray::number(i % 50) + "::C" + n + " **p, char a[4]);\n"
+                  "}\n";
+    }
+    return source;
+}
+
+class tst_Control: public QObject
+{
+    Q_OBJECT
+
+    class Diagnostic: public DiagnosticClient {
+    public:
+        virtual void report(int, StringLiteral *,
+                            unsigned, unsigned,
+                            const char *, va_list)
+        { }
+    };
+
+    Diagnostic diag;
+
+private slots:
+    void names();
+    void types();
+
+    // benchmarks
+    void interning();
+    void parseAndCheck();
+};
+
+void tst_Control::names()
+{
+    Control control;
+    Identifier *foo = control.findOrInsertIdentifier("foo");
+    Identifier *bar = control.findOrInsertIdentifier("bar");
+
+    QCOMPARE(control.nameId(foo), control.nameId(foo));
+    QVERIFY(control.nameId(foo) != control.nameId(bar));
+    QCOMPARE(control.destructorNameId(foo), control.destructorNameId(foo));
+    QVERIFY(control.destructorNameId(foo) != control.destructorNameId(bar));
+
+    Name *names[] = { control.nameId(foo), control.nameId(bar) };
+    QCOMPARE(control.qualifiedNameId(names, 2), control.qualifiedNameId(names, 2));
+    QVERIFY(control.qualifiedNameId(names, 2) != control.qualifiedNameId(names, 2, true));
+    QVERIFY(control.qualifiedNameId(names, 2) != control.qualifiedNameId(names, 1));
+
+    FullySpecifiedType args[] = { control.integerType(IntegerType::Int) };
+    QCOMPARE(control.templateNameId(foo, args, 1), control.templateNameId(foo, args, 1));
+    QVERIFY(control.templateNameId(foo, args, 1) != control.templateNameId(foo));
+    QVERIFY(control.templateNameId(foo, args, 1) != control.templateNameId(bar, args, 1));
+}
+
+void tst_Control::types()
+{
+    Control control;
+    FullySpecifiedType intTy(control.integerType(IntegerType::Int));
+    FullySpecifiedType constIntTy = intTy;
+    constIntTy.setConst(true);
+
+    QCOMPARE(control.integerType(IntegerType::Int), control.integerType(IntegerType::Int));
+    QVERIFY(control.integerType(IntegerType::Int) != control.integerType(IntegerType::Long));
+    QCOMPARE(control.pointerType(intTy), control.pointerType(intTy));
+    QVERIFY(control.pointerType(intTy) != control.pointerType(constIntTy));
+    QCOMPARE(control.referenceType(intTy), control.referenceType(intTy));
+    QCOMPARE(control.arrayType(intTy, 4), control.arrayType(intTy, 4));
+    QVERIFY(control.arrayType(intTy, 4) != control.arrayType(intTy, 8));
+
+    Name *name = control.nameId(control.findOrInsertIdentifier("QString"));
+    QCOMPARE(control.namedType(name), control.namedType(name));
+    QCOMPARE(control.pointerToMemberType(name, intTy), control.pointerToMemberType(name, intTy));
+}
+
+void tst_Control::interning()
+{
+    Control control;
+    QList<Identifier *> ids;
+    for (int i = 0; i < 20000; ++i) {
+        const QByteArray id = "id" + QByteArray::number(i);
+        ids.append(control.findOrInsertIdentifier(id.constData(), id.size()));
+    }
+
+    QBENCHMARK {
+        foreach (Identifier *id, ids) {
+            Name *name = control.nameId(id);
+            FullySpecifiedType namedTy(control.namedType(name));
+            FullySpecifiedType ptrTy(control.pointerType(namedTy));
+            control.referenceType(ptrTy);
+            Name *names[] = { name, name };
+            control.qualifiedNameId(names, 2);
+            control.templateNameId(id, &namedTy, 1);
+        }
+    }
+}
+
+void tst_Control::parseAndCheck()
+{
+    const QByteArray source = benchmarkSource();
+
+    QBENCHMARK {
+        Control control;
+        control.setDiagnosticClient(&diag);
+        StringLiteral *fileId = control.findOrInsertFileName("<benchmark>");
+        TranslationUnit unit(&control, fileId);
+        unit.setSource(source.constData(), source.size());
+        unit.parse();
+
+        Semantic semantic(&control);
+        Namespace *globalNamespace = control.newNamespace(0);
+        TranslationUnitAST *ast = unit.ast() ? unit.ast()->asTranslationUnit() : 0;
+        for (DeclarationAST *decl = ast ? ast->declarations : 0; decl; decl = decl->next)
+            semantic.check(decl, globalNamespace->members());
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_Control)
+#include "tst_control.moc"
@@ -0,0 +1,9 @@
+load(qttest_p4)
+QT = core
+
+DEFINES += QWORKBENCH_UTILS_LIBRARY
+
+SOURCES += tst_directorycrawler.cpp \
+    ../../../src/libs/utils/directorycrawler.cpp
+
+HEADERS += ../../../src/libs/utils/directorycrawler.h
@@ -0,0 +1,281 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include "../../../src/libs/utils/directorycrawler.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFutureInterface>
+#include <QtTest/QtTest>
+
+#ifdef Q_OS_UNIX
+#  include <sys/stat.h>
+#  include <utime.h>
+#endif
+
+using namespace Core::Utils;
+
+class tst_DirectoryCrawler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void files();
+    void nameFilters();
+    void ignoredDirectories();
+    void hiddenFiles();
+    void symbolicLinks();
+    void modifiedDirectories();
+    void progress();
+    void canceled();
+
+private:
+    QString path(const QString &relativePath) const;
+    void createFile(const QString &relativePath);
+    QStringList allFiles() const;
+
+    QString m_root;
+};
+
+static void removeDirectory(const QString &path)
+{
+    QDir dir(path);
+    const QDir::Filters filters = QDir::AllEntries | QDir::Hidden | QDir::System
+                                  | QDir::NoDotAndDotDot;
+    foreach (const QFileInfo &info, dir.entryInfoList(filters)) {
+        if (info.isDir() && !info.isSymLink())
+            removeDirectory(info.filePath());
+        else
+            QFile::remove(info.filePath());
+    }
+    dir.rmdir(path);
+}
+
+QString tst_DirectoryCrawler::path(const QString &relativePath) const
+{
+    return m_root + QLatin1Char('/') + relativePath;
+}
+
+void tst_DirectoryCrawler::createFile(const QString &relativePath)
+{
+    const QString fileName = path(relativePath);
+    QDir().mkpath(QFileInfo(fileName).path());
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::WriteOnly));
+}
+
+// The files created by init(), sorted.
+QStringList tst_DirectoryCrawler::allFiles() const
+{
+    return QStringList()
+            << path(QLatin1String(".hidden.h"))
+            << path(QLatin1String("a/a.cpp"))
+            << path(QLatin1String("a/a.h"))
+            << path(QLatin1String("a/b/b.cpp"))
+            << path(QLatin1String("a/b/c/c.txt"))
+            << path(QLatin1String("d/d.H"))
+            << path(QLatin1String("main.cpp"));
+}
+
+void tst_DirectoryCrawler::init()
+{
+    m_root = QDir::cleanPath(QDir::tempPath()) + QLatin1String("/tst_directorycrawler_")
+            + QString::number(QCoreApplication::applicationPid());
+    removeDirectory(m_root);
+
+    createFile(QLatin1String("main.cpp"));
+    createFile(QLatin1String(".hidden.h"));
+    createFile(QLatin1String("a/a.h"));
+    createFile(QLatin1String("a/a.cpp"));
+    createFile(QLatin1String("a/b/b.cpp"));
+    createFile(QLatin1String("a/b/c/c.txt"));
+    createFile(QLatin1String("d/d.H"));
+    createFile(QLatin1String(".git/objects/o.h"));
+}
+
+void tst_DirectoryCrawler::cleanup()
+{
+    removeDirectory(m_root);
+}
+
+void tst_DirectoryCrawler::files()
+{
+    DirectoryCrawler crawler;
+    crawler.setIgnoredDirectories(DirectoryCrawler::defaultIgnoredDirectories());
+    QCOMPARE(crawler.files(QStringList(m_root)), allFiles());
+
+    // a root given twice, or below another one, is crawled once.
+    QStringList roots;
+    roots << m_root << path(QLatin1String("a")) << m_root + QLatin1Char('/');
+    QCOMPARE(crawler.files(roots), allFiles());
+
+    QCOMPARE(crawler.files(QStringList(path(QLatin1String("missing")))), QStringList());
+}
+
+void tst_DirectoryCrawler::nameFilters()
+{
+    DirectoryCrawler crawler;
+    crawler.setIgnoredDirectories(DirectoryCrawler::defaultIgnoredDirectories());
+    crawler.setNameFilters(QStringList() << QLatin1String("*.h") << QLatin1String(" b* "));
+
+    const QStringList expected = QStringList()
+            << path(QLatin1String(".hidden.h"))
+            << path(QLatin1String("a/a.h"))
+            << path(QLatin1String("a/b/b.cpp"))
+            << path(QLatin1String("d/d.H"));
+    QCOMPARE(crawler.files(QStringList(m_root)), expected);
+}
+
+void tst_DirectoryCrawler::ignoredDirectories()
+{
+    DirectoryCrawler crawler;
+    QVERIFY(crawler.files(QStringList(m_root)).contains(path(QLatin1String(".git/objects/o.h"))));
+
+    crawler.setIgnoredDirectories(QStringList() << QLatin1String(".git") << QLatin1String("b"));
+    const QStringList files = crawler.files(QStringList(m_root));
+    QVERIFY(!files.contains(path(QLatin1String(".git/objects/o.h"))));
+    QVERIFY(!files.contains(path(QLatin1String("a/b/b.cpp"))));
+    QVERIFY(!files.contains(path(QLatin1String("a/b/c/c.txt"))));
+    QVERIFY(files.contains(path(QLatin1String("a/a.h"))));
+}
+
+void tst_DirectoryCrawler::hiddenFiles()
+{
+    DirectoryCrawler crawler;
+    crawler.setIncludeHidden(false);
+
+    QStringList expected = allFiles();
+    expected.removeAll(path(QLatin1String(".hidden.h")));
+    QCOMPARE(crawler.files(QStringList(m_root)), expected);
+
+    crawler.setIgnoredDirectories(DirectoryCrawler::defaultIgnoredDirectories());
+    crawler.setIncludeHidden(true);
+    QCOMPARE(crawler.files(QStringList(m_root)), allFiles());
+}
+
+void tst_DirectoryCrawler::symbolicLinks()
+{
+#ifdef Q_OS_UNIX
+    // a cycle back to the root, and a second way into a/b.
+    QVERIFY(QFile::link(m_root, path(QLatin1String("a/b/c/loop"))));
+    QVERIFY(QFile::link(path(QLatin1String("a/b")), path(QLatin1String("d/link"))));
+    // a link to a directory outside the tree is followed.
+    const QString outside = m_root + QLatin1String("_outside");
+    removeDirectory(outside);
+    QDir().mkpath(outside);
+    QFile file(outside + QLatin1String("/e.h"));
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.close();
+    QVERIFY(QFile::link(outside, path(QLatin1String("outside"))));
+
+    DirectoryCrawler crawler;
+    crawler.setIgnoredDirectories(DirectoryCrawler::defaultIgnoredDirectories());
+    const QStringList files = crawler.files(QStringList(m_root));
+    removeDirectory(outside);
+
+    // the files below a/b are found under their real path only.
+    QStringList expected = allFiles();
+    expected.append(path(QLatin1String("outside/e.h")));
+    expected.sort();
+    QCOMPARE(files, expected);
+#else
+    QSKIP("Symbolic links are only created on Unix.", SkipAll);
+#endif
+}
+
+void tst_DirectoryCrawler::modifiedDirectories()
+{
+#ifdef Q_OS_UNIX
+    const QByteArray directory = QFile::encodeName(path(QLatin1String("a/b")));
+
+    // directories modified in the last second are not remembered, so the
+    // time stamps are moved back a bit.
+    struct utimbuf past;
+    past.actime = past.modtime = ::time(0) - 10;
+    QCOMPARE(::utime(directory.constData(), &past), 0);
+
+    DirectoryCrawler crawler;
+    crawler.setIgnoredDirectories(DirectoryCrawler::defaultIgnoredDirectories());
+    QCOMPARE(crawler.files(QStringList(m_root)), allFiles());
+
+    // The entries of an unchanged directory are reused: a file added
+    // behind the crawler's back is not seen while the time stamp stays.
+    createFile(QLatin1String("a/b/new.cpp"));
+    QCOMPARE(::utime(directory.constData(), &past), 0);
+    QCOMPARE(crawler.files(QStringList(m_root)), allFiles());
+
+    // once the directory's time stamp changes it is read again.
+    past.actime = past.modtime = ::time(0) - 5;
+    QCOMPARE(::utime(directory.constData(), &past), 0);
+    QStringList expected = allFiles();
+    expected.append(path(QLatin1String("a/b/new.cpp")));
+    expected.sort();
+    QCOMPARE(crawler.files(QStringList(m_root)), expected);
+
+    // and a directory that went away is dropped.
+    removeDirectory(path(QLatin1String("a/b/c")));
+    expected.removeAll(path(QLatin1String("a/b/c/c.txt")));
+    QCOMPARE(crawler.files(QStringList(m_root)), expected);
+#else
+    QSKIP("The time stamps are only set on Unix.", SkipAll);
+#endif
+}
+
+void tst_DirectoryCrawler::progress()
+{
+    QFutureInterface<void> future;
+    future.setProgressRange(0, 360);
+
+    DirectoryCrawler crawler;
+    QVERIFY(!crawler.files(QStringList(m_root), &future).isEmpty());
+    QCOMPARE(future.progressValue(), 360);
+}
+
+void tst_DirectoryCrawler::canceled()
+{
+    QFutureInterface<void> future;
+    future.cancel();
+
+    DirectoryCrawler crawler;
+    QCOMPARE(crawler.files(QStringList(m_root), &future), QStringList());
+
+    // a canceled crawl does not replace what the crawler remembers.
+    QCOMPARE(crawler.files(QStringList(m_root)).size(), allFiles().size() + 1);
+}
+
+QTEST_MAIN(tst_DirectoryCrawler)
+#include "tst_directorycrawler.moc"
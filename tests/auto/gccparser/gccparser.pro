@@ -0,0 +1,14 @@
+load(qttest_p4)
+QT += xml
+
+INCLUDEPATH += ../../../src/plugins \
+    ../../../src/libs
+
+DEFINES += PROJECTEXPLORER_LIBRARY
+
+SOURCES += tst_gccparser.cpp \
+    ../../../src/plugins/qt4projectmanager/gccparser.cpp \
+    ../../../src/plugins/projectexplorer/buildparserinterface.cpp
+
+HEADERS += ../../../src/plugins/qt4projectmanager/gccparser.h \
+    ../../../src/plugins/projectexplorer/buildparserinterface.h
@@ -0,0 +1,227 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+#include <qt4projectmanager/gccparser.h>
+
+#include <QtTest/QtTest>
+
+using namespace Qt4ProjectManager;
+using ProjectExplorer::BuildParserInterface;
+
+class tst_GccParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void stdError_data();
+    void stdError();
+    void linkerErrors();
+    void stdOutput_data();
+    void stdOutput();
+
+private:
+    QStringList tasks() const;
+
+    GccParser *m_parser;
+    QSignalSpy *m_taskSpy;
+};
+
+void tst_GccParser::init()
+{
+    m_parser = new GccParser;
+    m_taskSpy = new QSignalSpy(m_parser, SIGNAL(addToTaskWindow(QString,int,int,QString)));
+}
+
+void tst_GccParser::cleanup()
+{
+    delete m_taskSpy;
+    delete m_parser;
+}
+
+static QString task(const QString &file, int type, int line, const QString &description)
+{
+    return QString::fromLatin1("%1|%2|%3|%4").arg(file).arg(type).arg(line).arg(description);
+}
+
+// Returns the tasks added so far, formatted by task().
+QStringList tst_GccParser::tasks() const
+{
+    QStringList tasks;
+    foreach (const QList<QVariant> &arguments, *m_taskSpy) {
+        tasks.append(task(arguments.at(0).toString(), arguments.at(1).toInt(),
+                          arguments.at(2).toInt(), arguments.at(3).toString()));
+    }
+    return tasks;
+}
+
+void tst_GccParser::stdError_data()
+{
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<QStringList>("tasks");
+
+    QTest::newRow("error")
+            << QString::fromLatin1("main.cpp:12: error: 'foo' was not declared in this scope")
+            << (QStringList() << task(QLatin1String("main.cpp"), BuildParserInterface::Error, 12,
+                                      QLatin1String("'foo' was not declared in this scope")));
+    QTest::newRow("warning with column")
+            << QString::fromLatin1("src/main.cpp:12:5: warning: unused variable 'x'")
+            << (QStringList() << task(QLatin1String("src/main.cpp"), BuildParserInterface::Warning, 12,
+                                      QLatin1String("unused variable 'x'")));
+    QTest::newRow("untyped message")
+            << QString::fromLatin1("main.cpp:3: note: candidates are: void f()")
+            << (QStringList() << task(QLatin1String("main.cpp"), BuildParserInterface::Unknown, 3,
+                                      QLatin1String("note: candidates are: void f()")));
+    QTest::newRow("indented")
+            << QString::fromLatin1("  main.cpp:12: error: expected ';'\r\n")
+            << (QStringList() << task(QLatin1String("main.cpp"), BuildParserInterface::Error, 12,
+                                      QLatin1String("expected ';'")));
+    QTest::newRow("drive letter")
+            << QString::fromLatin1("C:/Qt/src/main.cpp:42: error: expected ';' before '}' token")
+            << (QStringList() << task(QLatin1String("C:/Qt/src/main.cpp"), BuildParserInterface::Error, 42,
+                                      QLatin1String("expected ';' before '}' token")));
+    QTest::newRow("drive letter and column")
+            << QString::fromLatin1("C:\\Qt\\4.5\\src\\main.cpp:7:3: warning: comparison between signed and unsigned")
+            << (QStringList() << task(QLatin1String("C:\\Qt\\4.5\\src\\main.cpp"), BuildParserInterface::Warning, 7,
+                                      QLatin1String("comparison between signed and unsigned")));
+
+    const QString includedFrom = QLatin1String("In file included from /usr/include/qt4/QtCore/qobject.h:47,");
+    QTest::newRow("included from")
+            << includedFrom
+            << (QStringList() << task(QLatin1String("/usr/include/qt4/QtCore/qobject.h"),
+                                      BuildParserInterface::Unknown, 47, includedFrom));
+    QTest::newRow("included from, continued")
+            << QString::fromLatin1("                 from main.cpp:1:")
+            << (QStringList() << task(QLatin1String("main.cpp"), BuildParserInterface::Unknown, 1,
+                                      QLatin1String("from main.cpp:1:")));
+    const QString includedFromDrive = QLatin1String("In file included from C:/Qt/include/QtCore/qobject.h:47,");
+    QTest::newRow("included from, drive letter")
+            << includedFromDrive
+            << (QStringList() << task(QLatin1String("C:/Qt/include/QtCore/qobject.h"),
+                                      BuildParserInterface::Unknown, 47, includedFromDrive));
+
+    QTest::newRow("collect2")
+            << QString::fromLatin1("collect2: ld returned 1 exit status")
+            << (QStringList() << task(QString(), BuildParserInterface::Error, -1,
+                                      QLatin1String("collect2: ld returned 1 exit status")));
+
+    QTest::newRow("function context")
+            << QString::fromLatin1("main.cpp: In function 'int main()':")
+            << QStringList();
+    QTest::newRow("command line")
+            << QString::fromLatin1("g++ -c -O2 -Wall -I/usr/include/qt4 -o main.o main.cpp")
+            << QStringList();
+}
+
+void tst_GccParser::stdError()
+{
+    QFETCH(QString, line);
+    QFETCH(QStringList, tasks);
+
+    m_parser->stdError(line);
+    QCOMPARE(this->tasks(), tasks);
+}
+
+void tst_GccParser::linkerErrors()
+{
+    m_parser->stdError(QLatin1String("main.o(.text+0x1c): In function `main':"));
+    m_parser->stdError(QLatin1String("main.cpp:5: undefined reference to `foo()'"));
+    m_parser->stdError(QLatin1String("collect2: ld returned 1 exit status"));
+    m_parser->stdError(QLatin1String("main.cpp:7: error: no more linking"));
+
+    QStringList expected;
+    expected << task(QLatin1String("main.o"), BuildParserInterface::Error, -1,
+                     QLatin1String("In function `main':"))
+             << task(QLatin1String("main.cpp"), BuildParserInterface::Unknown, 5,
+                     QLatin1String("-> undefined reference to `foo()'"))
+             << task(QString(), BuildParserInterface::Error, -1,
+                     QLatin1String("collect2: ld returned 1 exit status"))
+             << task(QLatin1String("main.cpp"), BuildParserInterface::Error, 7,
+                     QLatin1String("no more linking"));
+    QCOMPARE(tasks(), expected);
+}
+
+void tst_GccParser::stdOutput_data()
+{
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<QString>("entered");
+    QTest::addColumn<QString>("left");
+
+    QTest::newRow("entering")
+            << QString::fromLatin1("make[1]: Entering directory `/home/user/project/src'")
+            << QString::fromLatin1("/home/user/project/src")
+            << QString();
+    QTest::newRow("leaving")
+            << QString::fromLatin1("make[1]: Leaving directory `/home/user/project/src'")
+            << QString()
+            << QString::fromLatin1("/home/user/project/src");
+    QTest::newRow("drive letter")
+            << QString::fromLatin1("make[2]: Entering directory `C:/project/src/plugins'")
+            << QString::fromLatin1("C:/project/src/plugins")
+            << QString();
+    QTest::newRow("top level")
+            << QString::fromLatin1("make: Entering directory `/home/user/project'")
+            << QString::fromLatin1("/home/user/project")
+            << QString();
+    QTest::newRow("other make output")
+            << QString::fromLatin1("make: Nothing to be done for `first'.")
+            << QString()
+            << QString();
+    QTest::newRow("compiler output")
+            << QString::fromLatin1("main.cpp:12: error: 'foo' was not declared in this scope")
+            << QString()
+            << QString();
+}
+
+void tst_GccParser::stdOutput()
+{
+    QFETCH(QString, line);
+    QFETCH(QString, entered);
+    QFETCH(QString, left);
+
+    QSignalSpy enterSpy(m_parser, SIGNAL(enterDirectory(QString)));
+    QSignalSpy leaveSpy(m_parser, SIGNAL(leaveDirectory(QString)));
+    m_parser->stdOutput(line);
+
+    QCOMPARE(enterSpy.count(), entered.isEmpty() ? 0 : 1);
+    if (!entered.isEmpty())
+        QCOMPARE(enterSpy.first().first().toString(), entered);
+    QCOMPARE(leaveSpy.count(), left.isEmpty() ? 0 : 1);
+    if (!left.isEmpty())
+        QCOMPARE(leaveSpy.first().first().toString(), left);
+    QCOMPARE(m_taskSpy->count(), 0);
+}
+
+QTEST_MAIN(tst_GccParser)
+#include "tst_gccparser.moc"
@@ -0,0 +1,15 @@
+QT = core
+macx:CONFIG -= app_bundle
+TARGET = gdbmi
+
+DEBUGGERHOME = ../../../src/plugins/debugger
+
+DEFINES += SRCDIR=\\\"$$PWD\\\"
+INCLUDEPATH += $$DEBUGGERHOME ../../../src/libs
+
+SOURCES += \
+    main.cpp \
+    $$DEBUGGERHOME/gdbmi.cpp
+
+HEADERS += \
+    $$DEBUGGERHOME/gdbmi.h
@@ -0,0 +1,142 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+// Replays recorded gdb transcripts through the GDB/MI parser and reports
+// how fast they are parsed, with and without looking at the parsed data.
+
+#include "gdbmi.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTime>
+
+#include <cstdio>
+
+using namespace Debugger::Internal;
+
+static int dataSize = 0;
+
+static int walk(const GdbMi &mi, bool touchData)
+{
+    int count = 1;
+    if (touchData)
+        dataSize += mi.name().size() + mi.data().size();
+    for (int i = 0; i < mi.childCount(); ++i)
+        count += walk(mi.childAt(i), touchData);
+    return count;
+}
+
+// Parses the records of a transcript the way GdbEngine::handleResponse() does,
+// returns the number of nodes.
+static int replay(const QByteArray &transcript, bool touchData)
+{
+    int nodes = 0;
+    const char *from = transcript.constData();
+    const char *to = from + transcript.size();
+    while (from != to) {
+        const char *lineEnd = from;
+        while (lineEnd != to && *lineEnd != '\n')
+            ++lineEnd;
+
+        while (from != lineEnd && *from >= '0' && *from <= '9')
+            ++from; // token
+        if (from != lineEnd) {
+            const char c = *from++;
+            switch (c) {
+            case '^':
+            case '*':
+            case '+':
+            case '=': {
+                while (from != lineEnd && *from != ',')
+                    ++from; // result or async class
+                if (from != lineEnd) {
+                    ++from;
+                    GdbMi record;
+                    record.fromResults(from, lineEnd, "data");
+                    nodes += walk(record, touchData);
+                }
+                break;
+            }
+            case '~':
+            case '@':
+            case '&':
+                GdbMi::parseCString(from, lineEnd);
+                ++nodes;
+                break;
+            default:
+                break; // "(gdb)" or application output
+            }
+        }
+        from = lineEnd == to ? to : lineEnd + 1;
+    }
+    return nodes;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    args.removeFirst();
+    int iterations = 1000;
+    if (!args.isEmpty() && args.first().toInt() > 0)
+        iterations = args.takeFirst().toInt();
+    if (args.isEmpty())
+        args.append(QLatin1String(SRCDIR "/data/stack.txt"));
+
+    foreach (const QString &fileName, args) {
+        QFile file(fileName);
+        if (!file.open(QFile::ReadOnly)) {
+            fprintf(stderr, "Cannot open %s\n", qPrintable(fileName));
+            return 1;
+        }
+        const QByteArray transcript = file.readAll();
+
+        for (int touchData = 0; touchData < 2; ++touchData) {
+            QTime timer;
+            timer.start();
+            int nodes = 0;
+            for (int i = 0; i < iterations; ++i)
+                nodes += replay(transcript, touchData);
+            const int elapsed = qMax(1, timer.elapsed());
+
+            printf("%s%s: %d nodes per replay, %.1f MB/s, %.2f ms per replay\n",
+                   qPrintable(fileName), touchData ? " (reading data)" : "",
+                   nodes / iterations,
+                   double(transcript.size()) * iterations / 1024 / 1024 / elapsed * 1000,
+                   double(elapsed) / iterations);
+        }
+    }
+    return 0;
+}
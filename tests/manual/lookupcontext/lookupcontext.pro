@@ -0,0 +1,26 @@
+QT = core
+macx:CONFIG -= app_bundle
+TARGET = lookupcontext
+
+CPLUSPLUSHOME = ../../../src/libs/cplusplus
+
+DEFINES += HAVE_QT CPLUSPLUS_WITH_NAMESPACE CPLUSPLUS_BUILD_LIB
+INCLUDEPATH += ../../../src/libs
+
+include(../../../shared/cplusplus/cplusplus.pri)
+
+SOURCES += \
+    main.cpp \
+    $$CPLUSPLUSHOME/CppDocument.cpp \
+    $$CPLUSPLUSHOME/LookupContext.cpp \
+    $$CPLUSPLUSHOME/ResolveExpression.cpp \
+    $$CPLUSPLUSHOME/TypeOfExpression.cpp \
+    $$CPLUSPLUSHOME/Overview.cpp \
+    $$CPLUSPLUSHOME/NamePrettyPrinter.cpp \
+    $$CPLUSPLUSHOME/TypePrettyPrinter.cpp \
+    $$CPLUSPLUSHOME/Macro.cpp \
+    $$CPLUSPLUSHOME/PreprocessorClient.cpp \
+    $$CPLUSPLUSHOME/PreprocessorEnvironment.cpp \
+    $$CPLUSPLUSHOME/pp-engine.cpp \
+    $$CPLUSPLUSHOME/pp-macro-expander.cpp \
+    $$CPLUSPLUSHOME/pp-scanner.cpp
@@ -0,0 +1,280 @@
+/***************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2008 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact:  Qt Software Information (qt-info@nokia.com)
+**
+**
+** Non-Open Source Usage
+**
+** Licensees may use this file in accordance with the Qt Beta Version
+** License Agreement, Agreement version 2.2 provided with the Software or,
+** alternatively, in accordance with the terms contained in a written
+** agreement between you and Nokia.
+**
+** GNU General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License versions 2.0 or 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the packaging
+** of this file.  Please review the following information to ensure GNU
+** General Public Licensing requirements will be met:
+**
+** http://www.fsf.org/licensing/licenses/info/GPLv2.html and
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt GPL Exception
+** version 1.3, included in the file GPL_EXCEPTION.txt in this package.
+**
+***************************************************************************/
+
+// Builds a Qt-sized snapshot of generated headers and resolves many
+// expressions against it, the way completion and follow symbol do,
+// to measure how expensive the lookup contexts are.
+
+#include <cplusplus/CppDocument.h>
+#include <cplusplus/LookupContext.h>
+#include <cplusplus/TypeOfExpression.h>
+
+#include <CoreTypes.h>
+#include <Scope.h>
+#include <Symbols.h>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+#include <QtCore/QTime>
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace CPlusPlus;
+
+static QString headerName(int index)
+{
+    return QString::fromLatin1("/generated/header%1.h").arg(index);
+}
+
+// Every header declares a class in its own namespace, derived from the class
+// of the previous header, so that the classes form hierarchies ten deep.
+static Document::Ptr createHeader(int index)
+{
+    QByteArray source;
+    source += "namespace ns" + QByteArray::number(index) + " {\n";
+    source += "class Base" + QByteArray::number(index);
+    if (index % 10)
+        source += ": public ns" + QByteArray::number(index - 1)
+                + "::Base" + QByteArray::number(index - 1);
+    source += "\n{\npublic:\n";
+    source += "    int member" + QByteArray::number(index) + "() const;\n";
+    source += "    Base" + QByteArray::number(index) + " *next"
+            + QByteArray::number(index) + ";\n";
+    source += "};\n}\n";
+    source += "using namespace ns" + QByteArray::number(index) + ";\n";
+
+    Document::Ptr doc = Document::create(headerName(index));
+    if (index)
+        doc->addIncludeFile(headerName(index - 1), 1);
+    doc->setSource(source);
+    doc->parse();
+    doc->check();
+    return doc;
+}
+
+static Snapshot createSnapshot(int headerCount, Document::Ptr *mainDocument)
+{
+    Snapshot snapshot;
+    for (int i = 0; i < headerCount; ++i) {
+        Document::Ptr doc = createHeader(i);
+        snapshot.insert(doc->fileName(), doc);
+    }
+
+    const QByteArray last = QByteArray::number(headerCount - 1);
+    const QByteArray source = "Base" + last + " *object;\n"
+                              "int main() { return 0; }\n";
+
+    Document::Ptr doc = Document::create(QLatin1String("/generated/main.cpp"));
+    doc->addIncludeFile(headerName(headerCount - 1), 1);
+    doc->setSource(source);
+    doc->parse();
+    doc->check();
+    snapshot.insert(doc->fileName(), doc);
+    *mainDocument = doc;
+    return snapshot;
+}
+
+static QStringList createExpressions(int headerCount, int count)
+{
+    QStringList expressions;
+    const int last = headerCount - 1;
+    for (int i = 0; i < count; ++i) {
+        const int inherited = last - (i % 10);
+        const int other = (i * 7919) % headerCount;
+        switch (i % 3) {
+        case 0:
+            expressions.append(QString::fromLatin1("object->member%1()").arg(inherited));
+            break;
+        case 1:
+            expressions.append(QString::fromLatin1("object->next%1->next%1->member%2()")
+                               .arg(last).arg(inherited));
+            break;
+        default:
+            expressions.append(QString::fromLatin1("ns%1::Base%1::member%1").arg(other));
+            break;
+        }
+    }
+    return expressions;
+}
+
+class Resolver: public QThread
+{
+public:
+    Resolver(const Snapshot &snapshot, Document::Ptr doc, const QStringList &expressions)
+        : _snapshot(snapshot), _doc(doc), _expressions(expressions), _resolved(0)
+    { }
+
+    int resolved() const
+    { return _resolved; }
+
+protected:
+    virtual void run()
+    {
+        TypeOfExpression typeOfExpression;
+        typeOfExpression.setSnapshot(_snapshot);
+        Symbol *lastVisibleSymbol = _doc->globalSymbolAt(_doc->globalSymbolCount() - 1);
+        foreach (const QString &expression, _expressions) {
+            if (! typeOfExpression(expression, _doc, lastVisibleSymbol).isEmpty())
+                ++_resolved;
+        }
+    }
+
+private:
+    Snapshot _snapshot;
+    Document::Ptr _doc;
+    QStringList _expressions;
+    int _resolved;
+};
+
+static int resolve(const Snapshot &snapshot, Document::Ptr doc,
+                   const QStringList &expressions, int threadCount)
+{
+    QList<Resolver *> resolvers;
+    for (int i = 0; i < threadCount; ++i)
+        resolvers.append(new Resolver(snapshot, doc, expressions));
+    foreach (Resolver *resolver, resolvers)
+        resolver->start();
+
+    int resolved = 0;
+    foreach (Resolver *resolver, resolvers) {
+        resolver->wait();
+        resolved += resolver->resolved();
+    }
+    qDeleteAll(resolvers);
+    return resolved;
+}
+
+// Completes "ns<n>::" and "ns<n>::Base<n>::" the way the code completion
+// does and returns the time the slowest of them took, in milliseconds.
+static int complete(const Snapshot &snapshot, Document::Ptr doc, int headerCount,
+                    int count, int *itemCount)
+{
+    TypeOfExpression typeOfExpression;
+    typeOfExpression.setSnapshot(snapshot);
+    Symbol *lastVisibleSymbol = doc->globalSymbolAt(doc->globalSymbolCount() - 1);
+
+    int slowest = 0;
+    QTime timer;
+    for (int i = 0; i < count; ++i) {
+        timer.start();
+
+        const int index = (i * 7919) % headerCount;
+        const QString expression = (i % 2)
+                ? QString::fromLatin1("ns%1::Base%1").arg(index)
+                : QString::fromLatin1("ns%1").arg(index);
+
+        const QList<TypeOfExpression::Result> results =
+                typeOfExpression(expression, doc, lastVisibleSymbol);
+        const LookupContext &context = typeOfExpression.lookupContext();
+        foreach (const TypeOfExpression::Result &result, results) {
+            Scope *members = 0;
+            if (Namespace *ns = result.first->asNamespace())
+                members = ns->members();
+            else if (Class *klass = result.first->asClass())
+                members = klass->members();
+            if (! members)
+                continue;
+            foreach (Scope *scope, context.expand(members))
+                *itemCount += scope->symbolCount();
+        }
+
+        slowest = qMax(slowest, timer.elapsed());
+    }
+    return slowest;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    const QString appName = args.first();
+    args.removeFirst();
+
+    int headerCount = 600;
+    int expressionCount = 3000;
+    int threadCount = 1;
+
+    while (! args.isEmpty()) {
+        const QString arg = args.takeFirst();
+        if (arg == QLatin1String("--headers") && ! args.isEmpty())
+            headerCount = qMax(1, args.takeFirst().toInt());
+        else if (arg == QLatin1String("--expressions") && ! args.isEmpty())
+            expressionCount = qMax(1, args.takeFirst().toInt());
+        else if (arg == QLatin1String("--threads") && ! args.isEmpty())
+            threadCount = qMax(1, args.takeFirst().toInt());
+        else {
+            const QFileInfo appInfo(appName);
+            const QByteArray appFileName = QFile::encodeName(appInfo.fileName());
+
+            printf("Usage: %s [options]\n"
+                   "  --help                    Display this information\n"
+                   "  --headers <count>         Number of generated headers (%d)\n"
+                   "  --expressions <count>     Number of resolved expressions (%d)\n"
+                   "  --threads <count>         Number of threads resolving them (%d)\n",
+                   appFileName.constData(), headerCount, expressionCount, threadCount);
+            return arg == QLatin1String("--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    QTime timer;
+    timer.start();
+    Document::Ptr doc;
+    const Snapshot snapshot = createSnapshot(headerCount, &doc);
+    printf("%d documents parsed in %d ms\n", snapshot.size(), timer.elapsed());
+
+    const QStringList expressions = createExpressions(headerCount, expressionCount);
+    for (int round = 1; round <= 2; ++round) {
+        timer.restart();
+        const int resolved = resolve(snapshot, doc, expressions, threadCount);
+        const int elapsed = timer.elapsed();
+        printf("round %d: %d of %d expressions resolved in %d ms (%.3f ms each)\n",
+               round, resolved, expressionCount * threadCount, elapsed,
+               double(elapsed) / (expressionCount * threadCount));
+    }
+
+    // Completion should stay below 20 ms, the first request included.
+    for (int round = 1; round <= 2; ++round) {
+        int itemCount = 0;
+        timer.restart();
+        const int slowest = complete(snapshot, doc, headerCount, expressionCount, &itemCount);
+        printf("round %d: %d completions with %d items in %d ms (slowest %d ms)\n",
+               round, expressionCount, itemCount, timer.elapsed(), slowest);
+    }
+
+    return EXIT_SUCCESS;
+}